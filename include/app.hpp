@@ -5,7 +5,14 @@
 #ifndef CELLSIM_APP_HPP
 #define CELLSIM_APP_HPP
 
+#include <array>
+#include <cstdint>
+
 #include <cli_emulator/cellsim_cli_emulator.hpp>
+#include <cpu/hash_life.hpp>
+#include <cpu/thread_pool.hpp>
+#include <profiler/gpu_profiler.hpp>
+#include <profiler/trace_recorder.hpp>
 #include <renderer/renderer.hpp>
 #include <rules/rule.hpp>
 #include <rules/rule_config.hpp>
@@ -14,6 +21,19 @@
 
 namespace CSIM {
 
+enum class SimulationBackend { GPU, CPU, HASH_LIFE };
+
+/**
+ * FRAME_COUNTER steps once every step_size_ frames, TARGET_RATE steps as often as needed to reach
+ * the requested generations per second, MAX_THROUGHPUT fills the per frame time budget with steps
+ */
+enum class SpeedMode { FRAME_COUNTER, TARGET_RATE, MAX_THROUGHPUT };
+
+struct StepBatch {
+	std::uint64_t frame{0};
+	std::int32_t steps{0};
+};
+
 struct App {
 	Window &window_;
 
@@ -22,22 +42,54 @@ struct App {
 	Renderer renderer_{
 			{std::get<0>(window_.getWindowSize()), std::get<1>(window_.getWindowSize())},
 			std::make_shared<VFShader>("shaders/bin/render_shader/vert.spv", "shaders/bin/render_shader/frag.spv"),
-			std::make_shared<VFShader>("shaders/bin/grid_shader/vert.spv", "shaders/bin/grid_shader/frag.spv")};
+			std::make_shared<VFShader>("shaders/bin/screen_shader/vert.spv", "shaders/bin/grid_shader/frag.spv"),
+			std::make_shared<VFShader>("shaders/bin/screen_shader/vert.spv", "shaders/bin/screen_shader/frag.spv"),
+			std::make_shared<CShader>("shaders/bin/lod_pyramid/comp.spv")};
+	TraceRecorder trace_{}; /*!< outlives cell_map_ whose png encoding it may still record */
 	CellMap cell_map_{64, 64}; // NOLINT
+	GPUProfiler profiler_{};
 	AppCLIEmulator cli_emulator_{"cellsim cli", "cellular automata cli based simulation app",
 															 "cellsim"};
 	std::shared_ptr<Rule> rule_{nullptr};
 	std::shared_ptr<RuleConfig> rule_config_{nullptr};
+	RuleType rule_config_rule_type_{RuleType::BASIC_2D}; /*!< rule type requested for the config */
+	std::shared_ptr<ThreadPool> thread_pool_{std::make_shared<ThreadPool>()};
+	SimulationBackend backend_{SimulationBackend::GPU};
+	std::size_t hash_life_memory_budget_{HashLife::DEFAULT_MEMORY_BUDGET};
+	bool active_tiles_{false};	/*!< 2D rules recompute only tiles which changed or border on one */
+	bool shared_tiles_{false};	/*!< 2D rules on the gpu stage tiles in shared memory */
+
+	std::int32_t temporal_block_{1}; /*!< generations advanced by every step of 2D rules */
 
 	std::int32_t step_size_{30}; // NOLINT
 	std::int32_t frame_counter_{0};
 	float last_frame_time_{0.f};
+
+	SpeedMode speed_mode_{SpeedMode::FRAME_COUNTER};
+	float target_gens_per_second_{60.f};	/*!< generations per second in TARGET_RATE mode */
+	float step_budget_{.012f};						/*!< seconds per frame which steps may take */
+	float seconds_per_step_{0.f};					/*!< moving average of the measured step time */
+	float generations_per_step_{1.f};			/*!< generations advanced by the last measured step */
+	float generation_debt_{0.f};					/*!< generations owed to the target rate */
+	std::int32_t readout_generations_{0}; /*!< generations since the readout was updated */
+	float readout_elapsed_{0.f};
+	float gens_per_second_{0.f}; /*!< achieved generations per second */
+	/// steps run by the batch of a frame, index frame % HISTORY_SIZE, measured once the frame's
+	/// STEP query is collected
+	std::array<StepBatch, GPUProfiler::HISTORY_SIZE> step_batches_{};
+	std::uint64_t measured_frame_{0}; /*!< oldest frame whose batch isn't measured yet */
 	bool simulation_stopped_{false};
 	bool is_viewport_win_focused_{false};
 
 	explicit App(Window &window);
 
 	void updateRuleConfig(std::shared_ptr<RuleConfig> config, RuleType rule_type);
+	void recreateRule();
+	/**
+	 * Runs steps of the current rule due this frame according to the speed mode
+	 * @param time_step seconds since the previous frame
+	 */
+	void stepSimulation(float time_step);
 	void parseCommand();
 	void run();
 
@@ -6,6 +6,7 @@
 #define CELLSIM_CELLMAP_HPP
 
 #include "texture_backed_framebuffer.hpp"
+#include "utils/cell_state.hpp"
 #include "utils/vecs.hpp"
 #include <shaders/shaders.hpp>
 
@@ -17,17 +18,20 @@ namespace CSIM {
 
 using namespace utils;
 
+struct TraceRecorder;
+
 struct CellMap {
-	static constexpr std::int32_t INITIAL_LIFE_STATE{1};
+	static constexpr CellState INITIAL_LIFE_STATE{1};
 
-	std::uint32_t instance_offsets_ssbo_id_{0};
-	std::uint32_t state_map_ssbo_id_{0};
+	std::uint32_t state_map_ssbo_id_{0};			/*!< current generation, read by the renderer */
+	std::uint32_t back_state_map_ssbo_id_{0}; /*!< written by rules which ping-pong the state map */
 
 	std::size_t width_;
 	std::size_t height_;
 	TextureBackedFramebuffer fbo_;
-	std::vector<Vec2<float>> cell_offsets_;
-	std::vector<std::int32_t> cell_states_;
+	std::vector<CellState> cell_states_;
+	std::uint64_t states_version_{0}; /*!< incremented when states are modified outside of rules */
+	TraceRecorder *trace_{nullptr};		/*!< if set png readback and encoding are recorded */
 
 	CellMap(std::size_t width, std::size_t height);
 
@@ -35,21 +39,52 @@ struct CellMap {
 		return {static_cast<std::int32_t>(width_), static_cast<std::int32_t>(height_)};
 	}
 
+	/**
+	 * @return size of the state map ssbo in bytes, states are packed four per word so the size is
+	 * rounded up to whole words
+	 */
+	[[nodiscard]] std::size_t stateMapSize() const noexcept {
+		return (width_ * height_ * sizeof(CellState) + 3) & ~static_cast<std::size_t>(3);
+	}
+
 	void seed(std::size_t x, std::size_t y, std::size_t range, bool round, bool clip) noexcept;
 	void extend(std::size_t new_width, std::size_t new_height, bool preserve_contents);
 	void clear();
 
+	/**
+	 * copies state map ssbo contents into cell_states_
+	 */
+	void downloadStates() noexcept;
+	/**
+	 * copies cell_states_ into state map ssbo
+	 */
+	void uploadStates() noexcept;
+
+	/**
+	 * @return version of the states, rules which track activity between steps restart tracking
+	 * when it changes
+	 */
+	[[nodiscard]] auto statesVersion() const noexcept {
+		return states_version_;
+	}
+
 	[[nodiscard]] const auto &textureFbo() const {
 		return fbo_;
 	}
 	[[nodiscard]] auto stateMapSsboId() const {
 		return state_map_ssbo_id_;
 	}
+	[[nodiscard]] auto backStateMapSsboId() const {
+		return back_state_map_ssbo_id_;
+	}
+	/**
+	 * swaps roles of the state map ssbos, back buffer becomes the state map (binding 2) which the
+	 * next step writes, previous state map becomes the copy (binding 6) which it reads
+	 */
+	void swapStateMaps() noexcept;
 
 	bool saveTextureToFile(const std::filesystem::path& ) const noexcept;
 
-	void generateOffsets() noexcept;
-
 	void destroy() noexcept;
 };
 
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include <cli_emulator/cli_emulator.hpp>
+#include <cli_emulator/rule_cli.hpp>
 
 namespace CSIM {
 
@@ -43,42 +44,36 @@ struct AppCLIEmulator : public CLIEmulator {
 		std::vector<std::uint32_t> option_colors;
 		/// subcommand
 		CLI::App *subcmd_rule;
-		/// subsubcommand
-		CLI::App *subsubcmd_rule_1dtotalistic;
-		/// options
-		struct {
-			std::uint32_t range;
-			CLI::Option *exclude_center;
-			std::vector<std::size_t> survival_conditions;
-			std::vector<std::size_t> birth_conditions;
-		} options_1d_totalistic;
-		/// subsubcommand
-		CLI::App *subsubcmd_rule_1dbinary;
+		/// subsubcommands and options
+		RuleCLIOptions options_rule;
+		/// subcommand
+		CLI::App *subcmd_backend;
 		/// options
 		struct {
-			std::uint32_t range;
-			std::string pattern_match_code;
-		} options_1d_binary;
-		/// subsubcommand
-		CLI::App *subsubcmd_rule_2dcyclic;
+			std::string backend{"gpu"};
+			CLI::Option *threads_option;
+			std::uint32_t threads{0};
+			CLI::Option *memory_option;
+			std::size_t memory{0}; /*!< hashlife node cache budget in MiB */
+			CLI::Option *active_tiles;
+			CLI::Option *shared_tiles;
+			CLI::Option *temporal_block_option;
+			std::int32_t temporal_block{1}; /*!< generations advanced by every step */
+		} options_backend;
+		/// subcommand
+		CLI::App *subcmd_minimap;
 		/// options
-		struct {
-			std::int32_t range;
-			std::int32_t threshold;
-			CLI::Option *moore;
-			CLI::Option *state_insensitive;
-			CLI::Option *exclude_center;
-		} options_2d_cyclic;
-		/// subsubcommand
-		CLI::App *subsubcmd_rule_2dlife;
+		float option_minimap_rate{10.f}; /*!< maximal cellmap texture redraws per second */
+		/// subcommand
+		CLI::App *subcmd_speed;
 		/// options
 		struct {
-			CLI::Option *moore;
-			CLI::Option *state_insensitive;
-			CLI::Option *exclude_center;
-			std::vector<std::size_t> survival_conditions;
-			std::vector<std::size_t> birth_conditions;
-		} options_2d_life;
+			CLI::Option *gens_option;
+			float gens{60.f}; /*!< target generations per second */
+			CLI::Option *max_throughput;
+			CLI::Option *budget_option;
+			float budget{12.f}; /*!< milliseconds per frame which steps may take */
+		} options_speed;
 		/// subcommand
 		CLI::App *subcmd_counter;
 		/// options
@@ -103,6 +98,25 @@ struct AppCLIEmulator : public CLIEmulator {
 		CLI::App *cmd_stop;
 		/// command
 		CLI::App *cmd_start;
+		/// command
+		CLI::App *cmd_jump;
+		/// options
+		struct {
+			CLI::Option *power_option;
+			std::uint32_t power{0};
+			CLI::Option *generations_option;
+			std::uint64_t generations{0};
+		} options_jump;
+		/// command
+		CLI::App *cmd_trace;
+		/// options
+		struct {
+			CLI::Option *frames_option;
+			std::size_t frames{0};
+			CLI::Option *stop;
+			CLI::Option *output_option;
+			std::string output;
+		} options_trace;
 	} config;
 
 	/**
@@ -0,0 +1,74 @@
+#ifndef CELLSIM_RULE_CLI_HPP
+#define CELLSIM_RULE_CLI_HPP
+
+#include <CLI/CLI.hpp>
+#include <rules/rule_config.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CSIM {
+
+/**
+ * Subcommands and options of the rules (1dbinary, 1dtotalistic, 2dcyclic, 2dlife), shared by the
+ * app cli (set rule) and the headless runner so both accept the same rule definitions
+ */
+struct RuleCLIOptions {
+	/// subsubcommand
+	CLI::App *subsubcmd_rule_1dtotalistic;
+	/// options
+	struct {
+		std::uint32_t range;
+		CLI::Option *exclude_center;
+		std::vector<std::size_t> survival_conditions;
+		std::vector<std::size_t> birth_conditions;
+	} options_1d_totalistic;
+	/// subsubcommand
+	CLI::App *subsubcmd_rule_1dbinary;
+	/// options
+	struct {
+		std::uint32_t range;
+		std::string pattern_match_code;
+	} options_1d_binary;
+	/// subsubcommand
+	CLI::App *subsubcmd_rule_2dcyclic;
+	/// options
+	struct {
+		std::int32_t range;
+		std::int32_t threshold;
+		CLI::Option *moore;
+		CLI::Option *state_insensitive;
+		CLI::Option *exclude_center;
+	} options_2d_cyclic;
+	/// subsubcommand
+	CLI::App *subsubcmd_rule_2dlife;
+	/// options
+	struct {
+		CLI::Option *moore;
+		CLI::Option *state_insensitive;
+		CLI::Option *exclude_center;
+		std::vector<std::size_t> survival_conditions;
+		std::vector<std::size_t> birth_conditions;
+	} options_2d_life;
+
+	/**
+	 * adds rule subcommands and their options to the passed command
+	 * @param cmd_rule command under which the rules are selected
+	 */
+	void setCLI(CLI::App *cmd_rule);
+
+	/**
+	 * creates config of the rule subcommand which was parsed
+	 * @param make_shader returns step shader of the passed config type, it may return nullptr if
+	 * the config is run only by cpu engines
+	 * @return rule config or nullptr if none of the rule subcommands was parsed
+	 */
+	[[nodiscard]] std::shared_ptr<RuleConfig> parsedRuleConfig(
+			const std::function<std::shared_ptr<Shader>(RuleConfigType)> &make_shader) const;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_RULE_CLI_HPP
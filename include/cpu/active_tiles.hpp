@@ -0,0 +1,84 @@
+#ifndef CELLSIM_ACTIVE_TILES_HPP
+#define CELLSIM_ACTIVE_TILES_HPP
+
+#include "utils/vecs.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace CSIM {
+
+using namespace utils;
+
+/**
+ * Tracks activity of a map split into fixed size tiles. Engine recomputes only active tiles, i.e.
+ * tiles which changed in the last generation or are within kernel reach of a changed tile, every
+ * other tile is quiescent: its neighbourhood didn't change so its next generation equals the
+ * current one. Engines write into back buffer which holds the previous generation, so skipped
+ * tiles don't even have to be copied
+ */
+struct ActiveTiles {
+private:
+	Vec2<std::int32_t> tile_size_;
+	Vec2<std::int32_t> reach_; /*!< max |offset| of the kernel in both axes */
+
+	Vec2<std::int32_t> resolution_{0, 0};
+	Vec2<std::int32_t> tile_count_{0, 0};
+	Vec2<std::int32_t> tile_reach_{0, 0};
+
+	std::vector<std::uint8_t> changed_; /*!< tiles which changed in the last generation */
+	std::vector<std::uint8_t> active_;	/*!< scratch flags used to deduplicate the active list */
+	std::vector<std::uint32_t> active_tiles_;
+	bool all_active_{true};
+
+public:
+	/**
+	 * @param tile_size tile extents in map units (cells or packed words)
+	 * @param reach kernel reach in map units
+	 */
+	ActiveTiles(Vec2<std::int32_t> tile_size, Vec2<std::int32_t> reach) noexcept;
+
+	/**
+	 * @return reach of the kernel in tiles, last tile of an axis can be partial, then tiles on the
+	 * other side of the wrap around are one tile further
+	 */
+	[[nodiscard]] static Vec2<std::int32_t> tileReach(Vec2<std::int32_t> resolution,
+																										Vec2<std::int32_t> tile_size,
+																										Vec2<std::int32_t> reach) noexcept;
+
+	/**
+	 * function builds list of tiles which have to be recomputed in the next generation and resets
+	 * changed flags
+	 * @param resolution map resolution, if it changed tracking starts over
+	 * @return true if all tiles are active because tracking (re)started
+	 */
+	bool update(Vec2<std::int32_t> resolution);
+	/**
+	 * function makes every tile active in the next update, has to be called whenever map was
+	 * modified outside of the engine
+	 */
+	void invalidate() noexcept {
+		all_active_ = true;
+	}
+	/**
+	 * marks tile as changed in the generation being computed, tiles may be marked concurrently
+	 */
+	void markChanged(std::uint32_t tile) noexcept {
+		changed_[tile] = 1; // NOLINT
+	}
+
+	[[nodiscard]] const auto &activeTiles() const noexcept {
+		return active_tiles_;
+	}
+	[[nodiscard]] auto tileCount() const noexcept {
+		return tile_count_;
+	}
+	/**
+	 * @return map coordinates covered by the tile, x, y inclusive begin and z, w exclusive end
+	 */
+	[[nodiscard]] Vec4<std::int32_t> tileBounds(std::uint32_t tile) const noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_ACTIVE_TILES_HPP
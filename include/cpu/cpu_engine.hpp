@@ -0,0 +1,70 @@
+#ifndef CELLSIM_CPU_ENGINE_HPP
+#define CELLSIM_CPU_ENGINE_HPP
+
+#include "utils/cell_state.hpp"
+#include "utils/vecs.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace CSIM {
+
+using namespace utils;
+
+struct RuleConfig;
+struct ThreadPool;
+
+/**
+ * Interface class for CPU implementations of rule algorithms. Engine works on a host copy of the
+ * state map and doesn't use OpenGL at all, so it can be driven with or without GL context.
+ * Result of a step has to be identical to the result of corresponding compute shader
+ */
+struct CPUEngine { // NOLINT no need for move constructor/assignment
+	/**
+	 * function advances the state map by one step of the rule algorithm
+	 * @param states row major state map, after the call contains next generation
+	 * @param resolution resolution of the state map
+	 * @param state_count current number of cell states
+	 * @param iteration current iteration of the rule
+	 */
+	virtual void step(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+										std::int32_t state_count, std::int32_t iteration) = 0;
+	/**
+	 * function advances the state map by multiple steps, engines which keep their own state
+	 * representation override it to convert the state map only once per call
+	 * @param generations number of steps to perform
+	 */
+	virtual void run(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+									 std::int32_t state_count, std::int32_t iteration, std::int32_t generations) {
+		for (std::int32_t generation = 0; generation < generations; ++generation) {
+			step(states, resolution, state_count, iteration + generation);
+		}
+	}
+
+	/**
+	 * function tells the engine that the state map was modified outside of step/run calls, engines
+	 * which track activity between steps recompute the whole map in the next step
+	 */
+	virtual void invalidate() noexcept {
+	}
+
+	virtual ~CPUEngine() = default;
+};
+
+/**
+ * Creates the fastest engine able to run passed rule config with given number of states
+ * @param rule_config rule config to run
+ * @param state_count current number of cell states
+ * @param thread_pool pool on which the engine runs
+ * @param active_tiles if set engines which support it recompute only tiles of the map which
+ * changed or border on a changed tile in the last step (see ActiveTiles)
+ * @return engine or nullptr if there is no cpu engine for the rule config
+ */
+std::unique_ptr<CPUEngine> makeCPUEngine(const RuleConfig &rule_config, std::int32_t state_count,
+																				 std::shared_ptr<ThreadPool> thread_pool,
+																				 bool active_tiles = false);
+
+} // namespace CSIM
+
+#endif // CELLSIM_CPU_ENGINE_HPP
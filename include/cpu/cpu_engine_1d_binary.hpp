@@ -0,0 +1,113 @@
+#ifndef CELLSIM_CPU_ENGINE_1D_BINARY_HPP
+#define CELLSIM_CPU_ENGINE_1D_BINARY_HPP
+
+#include "cpu_engine.hpp"
+#include "thread_pool.hpp"
+#include <rules/rule_config.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace CSIM {
+
+/**
+ * Engine runs 1D binary rule configs on bit packed rows, 64 cells per word. Pattern match code is
+ * compiled once into one of two evaluators working on whole words:
+ * - reduced decision diagram of the pattern bitmask, evaluated as a straight line program of
+ *	 multiplexers over shifted copies of the packed row (short for rules like 30 or 110)
+ * - lookup table which maps window of 8 + 2 * range cells to next states of its 8 center cells,
+ *	 used when the diagram is too large
+ * Like the 1D compute shaders every step computes the row after the row selected by iteration,
+ * within run(...) the computed bit row directly feeds the next step so state map is read only once
+ */
+struct CPUEngine1DBinary : public CPUEngine {
+	static constexpr std::size_t MAX_PATTERN_BITS{2 * RuleConfig1DBinary::RANGE_LIM.y + 1};
+	/**
+	 * diagrams with more nodes than that are slower than the lookup table
+	 */
+	static constexpr std::size_t MAX_EXPRESSION_NODES{16};
+	static constexpr std::size_t BLOCK_WORDS{64}; /*!< words evaluated node by node at once */
+	static constexpr std::size_t WORD_GRAIN{512};					 /*!< words taken at once by a worker */
+	static constexpr std::size_t PARALLEL_MIN_WORDS{4096}; /*!< narrower rows run on one thread */
+
+private:
+	/**
+	 * multiplexer node, value = input ? values[high] : values[low], values 0 and 1 are constant
+	 * zeros and ones, node i writes value i + 2
+	 */
+	struct MuxNode {
+		std::uint16_t input; /*!< index of shifted row word, offset = range - input */
+		std::uint16_t low;
+		std::uint16_t high;
+	};
+
+	std::shared_ptr<ThreadPool> thread_pool_;
+	std::int32_t range_;
+	std::vector<MuxNode> expression_;		 /*!< empty if lookup table is used */
+	std::uint16_t expression_result_{0}; /*!< value index of the whole expression */
+	std::vector<std::uint8_t> lookup_;	 /*!< window of 8 + 2 * range cells -> 8 next cells */
+
+	std::vector<std::uint64_t> read_row_; /*!< packed row with one guard word on both sides */
+	std::vector<std::uint64_t> next_row_;
+
+public:
+	/**
+	 * @param rule_config 1D binary rule config
+	 * @param thread_pool pool on which wide rows are processed
+	 */
+	CPUEngine1DBinary(const RuleConfig &rule_config, std::shared_ptr<ThreadPool> thread_pool);
+
+	/**
+	 * @return true if engine is able to run passed rule config
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config) noexcept;
+
+	void step(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+						std::int32_t state_count, std::int32_t iteration) override;
+	void run(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+					 std::int32_t state_count, std::int32_t iteration, std::int32_t generations) override;
+
+	/**
+	 * @return true if the pattern match code was compiled into an expression instead of a lookup
+	 * table
+	 */
+	[[nodiscard]] bool usesExpression() const noexcept {
+		return lookup_.empty();
+	}
+
+private:
+	/**
+	 * builds reduced decision diagram of patterns [first, first + 2^bit) deciding on pattern bit
+	 * bit - 1 first
+	 * @return value index of the diagram
+	 */
+	std::uint16_t compile(const std::vector<bool> &patterns, std::size_t first, std::uint32_t bit,
+												std::map<std::array<std::uint16_t, 3>, std::uint16_t> &unique);
+
+	void pack(const CellState *row, std::int32_t width);
+	/**
+	 * fills bits past the row end and guard words with wrapped around cells of the row
+	 */
+	static void pad(std::vector<std::uint64_t> &row, std::int32_t width) noexcept;
+	/**
+	 * computes words [begin, end) of the next row into next_row_ and writes their cells into row
+	 */
+	void processWords(CellState *row, std::int32_t width, std::int32_t state_count,
+										std::size_t begin, std::size_t end) noexcept;
+	/**
+	 * computes words [begin, end) of the next row into next_row_, at most BLOCK_WORDS words
+	 */
+	void evaluateWords(std::size_t begin, std::size_t end) noexcept;
+	/**
+	 * @return next states of cells of word cur computed with the lookup table
+	 */
+	[[nodiscard]] std::uint64_t lookupWord(std::uint64_t prev, std::uint64_t cur,
+																				 std::uint64_t next) const noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_CPU_ENGINE_1D_BINARY_HPP
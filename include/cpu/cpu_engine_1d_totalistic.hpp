@@ -0,0 +1,66 @@
+#ifndef CELLSIM_CPU_ENGINE_1D_TOTALISTIC_HPP
+#define CELLSIM_CPU_ENGINE_1D_TOTALISTIC_HPP
+
+#include "cpu_engine.hpp"
+#include "thread_pool.hpp"
+#include <rules/rule_config.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace CSIM {
+
+/**
+ * Engine runs 1D totalistic rule configs with O(1) cost per cell regardless of the range. Read row
+ * extended by range cells on both sides (wrapping around) is turned into a prefix sum table of
+ * alive cells, sum of a cell is then difference of two table entries. Table is built in parallel
+ * bands, sums are computed with SIMD and looked up in the survival/birth tables
+ */
+struct CPUEngine1DTotalistic : public CPUEngine {
+	static constexpr std::size_t CELL_GRAIN{16384};				/*!< cells taken at once by a worker */
+	static constexpr std::size_t PARALLEL_MIN_CELLS{1u << 18}; /*!< narrower rows run on one thread */
+	static constexpr std::size_t BLOCK_CELLS{256};				/*!< sums computed at once */
+
+private:
+	std::shared_ptr<ThreadPool> thread_pool_;
+	std::int32_t range_;
+	bool center_active_;
+	/**
+	 * next alive flag of a cell, index sum * 2 + 1 if the cell is alive in the row being written
+	 */
+	std::vector<std::uint8_t> transitions_;
+
+	std::vector<std::uint32_t> prefix_;				/*!< alive cells before extended row index */
+	std::vector<std::uint32_t> band_offsets_; /*!< prefix of every band built in parallel */
+
+public:
+	/**
+	 * @param rule_config 1D totalistic rule config
+	 * @param thread_pool pool on which wide rows are processed
+	 */
+	CPUEngine1DTotalistic(const RuleConfig &rule_config, std::shared_ptr<ThreadPool> thread_pool);
+
+	/**
+	 * @return true if engine is able to run passed rule config
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config) noexcept;
+
+	void step(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+						std::int32_t state_count, std::int32_t iteration) override;
+
+private:
+	/**
+	 * builds prefix_ of the read row extended by range cells on both sides
+	 */
+	void buildPrefix(const CellState *row, std::int32_t width);
+	/**
+	 * computes cells [begin, end) of the row being written
+	 */
+	void processCells(CellState *row, std::int32_t state_count, std::size_t begin,
+										std::size_t end) const noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_CPU_ENGINE_1D_TOTALISTIC_HPP
@@ -0,0 +1,97 @@
+#ifndef CELLSIM_CPU_ENGINE_2D_HPP
+#define CELLSIM_CPU_ENGINE_2D_HPP
+
+#include "active_tiles.hpp"
+#include "cpu_engine.hpp"
+#include "life_table.hpp"
+#include "thread_pool.hpp"
+#include <rules/rule_config.hpp>
+
+#include <memory>
+#include <optional>
+
+namespace CSIM {
+
+/**
+ * Engine runs kernel based 2D rule configs (2D life, 2D cyclic) on a thread pool. Rows of the
+ * state map are processed in parallel with work stealing, every row reads from the current
+ * generation and writes into the back buffer which is swapped with the state map after the step.
+ * In active tile mode only tiles which changed or border on a changed tile are processed. 2D life
+ * rules are compiled into a LifeTable, cells are evaluated by a lookup of their neighbourhood.
+ * Runs of multiple generations are temporally blocked: every tile is loaded together with a halo
+ * of generations * reach cells into a worker local buffer, advanced there by all generations of
+ * the block and written back once, so the state map is swept once per block instead of once per
+ * generation
+ */
+struct CPUEngine2D : public CPUEngine {
+private:
+	static constexpr std::int32_t TILE_SIZE{32};
+	static constexpr std::size_t ROW_GRAIN{8};					/*!< rows taken at once by a worker */
+	static constexpr std::int32_t BLOCK_TILE_SIZE{128}; /*!< cells written by a temporal block tile */
+	static constexpr std::int32_t MAX_BLOCK_HALO{16};		/*!< halo limits generations of one block */
+
+	std::shared_ptr<ThreadPool> thread_pool_;
+
+	std::vector<Vec2<std::int32_t>> offsets_; /*!< kernel offsets taken from the config */
+	std::vector<std::uint8_t> survival_;			/*!< survival flag for every possible sum */
+	std::vector<std::uint8_t> birth_;					/*!< birth flag for every possible sum */
+	std::int32_t reach_x_{0};									/*!< max |x| of kernel offsets */
+	std::int32_t reach_y_{0};									/*!< max |y| of kernel offsets */
+	bool state_insensitive_{false};
+	bool wrap_states_{false}; /*!< if set state after the last one is 0 (cyclic) */
+
+	std::optional<LifeTable> life_table_; /*!< compiled transition of 2D life configs */
+
+	std::vector<CellState> back_buffer_;
+	std::vector<std::vector<CellState>> block_buffers_; /*!< tile with halo, one per worker */
+	std::optional<ActiveTiles> active_tiles_;
+	std::int32_t tracked_state_count_{0}; /*!< state count active tiles were tracked with */
+
+public:
+	/**
+	 * @param rule_config 2D life or 2D cyclic rule config
+	 * @param thread_pool pool on which rows are processed
+	 * @param active_tiles if set only active tiles are processed
+	 */
+	CPUEngine2D(const RuleConfig &rule_config, std::shared_ptr<ThreadPool> thread_pool,
+							bool active_tiles = false);
+
+	/**
+	 * @return true if engine is able to run passed rule config
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config) noexcept;
+
+	void step(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+						std::int32_t state_count, std::int32_t iteration) override;
+	void run(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+					 std::int32_t state_count, std::int32_t iteration, std::int32_t generations) override;
+	void invalidate() noexcept override;
+
+private:
+	/**
+	 * advances the state map by generations steps, every tile is computed from its own copy
+	 * extended by generations * reach cells on every side
+	 */
+	void stepBlock(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+								 std::int32_t state_count, std::int32_t generations);
+	void stepActiveTiles(const CellState *src, CellState *dst, Vec2<std::int32_t> resolution,
+											 std::int32_t state_count);
+	/**
+	 * processes cells in columns [bounds.x, bounds.z) of rows [bounds.y, bounds.w)
+	 */
+	void processRect(const CellState *src, CellState *dst, Vec2<std::int32_t> resolution,
+									 std::int32_t state_count, Vec4<std::int32_t> bounds) const noexcept;
+	template <bool STATE_INSENSITIVE>
+	void processRect(const CellState *src, CellState *dst, Vec2<std::int32_t> resolution,
+									 std::int32_t state_count, Vec4<std::int32_t> bounds) const noexcept;
+	/**
+	 * processRect of 2D life configs, looks up neighbourhood patterns in life_table_
+	 */
+	template <bool STATE_INSENSITIVE>
+	void processRectTable(const CellState *src, CellState *dst, Vec2<std::int32_t> resolution,
+												std::int32_t state_count, Vec4<std::int32_t> bounds) const noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_CPU_ENGINE_2D_HPP
@@ -0,0 +1,63 @@
+#ifndef CELLSIM_CPU_ENGINE_BOX_SUM_HPP
+#define CELLSIM_CPU_ENGINE_BOX_SUM_HPP
+
+#include "cpu_engine.hpp"
+#include "thread_pool.hpp"
+#include <rules/rule_config.hpp>
+
+#include <memory>
+
+namespace CSIM {
+
+/**
+ * Engine runs state insensitive 2D cyclic rules with moore (square) or neumann (diamond) kernels
+ * in O(1) per cell regardless of the range. Rows are processed in chunks, for every chunk row
+ * prefix sums of alive cells (wrapped around the torus and padded by range + 1 columns) are
+ * accumulated either along columns (summed-area table, moore) or along both diagonals (neumann),
+ * so every kernel sum is a combination of 4 or 8 table entries which are contiguous along the
+ * row and evaluated with SSE2/AVX2 when available
+ */
+struct CPUEngineBoxSum2D : public CPUEngine {
+private:
+	static constexpr std::int32_t CHUNK_ROWS{64}; /*!< rows evaluated from one set of tables */
+	static constexpr std::int32_t MIN_RANGE{2};	 /*!< below it offset walk is as fast */
+
+	std::shared_ptr<ThreadPool> thread_pool_;
+
+	std::int32_t range_;
+	bool moore_;
+	bool center_active_;
+	std::int32_t threshold_;
+
+	/**
+	 * per worker scratch memory, holds tables of a chunk (1 for moore, 2 for neumann) followed by
+	 * one row of prefix sums
+	 */
+	std::vector<std::vector<std::uint32_t>> scratch_;
+	std::vector<CellState> back_buffer_;
+
+public:
+	/**
+	 * @param rule_config 2D cyclic rule config, has to be supported (see supports)
+	 * @param thread_pool pool on which row chunks are processed
+	 */
+	CPUEngineBoxSum2D(const RuleConfig &rule_config, std::shared_ptr<ThreadPool> thread_pool);
+
+	/**
+	 * @return true if rule config is state insensitive 2D cyclic config with range large enough
+	 * to benefit from box sums
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config) noexcept;
+
+	void step(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+						std::int32_t state_count, std::int32_t iteration) override;
+
+private:
+	void processChunk(const CellState *src, CellState *dst, Vec2<std::int32_t> resolution,
+										std::int32_t state_count, std::int32_t row_begin, std::int32_t row_end,
+										std::vector<std::uint32_t> &scratch) const noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_CPU_ENGINE_BOX_SUM_HPP
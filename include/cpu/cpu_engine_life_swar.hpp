@@ -0,0 +1,97 @@
+#ifndef CELLSIM_CPU_ENGINE_LIFE_SWAR_HPP
+#define CELLSIM_CPU_ENGINE_LIFE_SWAR_HPP
+
+#include "active_tiles.hpp"
+#include "cpu_engine.hpp"
+#include "thread_pool.hpp"
+#include <rules/rule_config.hpp>
+
+#include <array>
+#include <memory>
+#include <optional>
+
+namespace CSIM {
+
+/**
+ * Engine runs two state, state insensitive 2D life rule configs on bit packed state map, 64 cells
+ * per word. Neighbour counts of all 64 cells are computed at once with a full adder network over
+ * shifted copies of neighbouring rows, birth/survival conditions are then matched against the
+ * bit sliced counts. State map is packed once per run(...) call and only words which changed are
+ * written back. In active tile mode tiles are one word wide and TILE_ROWS rows high, quiescent
+ * tiles are skipped and the packed map is kept between calls (unless it was invalidated)
+ */
+struct CPUEngineLifeSWAR : public CPUEngine {
+	static constexpr std::size_t KERNEL_SIZE{9}; /*!< range 1 kernel, 3x3 cells */
+	static constexpr std::size_t MAX_SUM{KERNEL_SIZE};
+	static constexpr std::int32_t TILE_ROWS{64};
+	static constexpr std::size_t ROW_GRAIN{16}; /*!< rows taken at once by a worker */
+
+private:
+	std::shared_ptr<ThreadPool> thread_pool_;
+
+	/**
+	 * for each adder input index of the shifted word it takes, (dy + 1) * 3 + (dx + 1), inputs
+	 * not used by the kernel point at zero word (KERNEL_SIZE)
+	 */
+	std::array<std::uint8_t, KERNEL_SIZE> input_selectors_{};
+
+	/**
+	 * sum s matches when bit sliced count xor count_masks_[s] is all zeros
+	 */
+	struct SumCondition {
+		std::array<std::uint64_t, 4> count_masks;
+		std::uint64_t survival_mask; /*!< all ones if alive cells survive with that sum */
+		std::uint64_t birth_mask;		 /*!< all ones if dead cells are born with that sum */
+	};
+	std::vector<SumCondition> sum_conditions_;
+
+	std::size_t words_per_row_{0};
+	std::uint32_t last_bit_{0};				 /*!< position of the last cell in the last word of a row */
+	std::uint64_t last_word_mask_{0}; /*!< mask of valid cells in the last word of a row */
+
+	std::vector<std::uint64_t> front_;
+	std::vector<std::uint64_t> back_;
+	std::vector<std::uint64_t> initial_;		/*!< packed states from the beginning of the run */
+	std::vector<std::uint64_t> continuous_; /*!< cells which were alive during the whole run */
+
+	std::optional<ActiveTiles> active_tiles_; /*!< tiles in word x row units of the packed map */
+	bool packed_valid_{false}; /*!< if set packed map equals host states from the last run */
+	Vec2<std::int32_t> packed_resolution_{0, 0};
+
+public:
+	/**
+	 * @param rule_config 2D life rule config
+	 * @param thread_pool pool on which rows are processed
+	 * @param active_tiles if set only active tiles are processed
+	 */
+	CPUEngineLifeSWAR(const RuleConfig &rule_config, std::shared_ptr<ThreadPool> thread_pool,
+										bool active_tiles = false);
+
+	/**
+	 * engine supports state insensitive 2D life configs with at most 2 states, in that case alive
+	 * cells never advance their state so whole state of a cell is one bit
+	 * @return true if engine is able to run passed rule config
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config,
+																		 std::int32_t state_count) noexcept;
+
+	void step(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+						std::int32_t state_count, std::int32_t iteration) override;
+	void run(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+					 std::int32_t state_count, std::int32_t iteration, std::int32_t generations) override;
+	void invalidate() noexcept override;
+
+private:
+	void pack(const std::vector<CellState> &states, Vec2<std::int32_t> resolution);
+	void unpack(std::vector<CellState> &states, Vec2<std::int32_t> resolution);
+	void stepActiveTiles(Vec2<std::int32_t> resolution);
+	/**
+	 * processes words [bounds.x, bounds.z) of rows [bounds.y, bounds.w)
+	 * @return true if any cell changed
+	 */
+	bool processWords(Vec2<std::int32_t> resolution, Vec4<std::int32_t> bounds) noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_CPU_ENGINE_LIFE_SWAR_HPP
@@ -0,0 +1,156 @@
+#ifndef CELLSIM_HASH_LIFE_HPP
+#define CELLSIM_HASH_LIFE_HPP
+
+#include "utils/cell_state.hpp"
+#include "utils/vecs.hpp"
+#include <rules/rule_config.hpp>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace CSIM {
+
+using namespace utils;
+
+/**
+ * HashLife (memoized quadtree) engine for two state, state insensitive 2D life rule configs with
+ * range 1 kernels. Advances the state map by 2^k generations at once, identical regions of the
+ * map share one canonical node and every node remembers its future so periodic or sparse patterns
+ * are fast forwarded exponentially.
+ *
+ * Map has to have power of two extents, then the toroidal map is the periodic plane and the tiling
+ * of the map by itself is a quadtree as well (see advance).
+ *
+ * Nodes live in a cache bounded by memory budget, when the budget is reached unreferenced nodes are
+ * garbage collected and all memoized results are dropped
+ */
+struct HashLife {
+	using NodeId = std::uint32_t;
+	static constexpr std::uint32_t LEAF_LEVEL{2};		 /*!< leaves are 4x4 cells */
+	static constexpr std::uint32_t MIN_MAP_LEVEL{3}; /*!< map is tiled to at least 8x8 */
+	static constexpr std::uint32_t MAX_POWER{63};		 /*!< largest single jump is 2^MAX_POWER */
+	static constexpr std::size_t DEFAULT_MEMORY_BUDGET{256ull << 20u};
+
+private:
+	static constexpr NodeId INVALID_NODE{~NodeId{0}};
+	static constexpr std::uint32_t LEAF_CELLS{16};
+
+	struct Node {
+		std::array<NodeId, 4> children; /*!< nw, ne, sw, se, leaf keeps its 4x4 bitmap in [0] */
+		NodeId result; /*!< center after min(2^(level - 2), 2^step_power_) generations */
+		std::uint32_t level;
+		bool marked;
+	};
+	struct NodeKey {
+		std::uint32_t level;
+		std::array<NodeId, 4> children;
+
+		bool operator==(const NodeKey &) const = default;
+	};
+	struct NodeKeyHash {
+		std::size_t operator()(const NodeKey &key) const noexcept;
+	};
+
+	std::vector<Node> nodes_;
+	std::vector<NodeId> free_nodes_;
+	std::unordered_map<NodeKey, NodeId, NodeKeyHash> cache_;
+	std::size_t memory_budget_;
+	std::size_t node_capacity_; /*!< live node count which triggers garbage collection */
+
+	/**
+	 * nodes which have to survive garbage collection: map root and intermediate nodes of results
+	 * being computed
+	 */
+	std::vector<NodeId> pins_;
+	std::uint32_t step_power_{0}; /*!< memoized results advance 2^step_power_ generations */
+
+	/**
+	 * 4x4 cells -> center 2x2 cells after one generation
+	 */
+	std::array<std::uint8_t, 1u << LEAF_CELLS> leaf_step_{};
+
+public:
+	/**
+	 * @param rule_config 2D life rule config, has to be supported (see supports)
+	 * @param memory_budget approximate number of bytes node cache may take
+	 */
+	explicit HashLife(const RuleConfig &rule_config,
+										std::size_t memory_budget = DEFAULT_MEMORY_BUDGET);
+
+	/**
+	 * @return true if engine is able to run passed rule config on a map with given resolution,
+	 * resolution has to be power of two in both axes
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config, std::int32_t state_count,
+																		 Vec2<std::int32_t> resolution) noexcept;
+
+	/**
+	 * function advances state map by 2^power generations, cells which stay alive keep their state
+	 * value, born cells get state 1
+	 * @param states row major state map
+	 * @param resolution resolution of the state map
+	 * @param power binary logarithm of generation count, at most MAX_POWER
+	 */
+	void advance(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+							 std::uint32_t power);
+	/**
+	 * function advances state map by arbitrary number of generations in 2^k jumps
+	 */
+	void advanceBy(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+								 std::uint64_t generations);
+
+	void setMemoryBudget(std::size_t memory_budget) noexcept;
+	[[nodiscard]] std::size_t nodeCount() const noexcept {
+		return cache_.size();
+	}
+	/**
+	 * @return approximate number of bytes taken by the node cache
+	 */
+	[[nodiscard]] std::size_t memoryUsage() const noexcept;
+
+private:
+	[[nodiscard]] static std::size_t bytesPerNode() noexcept;
+
+	NodeId makeLeaf(std::uint32_t bits);
+	NodeId makeNode(NodeId nw, NodeId ne, NodeId sw, NodeId se);
+	NodeId insert(const NodeKey &key);
+	void collectGarbage();
+	void clear() noexcept;
+	void mark(NodeId node) noexcept;
+
+	[[nodiscard]] NodeId child(NodeId node, std::size_t quadrant) const noexcept {
+		return nodes_[node].children[quadrant]; // NOLINT
+	}
+	[[nodiscard]] std::uint32_t level(NodeId node) const noexcept {
+		return nodes_[node].level; // NOLINT
+	}
+	/**
+	 * @return 8x8 cells of level 3 node, bit y * 8 + x
+	 */
+	[[nodiscard]] std::uint64_t gather8x8(NodeId node) const noexcept;
+
+	/**
+	 * center node one level lower, advanced by min(2^(level - 2), 2^step_power_) generations
+	 */
+	NodeId result(NodeId node);
+	NodeId leafResult(NodeId node);
+	NodeId centered(NodeId node);
+	NodeId centeredHorizontal(NodeId west, NodeId east);
+	NodeId centeredVertical(NodeId north, NodeId south);
+
+	NodeId build(const std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+							 std::int32_t x, std::int32_t y, std::uint32_t node_level);
+	void write(NodeId node, std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+						 std::int32_t x, std::int32_t y) const noexcept;
+	/**
+	 * advances map node (periodic plane tile) by 2^power generations
+	 */
+	NodeId advanceMap(NodeId map, std::uint32_t power);
+	void setStepPower(std::uint32_t power) noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_HASH_LIFE_HPP
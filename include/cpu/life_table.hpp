@@ -0,0 +1,98 @@
+#ifndef CELLSIM_LIFE_TABLE_HPP
+#define CELLSIM_LIFE_TABLE_HPP
+
+#include <rules/rule_config.hpp>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+
+namespace CSIM {
+
+/**
+ * Compiled transition of a range 1 2D life rule. Index is the pattern of the 3x3 neighbourhood of
+ * a cell: bit (dy + 1) * 3 + (dx + 1) is set if the neighbour at offset (dx, dy) counts towards the
+ * sum (it is alive, in state sensitive rules it is in the state after the center state), center
+ * bit is set if the cell itself is alive. Entry tells if the cell is alive in the next generation,
+ * so evaluating a cell is a single lookup instead of summing the kernel and checking the hashmaps
+ */
+struct LifeTable {
+	static constexpr std::uint32_t SIZE{512};
+	static constexpr std::uint32_t CENTER_BIT{1u << 4u};
+	static constexpr std::uint32_t MOORE_KERNEL{0x1EFu};	 /*!< 3x3 neighbourhood without center */
+	static constexpr std::uint32_t NEUMANN_KERNEL{0xAAu}; /*!< 4 orthogonal neighbours */
+
+private:
+	std::uint32_t kernel_;	 /*!< bit of every kernel offset */
+	std::uint32_t survival_; /*!< bit of every sum which qualifies cell for survival */
+	std::uint32_t birth_;		 /*!< bit of every sum which qualifies cell for birth */
+	bool state_insensitive_;
+	std::array<std::uint8_t, SIZE> next_alive_{};
+
+public:
+	constexpr LifeTable(std::uint32_t kernel, std::uint32_t survival, std::uint32_t birth,
+											bool state_insensitive) noexcept
+			: kernel_(kernel), survival_(survival), birth_(birth),
+				state_insensitive_(state_insensitive) {
+		/// center cell is never in the state after its own, it counts only in state insensitive rules
+		const auto counted = state_insensitive ? kernel : kernel & ~CENTER_BIT;
+		for (std::uint32_t pattern = 0; pattern < SIZE; ++pattern) {
+			const auto sum = std::popcount(pattern & counted);
+			const auto conditions = (pattern & CENTER_BIT) != 0 ? survival : birth;
+			next_alive_[pattern] = static_cast<std::uint8_t>((conditions >> sum) & 1u); // NOLINT
+		}
+	}
+
+	/**
+	 * @return mask with bit of every passed sum set
+	 */
+	[[nodiscard]] static constexpr std::uint32_t sums(std::initializer_list<std::uint32_t> values) {
+		std::uint32_t mask{0};
+		for (const auto value : values) {
+			mask |= 1u << value;
+		}
+		return mask;
+	}
+
+	/**
+	 * Compiles rule config into the table, well known rules are taken from the tables baked into
+	 * the binary
+	 * @param rule_config 2D life rule config
+	 */
+	[[nodiscard]] static LifeTable compile(const RuleConfig2DLife &rule_config);
+
+	/**
+	 * @return true if table was compiled from the rule with passed parameters
+	 */
+	[[nodiscard]] constexpr bool compiledFrom(std::uint32_t kernel, std::uint32_t survival,
+																						std::uint32_t birth,
+																						bool state_insensitive) const noexcept {
+		return kernel_ == kernel && survival_ == survival && birth_ == birth &&
+					 state_insensitive_ == state_insensitive;
+	}
+
+	/**
+	 * @return 1 if cell with given neighbourhood pattern is alive in the next generation, 0 otherwise
+	 */
+	[[nodiscard]] constexpr std::uint8_t operator[](std::uint32_t pattern) const noexcept {
+		return next_alive_[pattern]; // NOLINT pattern has 9 bits
+	}
+};
+
+/// B3/S23
+inline constexpr LifeTable CONWAY_LIFE_TABLE{LifeTable::MOORE_KERNEL, LifeTable::sums({2, 3}),
+																						 LifeTable::sums({3}), true};
+/// B36/S23
+inline constexpr LifeTable HIGH_LIFE_TABLE{LifeTable::MOORE_KERNEL, LifeTable::sums({2, 3}),
+																					 LifeTable::sums({3, 6}), true};
+/// B3678/S34678
+inline constexpr LifeTable DAY_AND_NIGHT_TABLE{LifeTable::MOORE_KERNEL,
+																							 LifeTable::sums({3, 4, 6, 7, 8}),
+																							 LifeTable::sums({3, 6, 7, 8}), true};
+/// B2/S
+inline constexpr LifeTable SEEDS_TABLE{LifeTable::MOORE_KERNEL, 0, LifeTable::sums({2}), true};
+
+} // namespace CSIM
+
+#endif // CELLSIM_LIFE_TABLE_HPP
@@ -0,0 +1,142 @@
+#ifndef CELLSIM_THREAD_POOL_HPP
+#define CELLSIM_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CSIM {
+
+/**
+ * Fixed size pool of worker threads used by CPU rule engines. Work is submitted as a range of
+ * items (e.g. map rows or tiles) which is split into contiguous bands, one band per worker.
+ * Calling thread processes the first band itself, parallelFor returns when every item has been
+ * processed.
+ *
+ * parallelForDynamic additionally balances the load with work stealing: band of every worker is
+ * its deque of items, owner takes chunks of grain items from the front and worker which ran out
+ * of items steals the back half of the largest remaining deque. Items are expected to be
+ * independent, cost of an item may vary (e.g. tiles with different activity).
+ * @note parallelFor must not be called concurrently from several threads
+ */
+struct ThreadPool { // NOLINT no need for move constructor/assignment
+	/**
+	 * task processes items in range [begin, end) on worker with index worker
+	 */
+	using Task = std::function<void(std::size_t begin, std::size_t end, std::size_t worker)>;
+
+	/**
+	 * per worker counters accumulated since the last resetStats call
+	 */
+	struct WorkerStats {
+		std::uint64_t busy_ns{0}; /*!< time spent in tasks */
+		std::uint64_t items{0};		/*!< number of processed items */
+		std::uint64_t steals{0};	/*!< number of ranges stolen from other workers */
+	};
+
+private:
+	static constexpr std::size_t CACHE_LINE{64};
+
+	/**
+	 * worker deque, range of not yet taken items packed as begin (low half) and end (high half)
+	 * so that owner and thieves take items with a single compare and swap
+	 */
+	struct alignas(CACHE_LINE) Worker {
+		std::atomic<std::uint64_t> range{0};
+		WorkerStats stats;
+	};
+
+	std::vector<std::thread> workers_;
+	std::unique_ptr<Worker[]> worker_states_; // NOLINT fixed size, atomics aren't movable
+	std::mutex mutex_;
+	std::condition_variable work_cv_; /*!< wakes workers up when new task is submitted */
+	std::condition_variable done_cv_; /*!< wakes submitting thread when last worker is done */
+	const Task *task_{nullptr};				/*!< task currently being processed */
+	std::size_t item_count_{0};				/*!< number of items of current task */
+	std::size_t grain_{0};						/*!< chunk size of current task, 0 = static bands */
+	std::size_t generation_{0};				/*!< incremented with every submitted task */
+	std::size_t pending_workers_{0};	/*!< workers which haven't finished current task */
+	std::uint64_t wall_ns_{0};				/*!< time spent in parallelFor calls since resetStats */
+	bool stop_{false};
+
+public:
+	/**
+	 * @param thread_count total number of threads processing tasks including the calling thread
+	 */
+	explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency());
+
+	/**
+	 * @return number of threads processing tasks including the calling thread
+	 */
+	[[nodiscard]] std::size_t threadCount() const noexcept {
+		return workers_.size() + 1;
+	}
+
+	/**
+	 * Splits [0, item_count) into threadCount() contiguous bands and processes them in parallel,
+	 * blocks until all bands are processed
+	 * @param item_count number of items
+	 * @param task task called once per non empty band
+	 */
+	void parallelFor(std::size_t item_count, const Task &task);
+	/**
+	 * Processes [0, item_count) in parallel with work stealing, blocks until all items are
+	 * processed
+	 * @param item_count number of items
+	 * @param grain maximum number of items passed to one task call
+	 * @param task task called once per chunk of at most grain items
+	 */
+	void parallelForDynamic(std::size_t item_count, std::size_t grain, const Task &task);
+
+	/**
+	 * @return band [begin, end) of items assigned to worker
+	 */
+	[[nodiscard]] static std::pair<std::size_t, std::size_t>
+	band(std::size_t item_count, std::size_t worker, std::size_t worker_count) noexcept {
+		return {item_count * worker / worker_count, item_count * (worker + 1) / worker_count};
+	}
+
+	/**
+	 * @return counters of every worker, has to be called between parallelFor calls
+	 */
+	[[nodiscard]] std::vector<WorkerStats> workerStats() const;
+	/**
+	 * @return time spent in parallelFor calls, utilisation of a worker is its busy time divided by
+	 * the wall time
+	 */
+	[[nodiscard]] std::uint64_t wallTime() const noexcept {
+		return wall_ns_;
+	}
+	void resetStats() noexcept;
+
+	~ThreadPool();
+
+private:
+	void dispatch(std::size_t item_count, std::size_t grain, const Task &task);
+	void workerLoop(std::size_t worker);
+	/**
+	 * processes items of current task assigned to (or stolen by) worker
+	 */
+	void process(std::size_t worker, const Task &task, std::size_t item_count, std::size_t grain);
+	/**
+	 * takes up to grain items from the front of worker's deque
+	 * @return false if the deque is empty
+	 */
+	bool take(Worker &worker, std::size_t grain, std::size_t &begin, std::size_t &end) noexcept;
+	/**
+	 * moves back half of the largest deque of other workers into the deque of worker
+	 * @return false if there was nothing to steal
+	 */
+	bool steal(std::size_t worker, std::size_t grain) noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_THREAD_POOL_HPP
@@ -0,0 +1,155 @@
+#ifndef CELLSIM_GPU_PROFILER_HPP
+#define CELLSIM_GPU_PROFILER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace CSIM {
+
+/**
+ * timed phases of a frame, LOD_PYRAMID, DRAW_MAIN and DRAW_MINIMAP are the parts of
+ * Renderer::draw
+ */
+enum class ProfilePhase : std::size_t {
+	STEP,
+	SEED,
+	READBACK,
+	LOD_PYRAMID,
+	DRAW_MAIN,
+	DRAW_MINIMAP,
+	COUNT
+};
+
+/**
+ * Profiler measures gpu time of frame phases with GL_TIME_ELAPSED queries and their cpu time with
+ * the wall clock. Every phase has a ring of queries, results are collected at the end of later
+ * frames once they are available, so the profiler never waits for the gpu. Zone whose ring is
+ * full or which starts while another zone is open (elapsed queries can't nest) is timed on the
+ * cpu only. Times are kept per frame for the last HISTORY_SIZE frames
+ */
+struct GPUProfiler { // NOLINT no need for move constructor/assignment
+	static constexpr std::size_t PHASE_COUNT{static_cast<std::size_t>(ProfilePhase::COUNT)};
+	static constexpr std::size_t QUERY_RING_SIZE{8};	/*!< zones of a phase waiting for results */
+	static constexpr std::size_t HISTORY_SIZE{256};		/*!< frames whose times are kept */
+	static constexpr std::size_t AVERAGE_FRAMES{120}; /*!< frames rolling averages are taken over */
+	/**
+	 * newest frames left out of gpu averages, their results usually aren't available yet
+	 */
+	static constexpr std::size_t RESULT_LATENCY{4};
+
+	/**
+	 * times phase, zone of nullptr profiler does nothing
+	 */
+	struct Zone { // NOLINT not copyable, not movable
+		Zone(GPUProfiler *profiler, ProfilePhase phase) noexcept;
+		Zone(const Zone &) = delete;
+		Zone &operator=(const Zone &) = delete;
+		~Zone();
+
+	private:
+		GPUProfiler *profiler_;
+		ProfilePhase phase_;
+	};
+
+private:
+	struct QueryRing {
+		std::array<std::uint32_t, QUERY_RING_SIZE> ids{};
+		std::array<std::uint64_t, QUERY_RING_SIZE> frames{}; /*!< frame the zone was timed in */
+		std::size_t oldest{0};															 /*!< oldest query waiting for result */
+		std::size_t pending{0};
+	};
+
+	std::array<QueryRing, PHASE_COUNT> query_rings_{};
+	std::array<std::chrono::steady_clock::time_point, PHASE_COUNT> zone_starts_{};
+	std::size_t gpu_phase_{PHASE_COUNT}; /*!< phase whose query is running, PHASE_COUNT if none */
+
+	/// per frame histories, index frame % HISTORY_SIZE
+	std::array<std::array<float, HISTORY_SIZE>, PHASE_COUNT> gpu_ms_{};
+	std::array<std::array<float, HISTORY_SIZE>, PHASE_COUNT> cpu_ms_{};
+	std::array<float, HISTORY_SIZE> frame_ms_{};
+	std::array<std::uint64_t, HISTORY_SIZE> cells_{}; /*!< cells updated by steps */
+	std::uint64_t frame_{0};
+	std::uint64_t dropped_zones_{0}; /*!< zones timed on the cpu only */
+
+public:
+	/**
+	 * creates queries, requires current GL context
+	 */
+	GPUProfiler();
+
+	void begin(ProfilePhase phase) noexcept;
+	void end(ProfilePhase phase) noexcept;
+	/**
+	 * adds cells updated by simulation steps to the current frame
+	 */
+	void addCellsUpdated(std::uint64_t cells) noexcept {
+		cells_[frame_ % HISTORY_SIZE] += cells;
+	}
+	/**
+	 * collects available query results and starts next frame
+	 * @param frame_seconds duration of the ended frame
+	 */
+	void endFrame(float frame_seconds) noexcept;
+
+	/**
+	 * @return gpu milliseconds per frame spent in phase, averaged over AVERAGE_FRAMES frames
+	 */
+	[[nodiscard]] float gpuMilliseconds(ProfilePhase phase) const noexcept;
+	/**
+	 * @return cpu milliseconds per frame spent in phase, averaged over AVERAGE_FRAMES frames
+	 */
+	[[nodiscard]] float cpuMilliseconds(ProfilePhase phase) const noexcept;
+	/**
+	 * @return oldest frame whose gpu results of phase may still be missing, results of earlier
+	 * frames are final
+	 */
+	[[nodiscard]] std::uint64_t firstPendingFrame(ProfilePhase phase) const noexcept;
+	/**
+	 * @return gpu milliseconds spent in phase during frame, frame has to be one of the last
+	 * HISTORY_SIZE frames
+	 */
+	[[nodiscard]] float frameGPUMilliseconds(ProfilePhase phase, std::uint64_t frame) const noexcept {
+		return gpu_ms_[static_cast<std::size_t>(phase)][frame % HISTORY_SIZE];
+	}
+	/**
+	 * @return cpu milliseconds spent in phase during frame, frame has to be one of the last
+	 * HISTORY_SIZE frames
+	 */
+	[[nodiscard]] float frameCPUMilliseconds(ProfilePhase phase, std::uint64_t frame) const noexcept {
+		return cpu_ms_[static_cast<std::size_t>(phase)][frame % HISTORY_SIZE];
+	}
+	/**
+	 * @return cells updated per second over the last AVERAGE_FRAMES frames
+	 */
+	[[nodiscard]] double cellsPerSecond() const noexcept;
+	/**
+	 * @return durations of the last HISTORY_SIZE frames in milliseconds, index frame % HISTORY_SIZE
+	 */
+	[[nodiscard]] const auto &frameMilliseconds() const noexcept {
+		return frame_ms_;
+	}
+	/**
+	 * @return number of ended frames
+	 */
+	[[nodiscard]] auto frameCount() const noexcept {
+		return frame_;
+	}
+	[[nodiscard]] auto droppedZones() const noexcept {
+		return dropped_zones_;
+	}
+
+	void destroy() noexcept;
+
+private:
+	/**
+	 * @return mean of the history over AVERAGE_FRAMES frames ending latency frames before the current
+	 */
+	[[nodiscard]] float average(const std::array<float, HISTORY_SIZE> &history,
+															std::size_t latency) const noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_GPU_PROFILER_HPP
@@ -0,0 +1,14 @@
+#ifndef CELLSIM_PERFORMANCE_WINDOW_HPP
+#define CELLSIM_PERFORMANCE_WINDOW_HPP
+
+#include <profiler/gpu_profiler.hpp>
+
+namespace CSIM {
+/**
+ * draws rolling gpu and cpu times of frame phases, cells updated per second and histogram of
+ * frame times measured by the profiler
+ */
+void drawPerformanceWindow(const GPUProfiler &profiler);
+} // namespace CSIM
+
+#endif // CELLSIM_PERFORMANCE_WINDOW_HPP
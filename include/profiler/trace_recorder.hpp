@@ -0,0 +1,135 @@
+#ifndef CELLSIM_TRACE_RECORDER_HPP
+#define CELLSIM_TRACE_RECORDER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace CSIM {
+
+/**
+ * TraceRecorder keeps scoped cpu zones of the next frames in a ring of events for offline
+ * analysis. Zones may end on any thread, an event slot is claimed with a single atomic increment
+ * and published with a sequence number, so recording never takes a lock. Zones opened on the
+ * thread owning the GL context can also write GL_TIMESTAMP queries, their results are collected
+ * at the end of later frames without waiting for the gpu and recorded as events of the gpu track.
+ * Recorded events are written as Chrome trace-event json which chrome://tracing and Perfetto read
+ */
+struct TraceRecorder { // NOLINT no need for move constructor/assignment
+	static constexpr std::size_t CAPACITY{std::size_t{1} << 16u}; /*!< events kept, power of two */
+	static constexpr std::size_t MAX_FRAMES{4096};		 /*!< frames a single recording may take */
+	static constexpr std::size_t GPU_QUERY_PAIRS{256}; /*!< gpu zones waiting for results */
+	static constexpr std::uint32_t GPU_THREAD{~std::uint32_t{0}}; /*!< thread of gpu events */
+
+	/**
+	 * records zone while the recorder is recording, zone of nullptr recorder does nothing
+	 */
+	struct Zone { // NOLINT not copyable, not movable
+		/**
+		 * @param name static string shown in the trace
+		 * @param gpu also time zone on the gpu, allowed only on the thread owning the GL context
+		 */
+		Zone(TraceRecorder *recorder, const char *name, bool gpu = false) noexcept;
+		Zone(const Zone &) = delete;
+		Zone &operator=(const Zone &) = delete;
+		~Zone();
+
+	private:
+		TraceRecorder *recorder_; /*!< nullptr if zone isn't recorded */
+		const char *name_;
+		std::uint64_t begin_ns_{0};
+		std::size_t query_pair_{GPU_QUERY_PAIRS}; /*!< GPU_QUERY_PAIRS if not timed on the gpu */
+	};
+
+private:
+	/**
+	 * event slot, fields are relaxed atomics so that a slot rewritten while it is read isn't a data
+	 * race, sequence is 2 * index + 2 once event index is published and odd while it's written
+	 */
+	struct Slot {
+		std::atomic<std::uint64_t> sequence{0};
+		std::atomic<const char *> name{nullptr};
+		std::atomic<std::uint64_t> begin_ns{0};
+		std::atomic<std::uint64_t> end_ns{0};
+		std::atomic<std::uint64_t> frame{0};
+		std::atomic<std::uint32_t> thread{0};
+	};
+
+	struct GPUZone {
+		const char *name{nullptr};
+		std::uint64_t frame{0};
+		bool ended{false}; /*!< end query was written */
+	};
+
+	std::vector<Slot> slots_;						 /*!< allocated by the first recording */
+	std::atomic<std::uint64_t> head_{0}; /*!< index of the next event */
+	std::atomic<bool> recording_{false};
+	std::atomic<std::uint64_t> frame_{0};
+	std::uint64_t first_event_{0}; /*!< first event of the last recording */
+	std::uint64_t first_frame_{0}; /*!< first frame of the last recording */
+	std::uint64_t last_frame_{0};	 /*!< frame after the last recording */
+	std::uint32_t main_thread_{0}; /*!< thread owning the GL context */
+	const std::chrono::steady_clock::time_point epoch_{std::chrono::steady_clock::now()};
+
+	/// begin and end timestamp query of every gpu zone, pairs are taken in order zones begin
+	std::array<std::uint32_t, 2 * GPU_QUERY_PAIRS> query_ids_{};
+	std::array<GPUZone, GPU_QUERY_PAIRS> gpu_zones_{};
+	std::size_t oldest_pair_{0};		/*!< oldest zone waiting for results */
+	std::size_t used_pairs_{0};			/*!< open zones and zones waiting for results */
+	std::int64_t gpu_offset_ns_{0}; /*!< added to gpu timestamps to get recorder time */
+
+public:
+	/**
+	 * creates queries, requires current GL context, constructing thread is the one owning it
+	 */
+	TraceRecorder();
+
+	/**
+	 * starts recording the next frames, events of the previous recording are dropped
+	 * @param frames recorded frames, clamped to [1, MAX_FRAMES]
+	 */
+	void start(std::size_t frames);
+	void stop() noexcept;
+	/**
+	 * collects available gpu timestamps, ends recording once its frames passed and starts next
+	 * frame, called on the thread owning the GL context
+	 */
+	void endFrame() noexcept;
+
+	[[nodiscard]] bool recording() const noexcept {
+		return recording_.load(std::memory_order_acquire);
+	}
+	/**
+	 * writes events of the last recording as Chrome trace-event json, may be called while
+	 * recording, events which are being written are left out
+	 * @return number of written events
+	 * @throws std::runtime_error if file can't be written
+	 */
+	std::size_t writeChromeTrace(const std::filesystem::path &path) const;
+
+	void destroy() noexcept;
+
+private:
+	[[nodiscard]] std::uint64_t now() const noexcept {
+		return static_cast<std::uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+																														 epoch_)
+						.count());
+	}
+	void record(const char *name, std::uint64_t begin_ns, std::uint64_t end_ns, std::uint64_t frame,
+							std::uint32_t thread) noexcept;
+	/**
+	 * @return pair whose begin query was written, GPU_QUERY_PAIRS if none is free
+	 */
+	std::size_t beginGPU(const char *name) noexcept;
+	void endGPU(std::size_t pair) noexcept;
+	static std::uint32_t threadIndex() noexcept;
+};
+
+} // namespace CSIM
+
+#endif // CELLSIM_TRACE_RECORDER_HPP
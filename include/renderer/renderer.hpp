@@ -17,9 +17,22 @@ namespace CSIM {
 
 using namespace utils;
 
+struct GPUProfiler;
+
+/**
+ * SCREEN draws the view in a single full screen pass which looks up the state of every fragment,
+ * so its cost depends on the screen size only, INSTANCED draws one quad per cell
+ */
+enum class RenderMode { SCREEN, INSTANCED };
+
+/**
+ * reduction building a cell of the level of detail pyramid from 2x2 block of the level below, MAX
+ * keeps the highest state, MAJORITY the most frequent one and DENSITY the fraction of alive cells
+ */
+enum class LodReduction : std::int32_t { MAX, MAJORITY, DENSITY };
+
 struct Renderer {
 	std::uint32_t vbo_id_{0};
-	std::uint32_t outline_ibo_od_{0};
 	std::uint32_t vao_id_{0};
 	std::uint32_t view_config_ubo_id_{0};
 	std::uint32_t colors_ubo_id_{0};
@@ -28,6 +41,8 @@ struct Renderer {
 
 	std::shared_ptr<Shader> render_shader_{nullptr};
 	std::shared_ptr<Shader> grid_shader_{nullptr};
+	std::shared_ptr<Shader> screen_shader_{nullptr};
+	std::shared_ptr<Shader> lod_shader_{nullptr};
 	float time_step_{0.f};
 
 	struct ViewConfig {
@@ -35,23 +50,72 @@ struct Renderer {
 		float scale{1.f};
 		float aspect_ratio{1.f};
 		Vec4<float> outline_color{1.f, 1.f, 1.f, 1.f};
+		Vec2<std::int32_t> map_resolution{0, 0};
+		Vec2<std::int32_t> visible_origin{0, 0}; /*!< first cell drawn by instanced cell draws */
+		Vec2<std::int32_t> visible_extent{0, 0}; /*!< cells drawn by instanced cell draws */
+		Vec2<std::int32_t> lod_resolution{0, 0};
+		std::int32_t lod_level{0};  /*!< drawn pyramid level, 0 draws the state map */
+		std::int32_t lod_offset{0}; /*!< offset of the drawn level in the pyramid in words */
+		std::int32_t lod_reduction{0};
+		std::int32_t padding{0}; /*!< std140 block size is a multiple of 16 bytes */
+	};
+
+	/**
+	 * lod pyramid shader config, one dispatch reduces source level into target level
+	 */
+	struct LodConfig {
+		Vec2<std::int32_t> source_resolution;
+		Vec2<std::int32_t> target_resolution;
+		std::int32_t source_offset; /*!< offset of the source level in the pyramid in words */
+		std::int32_t target_offset;
+		std::int32_t from_state_map; /*!< if set source level is the state map */
+		std::int32_t reduction;
+	};
+
+	struct LodLevel {
+		Vec2<std::int32_t> resolution;
+		std::int32_t offset; /*!< offset of the level in the pyramid in words */
 	};
 
+	std::uint32_t lod_config_ubo_id_{0};
+	std::uint32_t lod_pyramid_ssbo_id_{0};
+	std::vector<LodLevel> lod_levels_;					  /*!< each level halves the one below */
+	Vec2<std::int32_t> lod_map_resolution_{0, 0}; /*!< resolution the pyramid is allocated for */
+	std::uint64_t lod_states_version_{0};				  /*!< cell map states version of the pyramid */
+	bool lod_dirty_{true};
+	bool lod_on_{true};
+	LodReduction lod_reduction_{LodReduction::MAX};
+
 	static constexpr std::size_t MAX_COLORS{ 256 };
 
 	ViewConfig view_config_{};
 	std::array<Vec4<float>, MAX_COLORS> colors_;
 	std::size_t color_count_{0};
 	bool grid_on_{false};
+	RenderMode render_mode_{RenderMode::SCREEN};
 	Vec4<float> clear_color_{0.f, 0.f, 0.f, 1.f};
 
+	/// inputs of the last drawn frame, passes whose inputs didn't change since are skipped
+	ViewConfig drawn_view_config_{};
+	Vec4<float> drawn_clear_color_{};
+	bool drawn_grid_on_{false};
+	RenderMode drawn_render_mode_{RenderMode::SCREEN};
+	std::uint64_t states_version_{0}; /*!< cell map states version of the last frame */
+	bool main_dirty_{true};						/*!< main view has to be redrawn */
+	bool minimap_dirty_{true};				/*!< cell map texture has to be redrawn */
+	float minimap_rate_{10.f};				/*!< maximal cell map texture redraws per second */
+	float minimap_elapsed_{0.f};			/*!< seconds since the last cell map texture redraw */
+
+	GPUProfiler *profiler_{nullptr}; /*!< if set lod pyramid, main and minimap passes are timed */
+
 	static constexpr std::array<float, 8> QUAD{{-.5f, -.5f, -.5f, .5f, .5f, -.5f, .5f, .5f}};
-	static constexpr std::array<std::uint32_t, 4> OUTLINE_INDICES{{0, 1, 3, 2}};
 
 	Renderer(
 			Vec2<int> win_size,
 			std::shared_ptr<Shader> render_shader,
-			std::shared_ptr<Shader> grid_shader
+			std::shared_ptr<Shader> grid_shader,
+			std::shared_ptr<Shader> screen_shader,
+			std::shared_ptr<Shader> lod_shader
 	);
 
 	void setClearColor(Vec4<float> color) {
@@ -75,9 +139,56 @@ struct Renderer {
 
 	void updateView(Vec2<float> offset_vec, float scale_vec) noexcept;
 
+	/**
+	 * has to be called after every simulation step, views and lod pyramid are drawn only when
+	 * states, colors or the view changed since the last frame
+	 */
+	void markStatesChanged() noexcept {
+		lod_dirty_ = true;
+		main_dirty_ = true;
+		minimap_dirty_ = true;
+	}
+	void setLodReduction(LodReduction reduction) noexcept {
+		if (reduction != lod_reduction_) {
+			lod_reduction_ = reduction;
+			lod_dirty_ = true;
+			main_dirty_ = true;
+		}
+	}
+	/**
+	 * @param rate maximal cell map texture redraws per second
+	 */
+	void setMinimapRate(float rate) noexcept {
+		minimap_rate_ = rate;
+	}
+
 	void draw(Vec2<int> win_size, const CellMap &cellmap) noexcept;
 
 	void destroy();
+
+private:
+	/**
+	 * draws cells of the map into the bound framebuffer with the current render mode
+	 */
+	void drawCells(std::int32_t instance_count) const noexcept;
+
+	/**
+	 * sets visible_origin and visible_extent of the config to the rectangle of cells which overlap
+	 * the viewport, instanced draws of the config draw only these cells
+	 * @return number of visible cells
+	 */
+	static std::int32_t cullView(ViewConfig &config) noexcept;
+
+	/**
+	 * @return pyramid level whose cells cover at least a pixel of the viewport, 0 if cells of the
+	 * map do or lod is off
+	 */
+	[[nodiscard]] std::int32_t lodLevel(Vec2<int> win_size) const noexcept;
+	/**
+	 * reallocates lod pyramid when the map resolution changes and rebuilds it if the states changed
+	 * since the last build
+	 */
+	void updateLodPyramid(const CellMap &cellmap) noexcept;
 };
 
 } // namespace CSIM
@@ -3,6 +3,9 @@
 
 #include "utils/vecs.hpp"
 #include <cellmap/cellmap.hpp>
+#include <cpu/cpu_engine.hpp>
+#include <cpu/hash_life.hpp>
+#include <cpu/thread_pool.hpp>
 #include <rules/rule_config.hpp>
 
 #include <memory>
@@ -11,7 +14,17 @@ namespace CSIM {
 
 using namespace utils;
 
-enum class RuleType { BASIC_1D, BASIC_2D };
+enum class RuleType {
+	BASIC_1D,
+	BASIC_2D,
+	ACTIVE_TILES_2D,
+	TEMPORAL_2D,
+	BOX_SUM_2D,
+	PREFIX_SUM_1D,
+	CPU_1D,
+	CPU_2D,
+	HASH_LIFE_2D
+};
 /**
  * Interface class for defining the rule algorithm. It takes compatible rule config struct that
  * requires compatible void step(...) procedure
@@ -43,7 +56,7 @@ public:
 	 * Function which change used rule config
 	 * @param rule_config
 	 */
-	void setRuleConfig(std::shared_ptr<RuleConfig> rule_config);
+	virtual void setRuleConfig(std::shared_ptr<RuleConfig> rule_config);
 	/**
 	 * @return rule type which identifies the rule
 	 */
@@ -63,7 +76,7 @@ public:
 	 * @param cell_map current cell map
 	 * @param state_count  current number of cell states
 	 */
-	virtual void step(const CellMap &cell_map, std::int32_t state_count) = 0;
+	virtual void step(CellMap &cell_map, std::int32_t state_count) = 0;
 
 	virtual void destroy();
 	virtual ~Rule() = default;
@@ -77,11 +90,25 @@ protected:
 	void setBaseConfig(BaseConfig config, bool update_iteration = false) noexcept;
 	/**
 	 * function returns iteration and postincrement it
+	 * @param generations number of generations the step advances the map by
 	 * @return current iteration
 	 */
-	[[nodiscard]] auto iterate() {
-		return base_config_.iteration++;
+	[[nodiscard]] auto iterate(std::int32_t generations = 1) {
+		const auto iteration = base_config_.iteration;
+		base_config_.iteration += generations;
+		return iteration;
+	}
+	/**
+	 * @return rule config currently set on the rule
+	 */
+	[[nodiscard]] const auto &ruleConfig() const noexcept {
+		return rule_config_;
 	}
+	/**
+	 * Binds base config and config ubos, every rule binds them in its step because all rules share
+	 * the binding indices
+	 */
+	void bindConfigBuffers() noexcept;
 	/**
 	 * Binds current config compute shader
 	 */
@@ -104,21 +131,90 @@ struct Rule1D : public Rule {
 		return "Basic 1D";
 	}
 
-	void step(const CellMap &cell_map, std::int32_t state_count) noexcept override;
+	void step(CellMap &cell_map, std::int32_t state_count) noexcept override;
 
 	void destroy() override;
 };
 
 /**
- * Rule performs basic kernel based 2D cellular automata algorithm
+ * Rule runs 1D totalistic configs with O(1) cost per cell regardless of the range. Alive cells of
+ * the read row are counted into a prefix sum table (work group scans, then scan of work group
+ * totals), sum of a cell is difference of two table entries
+ */
+struct Rule1DPrefixSum : public Rule {
+	/**
+	 * prefix sum shader config, pass selects which part of the algorithm is dispatched
+	 */
+	struct PrefixSumConfig {
+		std::int32_t pass;
+		std::int32_t group_count; /*!< number of work groups covering the row */
+	};
+
+private:
+	static constexpr std::int32_t MIN_RANGE{16}; /*!< below it walking the range is as fast */
+	static constexpr std::int32_t PASS_SCAN_GROUPS{0};
+	static constexpr std::int32_t PASS_SCAN_TOTALS{1};
+	static constexpr std::int32_t PASS_EVALUATE{2};
+	static constexpr std::int32_t GROUP_SIZE{256}; /*!< local size x of the prefix sum shader */
+
+	std::shared_ptr<Shader> prefix_sum_shader_;
+	std::uint32_t prefix_sum_config_ubo_id_{0};
+	std::uint32_t tables_ssbo_id_{0};
+	std::size_t tables_size_{0}; /*!< size of allocated tables ssbo in bytes */
+
+	PrefixSumConfig prefix_sum_config_{0, 0};
+
+public:
+	explicit Rule1DPrefixSum(std::shared_ptr<RuleConfig> rule_config);
+
+	/**
+	 * @return true if rule config is 1D totalistic config with range large enough to benefit from
+	 * prefix sums
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config) noexcept;
+
+	[[nodiscard]] RuleType ruleType() const override {
+		return RuleType::PREFIX_SUM_1D;
+	}
+	[[nodiscard]] std::string_view ruleTypeSerialized() const override {
+		return "Prefix sum 1D";
+	}
+
+	void step(CellMap &cell_map, std::int32_t state_count) noexcept override;
+
+	void destroy() override;
+
+private:
+	void dispatchPass(std::int32_t pass, std::uint32_t group_count) noexcept;
+};
+
+/**
+ * Rule performs basic kernel based 2D cellular automata algorithm. Generations ping-pong between
+ * the two state map ssbos of the cell map, every invocation writes one word (four cells) of the
+ * next generation, so a step is a single dispatch without any copy or upload. With shared tiles
+ * every work group loads a 64x16 tile with its halo into shared memory once, so neighbours
+ * overlapping between cells are not fetched from the state map again for every cell
  */
 struct Rule2D : public Rule {
 private:
-	std::uint32_t state_map_copy_ssbo_id_{0};
+	static constexpr std::uint32_t GROUP_SIZE{256};				 /*!< local size x of the 2D shaders */
+	static constexpr std::uint32_t MAX_GROUP_COUNT{65535}; /*!< guaranteed work groups per axis */
+	static constexpr std::int32_t TILE_WIDTH{64};					 /*!< tile of a shared shader group */
+	static constexpr std::int32_t TILE_HEIGHT{16};
+
+	std::shared_ptr<Shader> life_shared_shader_;
+	std::shared_ptr<Shader> cyclic_shared_shader_;
+	bool shared_tiles_;
 	Vec2<std::int32_t> previous_map_resolution_{0, 0};
+	std::int32_t previous_state_count_{0};
 
 public:
-	explicit Rule2D(std::shared_ptr<RuleConfig> rule_config);
+	/**
+	 * @param rule_config 2D rule config
+	 * @param shared_tiles if set 2D life and 2D cyclic configs stage every tile with its halo in
+	 * shared memory instead of reading all neighbours from the state map
+	 */
+	Rule2D(std::shared_ptr<RuleConfig> rule_config, bool shared_tiles);
 
 	[[nodiscard]] RuleType ruleType() const override {
 		return RuleType::BASIC_2D;
@@ -127,11 +223,309 @@ public:
 		return "Basic 2D";
 	}
 
-	void step(const CellMap &cell_map, std::int32_t state_count) noexcept override;
+	void step(CellMap &cell_map, std::int32_t state_count) noexcept override;
+
+	void destroy() override;
+};
+
+/**
+ * Rule runs kernel based 2D configs like Rule2D, but recomputes only active tiles, i.e. tiles
+ * which changed in the last generation or are within kernel reach of a changed tile. List of active
+ * tiles is built on the GPU and evaluated with indirect dispatch (one work group per tile), so
+ * sparse maps cost in proportion to their activity instead of their area
+ */
+struct Rule2DActiveTiles : public Rule {
+	/**
+	 * tiles shader config, pass selects which bookkeeping pass is dispatched
+	 */
+	struct TilesConfig {
+		Vec2<std::int32_t> tile_count;
+		Vec2<std::int32_t> tile_reach;
+		std::int32_t pass;
+		std::int32_t all_active;
+	};
+
+private:
+	static constexpr std::int32_t TILE_SIZE{16};				/*!< local size of the tile shaders */
+	static constexpr std::int32_t LIST_GROUP_SIZE{256}; /*!< tiles listed by one work group */
+	static constexpr std::int32_t PASS_LIST{0};
+	static constexpr std::int32_t PASS_SYNC{1};
+
+	std::shared_ptr<Shader> tiles_shader_;
+	std::shared_ptr<Shader> life_tiles_shader_;
+	std::shared_ptr<Shader> cyclic_tiles_shader_;
+	std::uint32_t tiles_config_ubo_id_{0};
+	std::uint32_t active_tiles_ssbo_id_{0};	 /*!< indirect dispatch arguments and active tiles */
+	std::uint32_t changed_tiles_ssbo_id_{0}; /*!< changed flags of the last two generations */
+	Vec2<std::int32_t> previous_map_resolution_{0, 0};
+
+	TilesConfig tiles_config_;
+	std::int32_t reach_;									/*!< kernel reach in cells */
+	bool all_active_{true};							/*!< if set tracking restarts in the next step */
+	std::int32_t previous_state_count_{0};
+	std::uint64_t states_version_{0}; /*!< cell map states version seen in the last step */
+
+public:
+	explicit Rule2DActiveTiles(std::shared_ptr<RuleConfig> rule_config);
+
+	/**
+	 * @return true if rule config is 2D life or 2D cyclic config
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config) noexcept;
+
+	[[nodiscard]] RuleType ruleType() const override {
+		return RuleType::ACTIVE_TILES_2D;
+	}
+	[[nodiscard]] std::string_view ruleTypeSerialized() const override {
+		return "Active tiles 2D";
+	}
+
+	void setRuleConfig(std::shared_ptr<RuleConfig> rule_config) override;
+
+	void step(CellMap &cell_map, std::int32_t state_count) noexcept override;
+
+	void destroy() override;
+
+private:
+	void setPass(std::int32_t pass) noexcept;
+};
+
+/**
+ * Rule runs kernel based 2D configs like Rule2D, but advances the map by multiple generations per
+ * dispatch (temporal blocking). Every work group loads its tile together with a halo of
+ * generations * reach cells into shared memory, computes all generations there and writes the tile
+ * back once, so the state map is read and written once per block instead of once per generation.
+ * Generations which don't fit into the halo limit are split into several dispatches
+ */
+struct Rule2DTemporal : public Rule {
+	/**
+	 * temporal shader config
+	 */
+	struct TemporalConfig {
+		std::int32_t generations; /*!< generations computed by the dispatch */
+		std::int32_t reach;				/*!< kernel reach in cells */
+	};
+
+private:
+	static constexpr std::int32_t TILE_SIZE{32}; /*!< cells written by one work group */
+	static constexpr std::int32_t MAX_HALO{10};	/*!< shared memory halo of the temporal shaders */
+
+	std::shared_ptr<Shader> life_temporal_shader_;
+	std::shared_ptr<Shader> cyclic_temporal_shader_;
+	std::uint32_t temporal_config_ubo_id_{0};
+
+	TemporalConfig temporal_config_;
+	std::int32_t generations_; /*!< generations advanced by every step */
+
+public:
+	/**
+	 * @param rule_config 2D life or 2D cyclic rule config
+	 * @param generations generations advanced by every step
+	 */
+	Rule2DTemporal(std::shared_ptr<RuleConfig> rule_config, std::int32_t generations);
+
+	/**
+	 * @return true if rule config is 2D life or 2D cyclic config
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config) noexcept;
+
+	[[nodiscard]] RuleType ruleType() const override {
+		return RuleType::TEMPORAL_2D;
+	}
+	[[nodiscard]] std::string_view ruleTypeSerialized() const override {
+		return "Temporal 2D";
+	}
+
+	void setRuleConfig(std::shared_ptr<RuleConfig> rule_config) override;
+
+	void step(CellMap &cell_map, std::int32_t state_count) noexcept override;
 
 	void destroy() override;
 };
 
+/**
+ * Rule runs state insensitive 2D cyclic configs with O(1) cost per cell regardless of the range.
+ * Instead of walking every offset it builds prefix sum tables of alive cells (summed-area table
+ * for moore kernels, diagonal sums for neumann kernels) and combines 4 or 8 table entries per cell
+ */
+struct Rule2DBoxSum : public Rule {
+	/**
+	 * box sum shader config, pass selects which part of the algorithm is dispatched
+	 */
+	struct BoxSumConfig {
+		std::int32_t pass;
+		std::int32_t range;
+		std::int32_t moore;
+		std::int32_t center_active;
+	};
+
+private:
+	static constexpr std::int32_t MIN_RANGE{2}; /*!< below it offset walk is as fast */
+	static constexpr std::int32_t PASS_PREFIX{0};
+	static constexpr std::int32_t PASS_ACCUMULATE{1};
+	static constexpr std::int32_t PASS_EVALUATE{2};
+	static constexpr std::int32_t GROUP_SIZE{64}; /*!< local size x of the box sum shader */
+
+	std::shared_ptr<Shader> box_sum_shader_;
+	std::uint32_t box_sum_config_ubo_id_{0};
+	std::uint32_t tables_ssbo_id_{0};
+	std::size_t tables_size_{0}; /*!< size of allocated tables ssbo in bytes */
+
+	BoxSumConfig box_sum_config_;
+
+public:
+	explicit Rule2DBoxSum(std::shared_ptr<RuleConfig> rule_config);
+
+	/**
+	 * @return true if rule config is state insensitive 2D cyclic config with range large enough
+	 * to benefit from box sums
+	 */
+	[[nodiscard]] static bool supports(const RuleConfig &rule_config) noexcept;
+
+	[[nodiscard]] RuleType ruleType() const override {
+		return RuleType::BOX_SUM_2D;
+	}
+	[[nodiscard]] std::string_view ruleTypeSerialized() const override {
+		return "Box sum 2D";
+	}
+
+	void setRuleConfig(std::shared_ptr<RuleConfig> rule_config) override;
+
+	void step(CellMap &cell_map, std::int32_t state_count) noexcept override;
+
+	void destroy() override;
+
+private:
+	void dispatchPass(std::int32_t pass, std::uint32_t group_count_x,
+										std::uint32_t group_count_y) noexcept;
+};
+
+/**
+ * Rule runs kernel based 2D rule configs on the CPU (see makeCPUEngine) instead of dispatching
+ * compute shader. Cell map host states are the source of truth, after every step they are
+ * uploaded to the state map ssbo so that renderer can draw them
+ */
+struct RuleCPU2D : public Rule {
+private:
+	std::shared_ptr<ThreadPool> thread_pool_;
+	std::unique_ptr<CPUEngine> engine_;
+	std::int32_t engine_state_count_{0}; /*!< state count engine was selected for */
+	bool host_states_synced_{false};		 /*!< if false host states are downloaded before the step */
+	bool active_tiles_;									 /*!< engines recompute only active tiles */
+	std::int32_t generations_;					 /*!< generations advanced by every step */
+	std::uint64_t states_version_{0};		 /*!< cell map states version engine has seen */
+
+public:
+	/**
+	 * @param rule_config 2D life or 2D cyclic rule config
+	 * @param thread_pool pool on which the engine runs
+	 * @param active_tiles if set engines skip tiles which didn't change (see ActiveTiles)
+	 * @param generations generations advanced by every step, engines run them at once (e.g.
+	 * temporally blocked)
+	 */
+	RuleCPU2D(std::shared_ptr<RuleConfig> rule_config, std::shared_ptr<ThreadPool> thread_pool,
+						bool active_tiles = false, std::int32_t generations = 1);
+
+	[[nodiscard]] RuleType ruleType() const override {
+		return RuleType::CPU_2D;
+	}
+	[[nodiscard]] std::string_view ruleTypeSerialized() const override {
+		return "CPU 2D";
+	}
+
+	void setRuleConfig(std::shared_ptr<RuleConfig> rule_config) override;
+
+	void step(CellMap &cell_map, std::int32_t state_count) override;
+
+	void destroy() override;
+
+protected:
+	/**
+	 * downloads states from the state map ssbo if host states weren't synced yet
+	 */
+	void syncHostStates(CellMap &cell_map);
+	/**
+	 * tells the engine that host states were modified by other means than its step
+	 */
+	void invalidateEngine() noexcept;
+};
+
+/**
+ * Rule runs 1D rule configs on the CPU (see makeCPUEngine), every step computes the row after the
+ * row selected by iteration like Rule1D. Host states are handled the same way as in RuleCPU2D
+ */
+struct RuleCPU1D : public RuleCPU2D {
+	/**
+	 * @param rule_config 1D binary or 1D totalistic rule config
+	 * @param thread_pool pool on which wide rows are processed
+	 */
+	RuleCPU1D(std::shared_ptr<RuleConfig> rule_config, std::shared_ptr<ThreadPool> thread_pool);
+
+	[[nodiscard]] RuleType ruleType() const override {
+		return RuleType::CPU_1D;
+	}
+	[[nodiscard]] std::string_view ruleTypeSerialized() const override {
+		return "CPU 1D";
+	}
+};
+
+/**
+ * Rule runs 2D life configs on the CPU like RuleCPU2D, additionally it can jump over huge numbers
+ * of generations at once with HashLife (two state, range 1 configs on power of two maps)
+ */
+struct RuleHashLife : public RuleCPU2D {
+private:
+	std::unique_ptr<HashLife> hash_life_;
+	std::size_t memory_budget_; /*!< hashlife node cache budget in bytes */
+
+public:
+	/**
+	 * @param rule_config 2D life rule config
+	 * @param thread_pool pool on which single steps run
+	 * @param memory_budget hashlife node cache budget in bytes
+	 * @param active_tiles if set single steps recompute only active tiles
+	 * @param generations generations advanced by every step
+	 */
+	RuleHashLife(std::shared_ptr<RuleConfig> rule_config, std::shared_ptr<ThreadPool> thread_pool,
+							 std::size_t memory_budget = HashLife::DEFAULT_MEMORY_BUDGET,
+							 bool active_tiles = false, std::int32_t generations = 1);
+
+	[[nodiscard]] RuleType ruleType() const override {
+		return RuleType::HASH_LIFE_2D;
+	}
+	[[nodiscard]] std::string_view ruleTypeSerialized() const override {
+		return "HashLife 2D";
+	}
+
+	void setRuleConfig(std::shared_ptr<RuleConfig> rule_config) override;
+	void setMemoryBudget(std::size_t memory_budget) noexcept;
+
+	/**
+	 * function advances cell map by given number of generations at once
+	 * @param cell_map current cell map
+	 * @param state_count current number of cell states
+	 * @param generations number of generations, done in 2^k jumps
+	 * @return false if hashlife doesn't support current config, state count or map resolution
+	 */
+	bool jump(CellMap &cell_map, std::int32_t state_count, std::uint64_t generations);
+};
+
+/**
+ * @return compute shader which steps rule configs of passed type
+ */
+std::shared_ptr<Shader> makeStepShader(RuleConfigType config_type);
+/**
+ * @return type of the gpu rule which runs passed config fastest, large 1D totalistic ranges and
+ * large state insensitive 2D cyclic kernels are evaluated from prefix sums
+ */
+[[nodiscard]] RuleType gpuRuleType(const RuleConfig &rule_config) noexcept;
+/**
+ * @param rule_config config with step shader (see makeStepShader)
+ * @param active_tiles if set 2D configs which aren't evaluated from prefix sums run on active tiles
+ * @return gpu rule of type gpuRuleType, other 2D configs run the per word kernel
+ */
+std::shared_ptr<Rule> makeGPURule(std::shared_ptr<RuleConfig> rule_config, bool active_tiles);
+
 } // namespace CSIM
 
 #endif // CELLSIM_RULES_HPP
@@ -17,6 +17,7 @@ namespace CSIM {
 
 using namespace utils;
 
+enum class RuleConfigType { TOTALISTIC_1D, BINARY_1D, CYCLIC_2D, LIFE_2D };
 /**
  * Rule config is interface class which contains info about current rule specific config and
  * compute shader it can be given to compatible rule type
@@ -34,6 +35,11 @@ public:
 	 * @return string view name
 	 */
 	[[nodiscard]] virtual std::string_view ruleConfigName() const = 0;
+	/**
+	 * @return rule config type which identifies the config, used by CPU engines to interpret
+	 * config data
+	 */
+	[[nodiscard]] virtual RuleConfigType ruleConfigType() const = 0;
 	/**
 	 * get config serialized to show in info window.
 	 * @return array of config:value pairs
@@ -67,10 +73,13 @@ public:
  * computed sum of alive cells is compered with
  */
 struct RuleConfig1DTotalistic : public RuleConfig {
-	static constexpr Vec2<std::uint32_t> RANGE_LIM{0, 10}; /*!< limits of range configuration*/
-	static constexpr std::size_t MAX_OPTIONS{2 * RANGE_LIM.y + 1}; /*!< max number of b/s options*/
+	static constexpr Vec2<std::uint32_t> RANGE_LIM{0, 1000}; /*!< limits of range configuration*/
+	/**
+	 * max number of b/s options, sums go from 0 to 2 * range + 1 (center included), both arrays
+	 * still fit into minimal guaranteed uniform block size
+	 */
+	static constexpr std::size_t MAX_OPTIONS{2 * RANGE_LIM.y + 2};
 
-private:
 	/**
 	 * config defines range, center active and b/s option arrays
 	 */
@@ -81,6 +90,7 @@ private:
 		alignas(16) std::int32_t birth_conditions_hashmap[MAX_OPTIONS];		 // NOLINT interfacing with gl
 	};
 
+private:
 	Config config_;
 	std::vector<std::pair<std::string, std::string>> config_serialized_;
 
@@ -99,6 +109,9 @@ public:
 	[[nodiscard]] std::string_view ruleConfigName() const override {
 		return "1D Totalistic";
 	}
+	[[nodiscard]] RuleConfigType ruleConfigType() const override {
+		return RuleConfigType::TOTALISTIC_1D;
+	}
 	[[nodiscard]] const std::vector<std::pair<std::string, std::string>> &
 	configSerialized() const override {
 		return config_serialized_;
@@ -110,6 +123,9 @@ public:
 	[[nodiscard]] const void *data() const override {
 		return &config_;
 	}
+	[[nodiscard]] const Config &config() const noexcept {
+		return config_;
+	}
 
 	void destroy() override {
 		RuleConfig::destroy();
@@ -125,7 +141,6 @@ struct RuleConfig1DBinary : public RuleConfig {
 	static constexpr Vec2<std::uint32_t> RANGE_LIM{0, 4}; /*!< limits of range configuration*/
 	static constexpr std::uint32_t MAX_PATTERN_COUNT{16}; // (2^(2 * RANGE_LIM.y + 1))/32
 
-private:
 	/**
 	 * config defines range and pattern_match_code
 	 */
@@ -134,6 +149,7 @@ private:
 		alignas(16) std::uint32_t pattern_match_code[MAX_PATTERN_COUNT]; // NOLINT interfacing with gl
 	};
 
+private:
 	Config config_;
 	std::vector<std::pair<std::string, std::string>> config_serialized_;
 
@@ -155,6 +171,9 @@ public:
 	[[nodiscard]] std::string_view ruleConfigName() const override {
 		return "1D Binary";
 	}
+	[[nodiscard]] RuleConfigType ruleConfigType() const override {
+		return RuleConfigType::BINARY_1D;
+	}
 	[[nodiscard]] const std::vector<std::pair<std::string, std::string>> &
 	configSerialized() const override {
 		return config_serialized_;
@@ -166,6 +185,9 @@ public:
 	[[nodiscard]] const void *data() const override {
 		return &config_;
 	}
+	[[nodiscard]] const Config &config() const noexcept {
+		return config_;
+	}
 
 	void destroy() override {
 		RuleConfig::destroy();
@@ -193,6 +215,7 @@ struct RuleConfig2DCyclic : public RuleConfig {
 private:
 	static constexpr std::uint32_t offsets_capacity{((2 * RANGE_LIM.y + 1) * (2 * RANGE_LIM.y + 1))};
 
+public:
 	struct Config {
 		std::int32_t threshold;
 		std::int32_t state_insensitive;
@@ -200,8 +223,12 @@ private:
 		alignas(16) Vec2<std::int32_t> offsets[offsets_capacity]; // NOLINT interfacing with gl
 	};
 
+private:
 	Config config_;
 	std::vector<std::pair<std::string, std::string>> config_serialized_;
+	std::int32_t range_;
+	bool moore_;
+	bool center_active_;
 
 public:
 	static constexpr Vec2<std::uint32_t> SUM_LIM{0, offsets_capacity};
@@ -220,6 +247,9 @@ public:
 	[[nodiscard]] std::string_view ruleConfigName() const override {
 		return "2D Cyclic";
 	}
+	[[nodiscard]] RuleConfigType ruleConfigType() const override {
+		return RuleConfigType::CYCLIC_2D;
+	}
 	[[nodiscard]] const std::vector<std::pair<std::string, std::string>> &
 	configSerialized() const override {
 		return config_serialized_;
@@ -231,6 +261,22 @@ public:
 	[[nodiscard]] const void *data() const override {
 		return &config_;
 	}
+	[[nodiscard]] const Config &config() const noexcept {
+		return config_;
+	}
+	/**
+	 * kernel description from which Config::offsets were generated, lets rules evaluate the kernel
+	 * without walking every offset
+	 */
+	[[nodiscard]] auto range() const noexcept {
+		return range_;
+	}
+	[[nodiscard]] auto moore() const noexcept {
+		return moore_;
+	}
+	[[nodiscard]] auto centerActive() const noexcept {
+		return center_active_;
+	}
 
 	void destroy() override {
 		RuleConfig::destroy();
@@ -239,7 +285,7 @@ public:
 
 struct RuleConfig2DLife : public RuleConfig {
 	static constexpr std::size_t MAX_OPTIONS{256}; // 2^8 / 4
-private:
+
 	struct Config {
 		std::int32_t state_insensitive;
 		std::int32_t offsets_count;
@@ -248,6 +294,7 @@ private:
 		alignas(16) std::int32_t birth_conditions_hashmap[MAX_OPTIONS];		 // NOLINT interfacing with gl
 	};
 
+private:
 	Config config_;
 	std::vector<std::pair<std::string, std::string>> config_serialized_;
 
@@ -260,6 +307,9 @@ public:
 	[[nodiscard]] std::string_view ruleConfigName() const override {
 		return "2D Cyclic";
 	}
+	[[nodiscard]] RuleConfigType ruleConfigType() const override {
+		return RuleConfigType::LIFE_2D;
+	}
 	[[nodiscard]] const std::vector<std::pair<std::string, std::string>> &
 	configSerialized() const override {
 		return config_serialized_;
@@ -271,6 +321,9 @@ public:
 	[[nodiscard]] const void *data() const override {
 		return &config_;
 	}
+	[[nodiscard]] const Config &config() const noexcept {
+		return config_;
+	}
 
 	void destroy() override {
 		RuleConfig::destroy();
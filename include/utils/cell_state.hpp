@@ -0,0 +1,17 @@
+#ifndef CELLSIM_CELL_STATE_HPP
+#define CELLSIM_CELL_STATE_HPP
+
+#include <cstdint>
+
+namespace CSIM::utils {
+
+/**
+ * state of a single cell, renderer palette caps the number of states at 256 so a byte is enough.
+ * State map ssbo packs four states into every 32 bit word, state of cell i is byte i % 4 of word
+ * i / 4 (little endian, same layout as the host array of states)
+ */
+using CellState = std::uint8_t;
+
+} // namespace CSIM::utils
+
+#endif // CELLSIM_CELL_STATE_HPP
@@ -1,16 +1,44 @@
 #version 450 core
 
-precision mediump float;
+precision highp float;
 
 layout(std140, binding = 0) uniform ViewConfig {
   vec2 offset;
   float scale;
   float aspect_ratio;
   vec4 out_line_color;
+  ivec2 map_resolution;
 };
 
+// lines are hidden on cells smaller than FADE_MIN_CELL_SIZE pixels and fully visible on cells
+// larger than FADE_MAX_CELL_SIZE pixels
+const float FADE_MIN_CELL_SIZE = 3.0;
+const float FADE_MAX_CELL_SIZE = 8.0;
+
+layout(location = 0) in vec2 in_screen_position;
+
 layout(location = 0) out vec4 out_fragment;
 
+// cell (x, y) is a unit quad centered at (x, -y), so lines lie at half integer coordinates, drawn
+// over a single triangle covering the viewport (see screen shader)
 void main() {
-  out_fragment = out_line_color;
+  vec2 screen_position = vec2(in_screen_position.x / aspect_ratio, in_screen_position.y);
+  vec2 position = (screen_position - offset) / scale;
+  position.y = -position.y;
+  // map coordinates covered by a pixel
+  vec2 pixel = fwidth(position);
+  if (any(lessThan(position, -0.5 - pixel)) ||
+      any(greaterThan(position, vec2(map_resolution) - 0.5 + pixel))) {
+    discard;
+  }
+
+  // distance to the closest line in pixels, coverage falls off over a pixel on both sides
+  vec2 line = fract(position - 0.5);
+  vec2 distance = min(line, 1.0 - line) / pixel;
+  float coverage = 1.0 - clamp(min(distance.x, distance.y), 0.0, 1.0);
+  float fade = smoothstep(FADE_MIN_CELL_SIZE, FADE_MAX_CELL_SIZE, 1.0 / max(pixel.x, pixel.y));
+  if (coverage * fade <= 0.0) {
+    discard;
+  }
+  out_fragment = vec4(out_line_color.rgb, out_line_color.a * coverage * fade);
 }
@@ -6,6 +6,14 @@ layout(std140, binding = 0) uniform ViewConfig {
   vec2 offset;
   float scale;
   float aspect_ratio;
+  vec4 out_line_color;
+  ivec2 map_resolution;
+  ivec2 visible_origin;
+  ivec2 visible_extent;
+  ivec2 lod_resolution;
+  int lod_level;
+  int lod_offset; // words
+  int lod_reduction;
 };
 
 const int MAX_COLORS = 256;
@@ -14,19 +22,48 @@ layout(std140, binding = 1) uniform Colors {
   vec4 colors[MAX_COLORS];
 };
 
+// states are bytes packed four per word, state of cell i is byte i % 4 of word i / 4
 layout(std430, binding = 2) readonly buffer StateMap {
-  int state_map[];
+  uint state_map[];
 };
 
-layout(std430, binding = 3) readonly buffer InstanceOffsets {
-  vec2 instance_offsets[];
+// reduced levels of the state map, level lod_level starts at word lod_offset
+layout(std430, binding = 10) readonly buffer LodPyramid {
+  uint levels[];
 };
 
+const int REDUCTION_DENSITY = 2;
+
+// cell of the drawn level, level 0 is the state map itself
+int readCell(int x, int y) {
+  if (lod_level == 0) {
+    int i = x + y * map_resolution.x;
+    return int(bitfieldExtract(state_map[i >> 2], 8 * (i & 3), 8));
+  }
+  int i = x + y * lod_resolution.x;
+  return int(bitfieldExtract(levels[lod_offset + (i >> 2)], 8 * (i & 3), 8));
+}
+
+// density levels hold the alive fraction of the cells instead of a state
+vec4 cellColor(int value) {
+  if (lod_level > 0 && lod_reduction == REDUCTION_DENSITY) {
+    return mix(colors[0], colors[1], float(value) / 255.0);
+  }
+  return colors[value];
+}
+
 layout(location = 2) flat out vec4 out_color;
 
+// instances cover only the visible rectangle of cells of the drawn level
 void main() {
-  out_color = colors[state_map[gl_InstanceIndex]];
-  vec2 position = scale * (in_position + instance_offsets[gl_InstanceIndex]) + offset;
+  int x = visible_origin.x + gl_InstanceIndex % visible_extent.x;
+  int y = visible_origin.y + gl_InstanceIndex / visible_extent.x;
+  out_color = cellColor(readCell(x, y));
+  // map cell (x, y) is drawn as a unit quad centered at (x, -y), cells of a reduced level cover
+  // 2^lod_level map cells on both axes
+  float size = float(1 << lod_level);
+  vec2 instance_offset = size * vec2(x, -y) + 0.5 * (size - 1.0) * vec2(1.0, -1.0);
+  vec2 position = scale * (size * in_position + instance_offset) + offset;
 
   gl_Position = vec4(aspect_ratio * position.x, position.y, 0.0, 1.0);
 }
@@ -0,0 +1,71 @@
+#version 450 core
+
+precision highp float;
+
+layout(std140, binding = 0) uniform ViewConfig {
+  vec2 offset;
+  float scale;
+  float aspect_ratio;
+  vec4 out_line_color;
+  ivec2 map_resolution;
+  ivec2 visible_origin;
+  ivec2 visible_extent;
+  ivec2 lod_resolution;
+  int lod_level;
+  int lod_offset; // words
+  int lod_reduction;
+};
+
+const int MAX_COLORS = 256;
+
+layout(std140, binding = 1) uniform Colors {
+  vec4 colors[MAX_COLORS];
+};
+
+// states are bytes packed four per word, state of cell i is byte i % 4 of word i / 4
+layout(std430, binding = 2) readonly buffer StateMap {
+  uint state_map[];
+};
+
+// reduced levels of the state map, level lod_level starts at word lod_offset
+layout(std430, binding = 10) readonly buffer LodPyramid {
+  uint levels[];
+};
+
+const int REDUCTION_DENSITY = 2;
+
+// cell of the drawn level, level 0 is the state map itself
+int readCell(int x, int y) {
+  if (lod_level == 0) {
+    int i = x + y * map_resolution.x;
+    return int(bitfieldExtract(state_map[i >> 2], 8 * (i & 3), 8));
+  }
+  int i = x + y * lod_resolution.x;
+  return int(bitfieldExtract(levels[lod_offset + (i >> 2)], 8 * (i & 3), 8));
+}
+
+// density levels hold the alive fraction of the cells instead of a state
+vec4 cellColor(int value) {
+  if (lod_level > 0 && lod_reduction == REDUCTION_DENSITY) {
+    return mix(colors[0], colors[1], float(value) / 255.0);
+  }
+  return colors[value];
+}
+
+layout(location = 0) in vec2 in_screen_position;
+
+layout(location = 0) out vec4 out_fragment;
+
+// inverse of the instanced render shader transform, cell (x, y) is a unit quad centered at (x, -y)
+void main() {
+  vec2 screen_position = vec2(in_screen_position.x / aspect_ratio, in_screen_position.y);
+  vec2 position = (screen_position - offset) / scale;
+  vec2 cell = floor(vec2(position.x, -position.y) + 0.5);
+  // fragments outside of the map keep the clear color
+  if (any(lessThan(cell, vec2(0.0))) || any(greaterThanEqual(cell, vec2(map_resolution)))) {
+    discard;
+  }
+  // cells of a reduced level cover 2^lod_level cells of the map on both axes
+  ivec2 level_cell = ivec2(cell) >> lod_level;
+  out_fragment = cellColor(readCell(level_cell.x, level_cell.y));
+}
@@ -0,0 +1,11 @@
+#version 450 core
+
+// single triangle covering the whole viewport, drawn without vertex attributes
+const vec2 POSITIONS[3] = vec2[](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+
+layout(location = 0) out vec2 out_screen_position;
+
+void main() {
+  out_screen_position = POSITIONS[gl_VertexIndex];
+  gl_Position = vec4(POSITIONS[gl_VertexIndex], 0.0, 1.0);
+}
@@ -4,21 +4,23 @@
 #include "app.hpp"
 #include "cli_emulator/cellsim_cli_emulator.hpp"
 
-#ifdef GL_DEBUG
 #include <glad/glad.h>
 #include <spdlog/spdlog.h>
-#endif
 
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include <imgui/imgui_utils.hpp>
+#include <profiler/performance_window.hpp>
 #include <rules/rule_info_window.hpp>
 
+#include <algorithm>
 #include <cstring>
 
 /// TODO add clear color to cellmap
 
 CSIM::App::App(Window &window) : window_(window) {
+	renderer_.profiler_ = &profiler_;
+	cell_map_.trace_ = &trace_;
 	renderer_.setColors({{0.f, 0.f, 0.f, 1.f}, {1.f, 1.f, 1.f, 1.f}});
 	window_.setScrollCallback([this](float offset) {
 		if (!is_viewport_win_focused_) {
@@ -63,6 +65,8 @@ CSIM::App::App(Window &window) : window_(window) {
 void CSIM::App::destroy() {
 	ImGui::Uninit();
 	renderer_.destroy();
+	profiler_.destroy();
+	trace_.destroy();
 	cell_map_.destroy();
 	if (rule_) {
 		rule_->destroy();
@@ -77,6 +81,28 @@ void CSIM::App::updateRuleConfig(std::shared_ptr<RuleConfig> config, RuleType ru
 		rule_config_->destroy();
 	}
 	rule_config_ = std::move(config);
+	rule_config_rule_type_ = rule_type;
+
+	/// cpu based backends replace rule types they have an engine for
+	if (backend_ != SimulationBackend::GPU &&
+			(rule_type == RuleType::BASIC_2D || rule_type == RuleType::BOX_SUM_2D)) {
+		rule_type = backend_ == SimulationBackend::HASH_LIFE &&
+												rule_config_->ruleConfigType() == RuleConfigType::LIFE_2D
+										? RuleType::HASH_LIFE_2D
+										: RuleType::CPU_2D;
+	} else if (backend_ != SimulationBackend::GPU &&
+						 (rule_type == RuleType::BASIC_1D || rule_type == RuleType::PREFIX_SUM_1D)) {
+		rule_type = RuleType::CPU_1D;
+	} else if (temporal_block_ > 1 && rule_type == RuleType::BASIC_2D) {
+		/// activity is tracked between single generations, blocked generations take precedence
+		rule_type = RuleType::TEMPORAL_2D;
+	} else if (active_tiles_ && rule_type == RuleType::BASIC_2D) {
+		rule_type = RuleType::ACTIVE_TILES_2D;
+	} else if (temporal_block_ > 1 && rule_type == RuleType::BOX_SUM_2D) {
+		/// kernel reach of box sum rules doesn't fit into the halo of the temporal shaders
+		spdlog::warn("box sum rules advance one generation per step, temporal block {} is ignored",
+								 temporal_block_);
+	}
 
 	if (rule_ == nullptr || rule_->ruleType() != rule_type) {
 		if (rule_ != nullptr) {
@@ -87,7 +113,30 @@ void CSIM::App::updateRuleConfig(std::shared_ptr<RuleConfig> config, RuleType ru
 			rule_ = std::make_shared<Rule1D>(rule_config_);
 			break;
 		case RuleType::BASIC_2D:
-			rule_ = std::make_shared<Rule2D>(rule_config_);
+			rule_ = std::make_shared<Rule2D>(rule_config_, shared_tiles_);
+			break;
+		case RuleType::ACTIVE_TILES_2D:
+			rule_ = std::make_shared<Rule2DActiveTiles>(rule_config_);
+			break;
+		case RuleType::TEMPORAL_2D:
+			rule_ = std::make_shared<Rule2DTemporal>(rule_config_, temporal_block_);
+			break;
+		case RuleType::BOX_SUM_2D:
+			rule_ = std::make_shared<Rule2DBoxSum>(rule_config_);
+			break;
+		case RuleType::PREFIX_SUM_1D:
+			rule_ = std::make_shared<Rule1DPrefixSum>(rule_config_);
+			break;
+		case RuleType::CPU_1D:
+			rule_ = std::make_shared<RuleCPU1D>(rule_config_, thread_pool_);
+			break;
+		case RuleType::CPU_2D:
+			rule_ = std::make_shared<RuleCPU2D>(rule_config_, thread_pool_, active_tiles_,
+																					temporal_block_);
+			break;
+		case RuleType::HASH_LIFE_2D:
+			rule_ = std::make_shared<RuleHashLife>(rule_config_, thread_pool_, hash_life_memory_budget_,
+																						 active_tiles_, temporal_block_);
 			break;
 		default:
 			break;
@@ -97,6 +146,18 @@ void CSIM::App::updateRuleConfig(std::shared_ptr<RuleConfig> config, RuleType ru
 	}
 }
 
+void CSIM::App::recreateRule() {
+	if (rule_ == nullptr || rule_config_ == nullptr) {
+		return;
+	}
+	rule_->destroy();
+	rule_ = nullptr;
+	/// rule config stays the same, only the rule running it is recreated
+	auto config = std::move(rule_config_);
+	rule_config_ = nullptr;
+	updateRuleConfig(std::move(config), rule_config_rule_type_);
+}
+
 static auto hexColorToFloatColor(std::uint32_t color) {
 	constexpr std::uint32_t MASK{0xFF};
 	constexpr float DIVIDER{255.f};
@@ -118,7 +179,39 @@ void CSIM::App::parseCommand() {
 			if (!args.toggle_option->empty()) {
 				renderer_.toggleGrid();
 			}
+		} else if (cli_emulator_.config.subcmd_backend->parsed()) {
+			const auto &args = cli_emulator_.config.options_backend;
+			if (!args.threads_option->empty() && args.threads != thread_pool_->threadCount()) {
+				thread_pool_ = std::make_shared<ThreadPool>(args.threads);
+			}
+			if (!args.memory_option->empty()) {
+				hash_life_memory_budget_ = args.memory << 20u;
+			}
+			active_tiles_ = !args.active_tiles->empty();
+			shared_tiles_ = !args.shared_tiles->empty();
+			temporal_block_ = args.temporal_block_option->empty() ? 1 : args.temporal_block;
+			if (args.backend == "cpu") {
+				backend_ = SimulationBackend::CPU;
+			} else if (args.backend == "hashlife") {
+				backend_ = SimulationBackend::HASH_LIFE;
+			} else {
+				backend_ = SimulationBackend::GPU;
+			}
+			recreateRule();
+		} else if (cli_emulator_.config.subcmd_speed->parsed()) {
+			const auto &args = cli_emulator_.config.options_speed;
+			if (!args.budget_option->empty()) {
+				step_budget_ = args.budget / 1000.f; // NOLINT milliseconds
+			}
+			if (!args.max_throughput->empty()) {
+				speed_mode_ = SpeedMode::MAX_THROUGHPUT;
+			} else if (!args.gens_option->empty()) {
+				speed_mode_ = SpeedMode::TARGET_RATE;
+				target_gens_per_second_ = args.gens;
+			}
+			generation_debt_ = 0.f;
 		} else if (cli_emulator_.config.subcmd_counter->parsed()) {
+			speed_mode_ = SpeedMode::FRAME_COUNTER;
 			step_size_ = static_cast<std::int32_t>(cli_emulator_.config.option_counter);
 			frame_counter_ = 0;
 		} else if (cli_emulator_.config.subcmd_cellmap->parsed()) {
@@ -132,38 +225,15 @@ void CSIM::App::parseCommand() {
 
 			renderer_.setColors(colors);
 		} else if (cli_emulator_.config.subcmd_rule->parsed()) {
-			if (cli_emulator_.config.subsubcmd_rule_1dtotalistic->parsed()) {
-				const auto &rule_args = cli_emulator_.config.options_1d_totalistic;
-				updateRuleConfig(std::make_shared<RuleConfig1DTotalistic>(
-														 rule_args.range, rule_args.exclude_center->empty(),
-														 rule_args.survival_conditions, rule_args.birth_conditions,
-														 std::make_shared<CShader>("shaders/bin/1D_totalistic/comp.spv")),
-												 RuleType::BASIC_1D);
-			} else if (cli_emulator_.config.subsubcmd_rule_1dbinary->parsed()) {
-				const auto &rule_args = cli_emulator_.config.options_1d_binary;
-				updateRuleConfig(std::make_shared<RuleConfig1DBinary>(
-														 rule_args.range, rule_args.pattern_match_code,
-														 std::make_shared<CShader>("shaders/bin/1D_binary/comp.spv")),
-												 RuleType::BASIC_1D);
-			} else if (cli_emulator_.config.subsubcmd_rule_2dcyclic->parsed()) {
-				const auto &rule_args = cli_emulator_.config.options_2d_cyclic;
-				updateRuleConfig(std::make_shared<RuleConfig2DCyclic>(
-														 rule_args.range, rule_args.threshold, !rule_args.moore->empty(),
-														 !rule_args.state_insensitive->empty(),
-														 rule_args.exclude_center->empty(),
-														 std::make_shared<CShader>("shaders/bin/2D_cyclic/comp.spv")),
-												 RuleType::BASIC_2D);
-			} else if (cli_emulator_.config.subsubcmd_rule_2dlife->parsed()) {
-				const auto &rule_args = cli_emulator_.config.options_2d_life;
-				updateRuleConfig(std::make_shared<RuleConfig2DLife>(
-														 !rule_args.moore->empty(), !rule_args.state_insensitive->empty(),
-														 rule_args.exclude_center->empty(), rule_args.survival_conditions,
-														 rule_args.birth_conditions,
-														 std::make_shared<CShader>("shaders/bin/2D_life/comp.spv")),
-												 RuleType::BASIC_2D);
+			auto config = cli_emulator_.config.options_rule.parsedRuleConfig(makeStepShader);
+			if (config != nullptr) {
+				const auto rule_type = gpuRuleType(*config);
+				updateRuleConfig(std::move(config), rule_type);
 			}
 		} else if (cli_emulator_.config.subcmd_clear_color->parsed()) {
 			renderer_.setClearColor(hexColorToFloatColor(cli_emulator_.config.option_clear_color));
+		} else if (cli_emulator_.config.subcmd_minimap->parsed()) {
+			renderer_.setMinimapRate(cli_emulator_.config.option_minimap_rate);
 		}
 	} else if (cli_emulator_.config.cmd_clear->parsed()) {
 		if (!cli_emulator_.config.options_clear.clear_cli->empty()) {
@@ -174,11 +244,42 @@ void CSIM::App::parseCommand() {
 		}
 	} else if (cli_emulator_.config.cmd_seed->parsed()) {
 		const auto args = cli_emulator_.config.options_seed;
+		const GPUProfiler::Zone zone(&profiler_, ProfilePhase::SEED);
 		cell_map_.seed(args.x, args.y, args.range, !args.round->empty(), !args.clip->empty());
 	} else if (cli_emulator_.config.cmd_stop->parsed()) {
 		simulation_stopped_ = true;
 	} else if (cli_emulator_.config.cmd_start->parsed()) {
 		simulation_stopped_ = false;
+	} else if (cli_emulator_.config.cmd_trace->parsed()) {
+		const auto &args = cli_emulator_.config.options_trace;
+		if (!args.frames_option->empty()) {
+			trace_.start(args.frames);
+		}
+		if (!args.stop->empty()) {
+			trace_.stop();
+		}
+		if (!args.output_option->empty()) {
+			try {
+				const auto events = trace_.writeChromeTrace(args.output);
+				spdlog::info("{} trace events written to {}", events, args.output);
+			} catch (const std::runtime_error &e) {
+				spdlog::error("{}", e.what());
+			}
+		}
+	} else if (cli_emulator_.config.cmd_jump->parsed()) {
+		const auto &args = cli_emulator_.config.options_jump;
+		const auto generations =
+				args.power_option->empty() ? args.generations : std::uint64_t{1} << args.power;
+		const auto jumped = rule_ != nullptr && rule_->ruleType() == RuleType::HASH_LIFE_2D &&
+												std::static_pointer_cast<RuleHashLife>(rule_)->jump(
+														cell_map_, static_cast<std::int32_t>(renderer_.colorCount()),
+														generations);
+		if (jumped) {
+			renderer_.markStatesChanged();
+		} else {
+			spdlog::warn("jump requires hashlife backend running 2 state 2dlife rule with range 1 "
+									 "kernel on a cellmap with power of two extents");
+		}
 	}
 }
 
@@ -204,31 +305,139 @@ static void makeBorder(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint
 	draw_list->AddRect(ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), IM_COL32(r, g, b, a));
 }
 
+/**
+ * @return cells updated by a generation, 1D rules update one row
+ */
+static std::uint64_t cellsPerGeneration(const CSIM::RuleConfig &rule_config,
+																				const CSIM::CellMap &cell_map) noexcept {
+	const auto type = rule_config.ruleConfigType();
+	const auto one_dimensional =
+			type == CSIM::RuleConfigType::TOTALISTIC_1D || type == CSIM::RuleConfigType::BINARY_1D;
+	return static_cast<std::uint64_t>(cell_map.width_) *
+				 static_cast<std::uint64_t>(one_dimensional ? 1 : cell_map.height_);
+}
+
+void CSIM::App::stepSimulation(float time_step) {
+	const auto state_count = static_cast<std::int32_t>(renderer_.colorCount());
+	if (speed_mode_ == SpeedMode::FRAME_COUNTER) {
+		if (++frame_counter_; frame_counter_ == step_size_) {
+			const auto iteration = rule_->iteration();
+			{
+				const GPUProfiler::Zone zone(&profiler_, ProfilePhase::STEP);
+				const TraceRecorder::Zone trace_zone(&trace_, "Rule::step", true);
+				rule_->step(cell_map_, state_count);
+			}
+			renderer_.markStatesChanged();
+			const auto generations = rule_->iteration() - iteration;
+			readout_generations_ += generations;
+			profiler_.addCellsUpdated(cellsPerGeneration(*rule_config_, cell_map_) *
+																static_cast<std::uint64_t>(generations));
+			frame_counter_ = 0;
+		}
+		return;
+	}
+
+	/// step time is taken from frames whose STEP queries were collected, the gpu is never waited for,
+	/// gpu time covers compute shaders, cpu time covers cpu engines and issuing the steps
+	constexpr float SMOOTHING{.2f};
+	const auto frame = profiler_.frameCount();
+	if (frame - measured_frame_ >= GPUProfiler::HISTORY_SIZE) {
+		measured_frame_ = frame - GPUProfiler::HISTORY_SIZE + 1;
+	}
+	const auto first_pending = profiler_.firstPendingFrame(ProfilePhase::STEP);
+	for (; measured_frame_ < first_pending; ++measured_frame_) {
+		const auto &batch = step_batches_[measured_frame_ % step_batches_.size()];
+		if (batch.frame != measured_frame_ || batch.steps == 0) {
+			continue;
+		}
+		const auto milliseconds =
+				std::max(profiler_.frameGPUMilliseconds(ProfilePhase::STEP, measured_frame_),
+								 profiler_.frameCPUMilliseconds(ProfilePhase::STEP, measured_frame_));
+		const auto seconds_per_step = milliseconds / 1000.f / static_cast<float>(batch.steps); // NOLINT
+		seconds_per_step_ = seconds_per_step_ > 0.f
+														? seconds_per_step_ + (seconds_per_step - seconds_per_step_) * SMOOTHING
+														: seconds_per_step;
+	}
+
+	/// steps which fit in the budget, at least one so that the step time keeps being measured
+	const auto budget_steps =
+			seconds_per_step_ > 0.f
+					? std::max(1, static_cast<std::int32_t>(step_budget_ / seconds_per_step_))
+					: 1;
+	auto steps = budget_steps;
+	if (speed_mode_ == SpeedMode::TARGET_RATE) {
+		generation_debt_ += time_step * target_gens_per_second_;
+		const auto due_steps = static_cast<std::int32_t>(generation_debt_ / generations_per_step_);
+		steps = std::min(budget_steps, due_steps);
+	}
+	if (steps == 0) {
+		return;
+	}
+
+	const auto iteration = rule_->iteration();
+	{
+		const GPUProfiler::Zone zone(&profiler_, ProfilePhase::STEP);
+		for (std::int32_t step = 0; step < steps; ++step) {
+			const TraceRecorder::Zone trace_zone(&trace_, "Rule::step", true);
+			rule_->step(cell_map_, state_count);
+		}
+	}
+	step_batches_[frame % step_batches_.size()] = {frame, steps};
+	renderer_.markStatesChanged();
+
+	const auto generations = rule_->iteration() - iteration;
+	readout_generations_ += generations;
+	profiler_.addCellsUpdated(cellsPerGeneration(*rule_config_, cell_map_) *
+														static_cast<std::uint64_t>(generations));
+	if (generations > 0) {
+		generations_per_step_ = static_cast<float>(generations) / static_cast<float>(steps);
+	}
+	if (speed_mode_ == SpeedMode::TARGET_RATE) {
+		generation_debt_ -= static_cast<float>(generations);
+		/// generations which didn't fit in the budget are dropped instead of piling up
+		generation_debt_ = std::min(generation_debt_, generations_per_step_);
+	}
+}
+
 void CSIM::App::run() {
 	while (!window_.shouldClose()) {
-		window_.pollEvents();
+		{
+			const TraceRecorder::Zone zone(&trace_, "Window::pollEvents");
+			window_.pollEvents();
+		}
 
 		auto frame_time = window_.getTime();
 		renderer_.time_step_ = frame_time - last_frame_time_;
 		last_frame_time_ = frame_time;
+		profiler_.endFrame(renderer_.time_step_);
 
 		static ImVec2 viewport_win_size{120.F, 90.F};
 
-		renderer_.draw(
-			{
-				static_cast<int>(viewport_win_size.x),
-				static_cast<int>(viewport_win_size.y)
-			},
-			cell_map_
-		);
+		{
+			const TraceRecorder::Zone zone(&trace_, "Renderer::draw", true);
+			renderer_.draw(
+				{
+					static_cast<int>(viewport_win_size.x),
+					static_cast<int>(viewport_win_size.y)
+				},
+				cell_map_
+			);
+		}
+
+		/// achieved rate is averaged over half a second so that the readout stays legible
+		constexpr float READOUT_PERIOD{.5f};
+		readout_elapsed_ += renderer_.time_step_;
+		if (readout_elapsed_ >= READOUT_PERIOD) {
+			gens_per_second_ = static_cast<float>(readout_generations_) / readout_elapsed_;
+			readout_generations_ = 0;
+			readout_elapsed_ = 0.f;
+		}
 
 		ImGui::BeginFrameCustom();
+		CSIM::drawPerformanceWindow(profiler_);
 		if (rule_ != nullptr && rule_config_ != nullptr) {
 			if (!simulation_stopped_) {
-				if (++frame_counter_; frame_counter_ == step_size_) {
-					rule_->step(cell_map_, static_cast<std::int32_t>(renderer_.colorCount()));
-					frame_counter_ = 0;
-				}
+				stepSimulation(renderer_.time_step_);
 			}
 			CSIM::drawRuleInfoWindow(rule_, rule_config_);
 		}
@@ -256,9 +465,13 @@ void CSIM::App::run() {
 			ImGui::DockSpace(dockspace_id, ImVec2(.0F, .0F), 0);
 		}
 
-		if (cli_emulator_.draw(window_.getKeyState(GLFW_KEY_ENTER) == GLFW_PRESS,
-													 window_.getKeyState(GLFW_KEY_BACKSPACE) == GLFW_PRESS)) {
-			parseCommand();
+		{
+			const TraceRecorder::Zone zone(&trace_, "CLIEmulator::draw");
+			if (cli_emulator_.draw(window_.getKeyState(GLFW_KEY_ENTER) == GLFW_PRESS,
+														 window_.getKeyState(GLFW_KEY_BACKSPACE) == GLFW_PRESS)) {
+				const TraceRecorder::Zone parse_zone(&trace_, "App::parseCommand");
+				parseCommand();
+			}
 		}
 
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, .0F);
@@ -299,7 +512,21 @@ void CSIM::App::run() {
 		ImGui::Text("window width :: %i", static_cast<int>(viewport_win_size.x));
 		ImGui::Text("window height :: %i", static_cast<int>(viewport_win_size.y));
 		ImGui::Text("FPS :: %i", static_cast<std::int32_t>(1.f / renderer_.time_step_));
+		ImGui::Text("Gens/s :: %.0f", static_cast<double>(gens_per_second_));
 		ImGui::Text("Counter :: %i", frame_counter_);
+		if (backend_ != SimulationBackend::GPU && thread_pool_->wallTime() > 0) {
+			const auto wall_time = static_cast<double>(thread_pool_->wallTime());
+			const auto stats = thread_pool_->workerStats();
+			for (std::size_t worker = 0; worker < stats.size(); ++worker) {
+				ImGui::Text("worker %zu :: %3.0f%% busy, %llu steals", worker,
+										100.0 * static_cast<double>(stats[worker].busy_ns) / wall_time,
+										static_cast<unsigned long long>(stats[worker].steals));
+			}
+			/// counters cover roughly the last second of simulation
+			if (thread_pool_->wallTime() > 1'000'000'000ull) {
+				thread_pool_->resetStats();
+			}
+		}
 
 		ImGui::Separator();
 		ImGui::Separator();
@@ -332,6 +559,21 @@ void CSIM::App::run() {
 
 		ImGui::LabelText("##cosmetic-options", "Cosmetic options"); makeBorder(255, 255, 0, 255);
 
+		bool instanced = renderer_.render_mode_ == RenderMode::INSTANCED;
+		if (ImGui::Checkbox("Instanced rendering", &instanced)) {
+			renderer_.render_mode_ = instanced ? RenderMode::INSTANCED : RenderMode::SCREEN;
+		}
+		ImGui::SameLine();
+		HelpMarker("Draw a quad per cell instead of a single full screen pass");
+
+		ImGui::Checkbox("Level of detail", &renderer_.lod_on_);
+		ImGui::SameLine();
+		HelpMarker("Draw reduced levels of the map when cells are smaller than a pixel");
+		auto lod_reduction = static_cast<int>(renderer_.lod_reduction_);
+		if (ImGui::Combo("LOD reduction", &lod_reduction, "Max\0Majority\0Density\0")) {
+			renderer_.setLodReduction(static_cast<LodReduction>(lod_reduction));
+		}
+
 		ImGui::Checkbox("Grid on/off", &renderer_.grid_on_);
 		ImGui::ColorPicker4("Grid color", &renderer_.view_config_.outline_color.x);
 
@@ -386,6 +628,7 @@ void CSIM::App::run() {
 					path.cbegin(),
 					std::next(path.cbegin(), std::strlen(path.data()))
 				);
+				const GPUProfiler::Zone zone(&profiler_, ProfilePhase::READBACK);
 				if (!cell_map_.saveTextureToFile(fs_path)) {
 					open_error_save_img_popup = true;
 				}
@@ -465,7 +708,10 @@ void CSIM::App::run() {
 		ImGui::End(); // docking space
 		/// NOLINTEND
 
-		ImGui::EndFrameCustom();
+		{
+			const TraceRecorder::Zone zone(&trace_, "ImGui::EndFrameCustom", true);
+			ImGui::EndFrameCustom();
+		}
 
 		/// seeding with mouse button left
 		if (window_.getKeyState(GLFW_KEY_S) == GLFW_PRESS) {
@@ -502,6 +748,7 @@ void CSIM::App::run() {
 						const auto cell_x = static_cast<std::size_t>(mouse_pos_grid_x / grid_cell_size.x);
 						const auto cell_y = static_cast<std::size_t>(mouse_pos_grid_y / grid_cell_size.y);
 
+						const GPUProfiler::Zone zone(&profiler_, ProfilePhase::SEED);
 						cell_map_.seed(
 							cell_x,
 							cell_y,
@@ -514,6 +761,10 @@ void CSIM::App::run() {
 			}
 		}
 
-		window_.swapBuffers();
+		{
+			const TraceRecorder::Zone zone(&trace_, "Window::swapBuffers");
+			window_.swapBuffers();
+		}
+		trace_.endFrame();
 	}
 }
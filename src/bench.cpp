@@ -0,0 +1,457 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <fmt/format.h>
+#include <project_config/config.hpp>
+#include <spdlog/spdlog.h>
+
+#include <cpu/cpu_engine.hpp>
+#include <cpu/hash_life.hpp>
+#include <cpu/thread_pool.hpp>
+#include <rules/rule_config.hpp>
+
+#ifdef BENCH_GPU
+#include <glad/glad.h>
+
+#include <cellmap/cellmap.hpp>
+#include <rules/rule.hpp>
+#include <window/window.hpp>
+#endif
+
+/// benchmark sweeps every rule config over map sizes, ranges and state counts on the available
+/// backends and writes the measured throughput as json, so kernel changes can be compared between
+/// builds. Bandwidth is the effective one: every updated cell is read and written once per
+/// generation, traffic of neighbourhood reads and intermediate buffers isn't counted
+
+struct BenchOptions {
+	std::int32_t min_size{256};		/*!< extent of the smallest map, extents double up to max_size */
+	std::int32_t max_size{16384}; /*!< extent of the largest map */
+	double min_time{.5};					/*!< seconds every case is timed for at least */
+	std::vector<std::string> rules{"1D_totalistic", "1D_binary", "2D_cyclic", "2D_life"};
+#ifdef BENCH_GPU
+	std::vector<std::string> backends{"cpu", "gpu"};
+#else
+	std::vector<std::string> backends{"cpu"};
+#endif
+	std::filesystem::path output{"cellsim_bench.json"};
+	std::uint64_t seed{1};
+	std::uint32_t threads{0};
+	CLI::Option *threads_option;
+};
+
+/**
+ * point of the sweep, configs are created per backend since gpu configs carry step shaders
+ */
+struct BenchCase {
+	std::string_view rule;
+	CSIM::RuleConfigType config_type;
+	std::int32_t state_count;
+	std::function<std::shared_ptr<CSIM::RuleConfig>(std::shared_ptr<CSIM::Shader>)> make_config;
+};
+
+struct BenchResult {
+	std::string_view rule;
+	std::string_view backend;
+	CSIM::Vec2<std::int32_t> resolution;
+	std::int32_t state_count;
+	std::vector<std::pair<std::string, std::string>> config; /*!< serialized rule config */
+	std::uint64_t generations;
+	double seconds;
+	std::size_t cells_per_generation; /*!< 1D rules update one row per generation */
+};
+
+/**
+ * @return cases of the selected rules, every range with every state count
+ */
+static std::vector<BenchCase> benchCases(const BenchOptions &options) {
+	const auto selected = [&options](std::string_view rule) {
+		return std::find(options.rules.begin(), options.rules.end(), rule) != options.rules.end();
+	};
+	constexpr std::array<std::int32_t, 2> STATE_COUNTS{2, 8};
+	std::vector<BenchCase> cases;
+
+	if (selected("1D_totalistic")) {
+		for (const std::int32_t range : {1, 8, 64, 512}) { // NOLINT
+			/// cells with about half of the neighbourhood alive survive or are born, so rows neither die
+			/// out nor fill up
+			std::vector<std::size_t> conditions;
+			for (auto sum = static_cast<std::size_t>(range / 2 + 1);
+					 sum <= static_cast<std::size_t>(range + 1); ++sum) {
+				conditions.push_back(sum);
+			}
+			for (const auto state_count : STATE_COUNTS) {
+				cases.push_back({"1D_totalistic", CSIM::RuleConfigType::TOTALISTIC_1D, state_count,
+												 [range, conditions](auto shader) {
+													 return std::make_shared<CSIM::RuleConfig1DTotalistic>(
+															 range, true, conditions, conditions, std::move(shader));
+												 }});
+			}
+		}
+	}
+	if (selected("1D_binary")) {
+		std::mt19937_64 generator{options.seed};
+		for (std::int32_t range = 1;
+				 range <= static_cast<std::int32_t>(CSIM::RuleConfig1DBinary::RANGE_LIM.y); ++range) {
+			/// random code with a bit for every pattern of 2 * range + 1 cells
+			std::string pattern_match_code(std::size_t{1} << static_cast<std::size_t>(2 * range + 1),
+																		 '0');
+			std::generate(pattern_match_code.begin(), pattern_match_code.end(),
+										[&generator] { return (generator() & 1u) != 0 ? '1' : '0'; });
+			for (const auto state_count : STATE_COUNTS) {
+				cases.push_back({"1D_binary", CSIM::RuleConfigType::BINARY_1D, state_count,
+												 [range, pattern_match_code](auto shader) {
+													 return std::make_shared<CSIM::RuleConfig1DBinary>(
+															 range, pattern_match_code, std::move(shader));
+												 }});
+			}
+		}
+	}
+	if (selected("2D_cyclic")) {
+		for (const std::int32_t range : {1, 2, 4, 8}) { // NOLINT
+			/// 3/8 of the moore neighbourhood, classic cyclic threshold 3 for range 1
+			const auto threshold = ((2 * range + 1) * (2 * range + 1) - 1) * 3 / 8; // NOLINT
+			/// state insensitive kernels run on the box sum engines
+			for (const bool state_insensitive : {false, true}) {
+				for (const auto state_count : STATE_COUNTS) {
+					cases.push_back({"2D_cyclic", CSIM::RuleConfigType::CYCLIC_2D, state_count,
+													 [range, threshold, state_insensitive](auto shader) {
+														 return std::make_shared<CSIM::RuleConfig2DCyclic>(
+																 range, threshold, true, state_insensitive, false,
+																 std::move(shader));
+													 }});
+				}
+			}
+		}
+	}
+	if (selected("2D_life")) {
+		for (const auto state_count : STATE_COUNTS) {
+			/// conway's life, with more states dying cells decay (generations rules)
+			cases.push_back({"2D_life", CSIM::RuleConfigType::LIFE_2D, state_count, [](auto shader) {
+												 return std::make_shared<CSIM::RuleConfig2DLife>(
+														 true, false, false, std::vector<std::size_t>{2, 3},
+														 std::vector<std::size_t>{3}, std::move(shader));
+											 }});
+		}
+	}
+	return cases;
+}
+
+/**
+ * @return true if config is a 1D rule, rows of the map are then its generations
+ */
+static bool isOneDimensional(const CSIM::RuleConfig &rule_config) noexcept {
+	return rule_config.ruleConfigType() == CSIM::RuleConfigType::TOTALISTIC_1D ||
+				 rule_config.ruleConfigType() == CSIM::RuleConfigType::BINARY_1D;
+}
+
+/**
+ * fills half of the cells with alive cells at random, 1D rules get only their first row filled
+ */
+static void seedStates(std::vector<CSIM::CellState> &states, CSIM::Vec2<std::int32_t> resolution,
+											 bool one_dimensional, std::uint64_t seed) {
+	std::mt19937_64 generator{seed};
+	std::fill(states.begin(), states.end(), CSIM::CellState{0});
+	const auto cell_count = static_cast<std::size_t>(resolution.x) *
+													static_cast<std::size_t>(one_dimensional ? 1 : resolution.y);
+	std::generate_n(states.begin(), cell_count,
+									[&generator] { return static_cast<CSIM::CellState>(generator() & 1u); });
+}
+
+/**
+ * times advance in doubling batches until the timed generations took at least min_time, first
+ * generation warms up caches, lookup tables and shader pipelines and isn't timed
+ * @param advance advances states by passed number of generations (second argument) starting
+ * from passed generation (first argument)
+ * @param sync waits until the advanced generations are computed
+ * @return number of timed generations and seconds they took
+ */
+static std::pair<std::uint64_t, double>
+measure(double min_time, const std::function<void(std::uint64_t, std::uint64_t)> &advance,
+				const std::function<void()> &sync) {
+	constexpr std::uint64_t MAX_BATCH{1u << 24u};
+	advance(0, 1);
+	sync();
+	std::uint64_t generation{1};
+	std::uint64_t batch{1};
+	double seconds{0.};
+	while (seconds < min_time) {
+		const auto start = std::chrono::steady_clock::now();
+		advance(generation, batch);
+		sync();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		seconds += elapsed.count();
+		generation += batch;
+		batch = std::min(batch * 2, MAX_BATCH);
+	}
+	return {generation - 1, seconds};
+}
+
+/**
+ * runs the case on the cpu engines or hashlife
+ * @return result or nullopt if backend doesn't support the case
+ */
+static std::optional<BenchResult> runOnCPU(const BenchOptions &options, const BenchCase &bench_case,
+																					 std::string_view backend,
+																					 std::vector<CSIM::CellState> &states,
+																					 CSIM::Vec2<std::int32_t> resolution,
+																					 const std::shared_ptr<CSIM::ThreadPool> &thread_pool) {
+	const auto rule_config = bench_case.make_config(nullptr);
+	const auto one_dimensional = isOneDimensional(*rule_config);
+	seedStates(states, resolution, one_dimensional, options.seed);
+
+	std::pair<std::uint64_t, double> measured;
+	if (backend == "hashlife") {
+		if (!CSIM::HashLife::supports(*rule_config, bench_case.state_count, resolution)) {
+			return std::nullopt;
+		}
+		CSIM::HashLife hash_life(*rule_config);
+		measured = measure(
+				options.min_time,
+				[&](std::uint64_t, std::uint64_t batch) { hash_life.advanceBy(states, resolution, batch); },
+				[] {});
+	} else {
+		const auto engine = CSIM::makeCPUEngine(*rule_config, bench_case.state_count, thread_pool);
+		if (engine == nullptr) {
+			return std::nullopt;
+		}
+		/// only the row which 1D rules read depends on the iteration
+		const auto height = static_cast<std::uint64_t>(resolution.y);
+		measured = measure(
+				options.min_time,
+				[&](std::uint64_t generation, std::uint64_t batch) {
+					engine->run(states, resolution, bench_case.state_count,
+											static_cast<std::int32_t>(generation % height),
+											static_cast<std::int32_t>(batch));
+				},
+				[] {});
+	}
+
+	return BenchResult{bench_case.rule,
+										 backend,
+										 resolution,
+										 bench_case.state_count,
+										 rule_config->configSerialized(),
+										 measured.first,
+										 measured.second,
+										 static_cast<std::size_t>(resolution.x) *
+												 static_cast<std::size_t>(one_dimensional ? 1 : resolution.y)};
+}
+
+#ifdef BENCH_GPU
+/**
+ * runs the case with compute shaders in the offscreen context, finishing the queued commands ends
+ * every timed batch so the state map isn't downloaded
+ * @return result or nullopt if state map exceeds the shader storage block size
+ */
+static std::optional<BenchResult> runOnGPU(const BenchOptions &options, const BenchCase &bench_case,
+																					 CSIM::Vec2<std::int32_t> resolution) {
+	GLint max_block_size{0};
+	glGetIntegerv(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &max_block_size);
+	if (static_cast<std::size_t>(resolution.x) * static_cast<std::size_t>(resolution.y) *
+					sizeof(CSIM::CellState) >
+			static_cast<std::size_t>(max_block_size)) {
+		return std::nullopt;
+	}
+
+	CSIM::CellMap cell_map(static_cast<std::size_t>(resolution.x),
+												 static_cast<std::size_t>(resolution.y));
+	const auto rule_config = bench_case.make_config(CSIM::makeStepShader(bench_case.config_type));
+	const auto one_dimensional = isOneDimensional(*rule_config);
+	seedStates(cell_map.cell_states_, resolution, one_dimensional, options.seed);
+	cell_map.uploadStates();
+	const auto rule = CSIM::makeGPURule(rule_config, false);
+
+	const auto measured = measure(
+			options.min_time,
+			[&](std::uint64_t, std::uint64_t batch) {
+				for (std::uint64_t step = 0; step < batch; ++step) {
+					rule->step(cell_map, bench_case.state_count);
+				}
+			},
+			[] { glFinish(); });
+
+	BenchResult result{bench_case.rule,
+										 "gpu",
+										 resolution,
+										 bench_case.state_count,
+										 rule_config->configSerialized(),
+										 measured.first,
+										 measured.second,
+										 static_cast<std::size_t>(resolution.x) *
+												 static_cast<std::size_t>(one_dimensional ? 1 : resolution.y)};
+	rule->destroy();
+	rule_config->destroy();
+	cell_map.destroy();
+	return result;
+}
+#endif
+
+/**
+ * writes results as json, rates are per second, bandwidth is in GB/s (10^9 bytes)
+ */
+static void writeResults(const BenchOptions &options, std::string_view device,
+												 std::size_t thread_count, const std::vector<BenchResult> &results) {
+	std::ofstream file(options.output);
+	if (!file) {
+		throw std::runtime_error(fmt::format("can't open {} for writing", options.output.string()));
+	}
+	file << fmt::format("{{\n  \"version\": \"{}\",\n  \"git_sha\": \"{}\",\n  \"threads\": {},\n"
+											"  \"gpu\": \"{}\",\n  \"min_time\": {},\n  \"results\": [",
+											CSIM::cmake::config::project_version, CSIM::cmake::config::git_sha,
+											thread_count, device, options.min_time);
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const auto &result = results[i];
+		const auto gens_per_second = static_cast<double>(result.generations) / result.seconds;
+		const auto cells_per_second =
+				gens_per_second * static_cast<double>(result.cells_per_generation);
+		const auto bytes_per_second = 2. * cells_per_second * sizeof(CSIM::CellState);
+
+		std::string config;
+		for (const auto &[name, value] : result.config) {
+			config += fmt::format("{}\"{}\": \"{}\"", config.empty() ? "" : ", ", name, value);
+		}
+		file << fmt::format("{}\n    {{\"rule\": \"{}\", \"backend\": \"{}\", \"width\": {}, "
+												"\"height\": {}, \"states\": {}, \"config\": {{{}}}, \"generations\": {}, "
+												"\"seconds\": {:.6f}, \"gens_per_second\": {:.3f}, "
+												"\"cells_per_second\": {:.0f}, \"bandwidth_gb_per_second\": {:.3f}}}",
+												i == 0 ? "" : ",", result.rule, result.backend, result.resolution.x,
+												result.resolution.y, result.state_count, config, result.generations,
+												result.seconds, gens_per_second, cells_per_second, bytes_per_second * 1e-9);
+	}
+	file << "\n  ]\n}\n";
+	if (!file) {
+		throw std::runtime_error(fmt::format("can't write {}", options.output.string()));
+	}
+}
+
+static void runBench(const BenchOptions &options) {
+	const auto cases = benchCases(options);
+	const auto thread_pool = options.threads_option->empty()
+															 ? std::make_shared<CSIM::ThreadPool>()
+															 : std::make_shared<CSIM::ThreadPool>(options.threads);
+	const auto uses = [&options](std::string_view backend) {
+		return std::find(options.backends.begin(), options.backends.end(), backend) !=
+					 options.backends.end();
+	};
+
+	std::string device;
+#ifdef BENCH_GPU
+	std::optional<CSIM::Window> window;
+	if (uses("gpu")) {
+		window.emplace(options.max_size, options.max_size, "cellsim bench");
+		window->loadGL();
+		device = reinterpret_cast<const char *>(glGetString(GL_RENDERER)); // NOLINT
+	}
+#endif
+
+	std::vector<BenchResult> results;
+	std::vector<CSIM::CellState> states;
+	for (auto size = options.min_size; size <= options.max_size; size *= 2) {
+		const CSIM::Vec2<std::int32_t> resolution{size, size};
+		for (const auto &bench_case : cases) {
+			for (const auto &backend : options.backends) {
+				std::optional<BenchResult> result;
+#ifdef BENCH_GPU
+				if (backend == "gpu") {
+					result = runOnGPU(options, bench_case, resolution);
+				}
+#endif
+				if (backend != "gpu") {
+					states.resize(static_cast<std::size_t>(size) * static_cast<std::size_t>(size));
+					result = runOnCPU(options, bench_case, backend, states, resolution, thread_pool);
+				}
+				if (!result.has_value()) {
+					spdlog::warn("[cellsim-bench] {} {} {}x{} states {} isn't supported, skipped",
+											 bench_case.rule, backend, size, size, bench_case.state_count);
+					continue;
+				}
+				std::string config;
+				for (const auto &[name, value] : result->config) {
+					config += fmt::format(", {} {}", name, value);
+				}
+				const auto gens_per_second = static_cast<double>(result->generations) / result->seconds;
+				spdlog::info("[cellsim-bench] {} {} {}x{} states {}{}: {:.1f} gens/s, {:.3e} cells/s",
+										 bench_case.rule, backend, size, size, bench_case.state_count, config,
+										 gens_per_second,
+										 gens_per_second * static_cast<double>(result->cells_per_generation));
+				results.push_back(std::move(*result));
+			}
+		}
+	}
+
+#ifdef BENCH_GPU
+	if (window.has_value()) {
+		window->destroy();
+	}
+#endif
+	writeResults(options, device, uses("cpu") || uses("hashlife") ? thread_pool->threadCount() : 0,
+							 results);
+	spdlog::info("[cellsim-bench] {} results written to {}", results.size(),
+							 options.output.string());
+}
+
+int main(int argc, char **argv) {
+	CLI::App parser{"cellsim benchmark, sweeps rule configs over map sizes, ranges and state counts "
+									"on the available backends and writes cells/s, generations/s and effective "
+									"memory bandwidth as json"};
+	BenchOptions options;
+	parser
+			.add_option("--min-size", options.min_size,
+									"smallest map extent, sizes double up to max size (default = 256)")
+			->check(CLI::Range(1, 1 << 16)); // NOLINT
+	parser
+			.add_option("--max-size", options.max_size, "largest map extent (default = 16384)")
+			->check(CLI::Range(1, 1 << 16)); // NOLINT
+	parser
+			.add_option("--min-time", options.min_time,
+									"seconds every case is timed for at least (default = 0.5)")
+			->check(CLI::Range(0., 3600.)); // NOLINT
+	parser
+			.add_option("-r,--rules", options.rules,
+									"rule configs to sweep (default = all)")
+			->check(CLI::IsMember({"1D_totalistic", "1D_binary", "2D_cyclic", "2D_life"}));
+#ifdef BENCH_GPU
+	parser
+			.add_option("-b,--backends", options.backends,
+									"cpu, hashlife (2 state 2D_life only) or gpu (offscreen GL context), "
+									"(default = cpu gpu)")
+			->check(CLI::IsMember({"cpu", "hashlife", "gpu"}));
+#else
+	parser
+			.add_option("-b,--backends", options.backends,
+									"cpu or hashlife (2 state 2D_life only), (default = cpu)")
+			->check(CLI::IsMember({"cpu", "hashlife"}));
+#endif
+	parser.add_option("-o,--output", options.output,
+										"json results (default = cellsim_bench.json)");
+	parser.add_option("-s,--seed", options.seed, "seed of the random initial states (default = 1)");
+	options.threads_option =
+			parser
+					.add_option("-t,--threads", options.threads,
+											"number of cpu backend threads (default = number of hardware threads)")
+					->check(CLI::Range(1u, 1024u));
+
+	CLI11_PARSE(parser, argc, argv);
+
+	try {
+		runBench(options);
+	} catch (const std::exception &ex) {
+		spdlog::critical("[cellsim-bench] {}", ex.what());
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
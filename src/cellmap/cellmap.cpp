@@ -2,6 +2,7 @@
 // Created by reg on 7/29/22.
 //
 #include "cellmap/cellmap.hpp"
+#include "profiler/trace_recorder.hpp"
 
 #include <algorithm>
 #include <array>
@@ -15,35 +16,27 @@
 CSIM::CellMap::CellMap(std::size_t width, std::size_t height)
 		: width_(width), height_(height),
 			fbo_(static_cast<std::int32_t>(width), static_cast<std::int32_t>(height)),
-			cell_offsets_(width * height), cell_states_(width * height, 0) {
-	generateOffsets();
-
+			cell_states_(width * height, 0) {
 	std::array<GLuint, 2> buffers; // NOLINT
 	glCreateBuffers(buffers.size(), buffers.data());
-	instance_offsets_ssbo_id_ = buffers[0];
-	state_map_ssbo_id_ = buffers[1];
+	state_map_ssbo_id_ = buffers[0];
+	back_state_map_ssbo_id_ = buffers[1];
 
 	// set up ssbos
-	glNamedBufferStorage(instance_offsets_ssbo_id_,
-											 static_cast<GLsizei>(cell_offsets_.size() * sizeof(Vec2<float>)),
-											 cell_offsets_.data(), 0); // NOLINT no flags = readonly
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_OFFSETS_SSBO_BINDING_LOCATION,
-									 instance_offsets_ssbo_id_);
-
-	glNamedBufferStorage(state_map_ssbo_id_,
-											 static_cast<GLsizei>(cell_states_.size() * sizeof(std::int32_t)),
-											 cell_states_.data(), GL_DYNAMIC_STORAGE_BIT);
+	/// padding bytes of the last word are cleared once, uploads never reach them
+	for (const auto id : {state_map_ssbo_id_, back_state_map_ssbo_id_}) {
+		glNamedBufferStorage(id, static_cast<GLsizeiptr>(stateMapSize()), nullptr,
+												 GL_DYNAMIC_STORAGE_BIT);
+		glClearNamedBufferData(id, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+	}
+	uploadStates();
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, STATE_MAP_SSBO_BINDING_LOCATION,
 									 state_map_ssbo_id_);
 }
 
 void CSIM::CellMap::seed(std::size_t x, std::size_t y, std::size_t range, bool round,
 												 bool clip) noexcept {
-	std::fill(cell_states_.begin(), cell_states_.end(), 0);
-	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-	glGetNamedBufferSubData(state_map_ssbo_id_, 0,
-													static_cast<GLsizei>(cell_states_.size() * sizeof(std::int32_t)),
-													cell_states_.data());
+	downloadStates();
 	if (!round) {
 		std::int64_t begin_x{0};
 		std::int64_t end_x{0};
@@ -126,9 +119,8 @@ void CSIM::CellMap::seed(std::size_t x, std::size_t y, std::size_t range, bool r
 		}
 	}
 
-	glNamedBufferSubData(state_map_ssbo_id_, 0,
-											 static_cast<GLsizei>(cell_states_.size() * sizeof(std::int32_t)),
-											 cell_states_.data());
+	uploadStates();
+	++states_version_;
 }
 
 void CSIM::CellMap::extend(std::size_t new_width, std::size_t new_height, bool preserve_contents) {
@@ -137,11 +129,12 @@ void CSIM::CellMap::extend(std::size_t new_width, std::size_t new_height, bool p
 	}
 
 	{
-		std::vector<std::int32_t> new_cell_states(new_width * new_height, 0);
+		std::vector<CellState> new_cell_states(new_width * new_height, 0);
 		if (preserve_contents) {
 			std::fill(cell_states_.begin(), cell_states_.end(), 0);
 			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-			glGetNamedBufferSubData(state_map_ssbo_id_, 0, static_cast<GLsizei>(width_ * height_),
+			glGetNamedBufferSubData(state_map_ssbo_id_, 0,
+															static_cast<GLsizeiptr>(cell_states_.size() * sizeof(CellState)),
 															cell_states_.data());
 			for (std::size_t y = 0; y < std::clamp(height_, static_cast<std::size_t>(0), new_height);
 					 ++y) {
@@ -156,46 +149,55 @@ void CSIM::CellMap::extend(std::size_t new_width, std::size_t new_height, bool p
 	width_ = new_width;
 	height_ = new_height;
 
-	cell_offsets_.resize(new_width * new_height);
-	generateOffsets();
-
 	fbo_.resize(static_cast<std::int32_t>(new_width), static_cast<std::int32_t>(new_height));
 	std::array<GLuint, 2> buffers; // NOLINT
-	buffers[0] = instance_offsets_ssbo_id_;
-	buffers[1] = state_map_ssbo_id_;
+	buffers[0] = state_map_ssbo_id_;
+	buffers[1] = back_state_map_ssbo_id_;
 
 	glDeleteBuffers(buffers.size(), buffers.data());
 
 	glCreateBuffers(buffers.size(), buffers.data());
-	instance_offsets_ssbo_id_ = buffers[0];
-	state_map_ssbo_id_ = buffers[1];
+	state_map_ssbo_id_ = buffers[0];
+	back_state_map_ssbo_id_ = buffers[1];
 
 	// set up ssbos
-	glNamedBufferStorage(instance_offsets_ssbo_id_,
-											 static_cast<GLsizei>(cell_offsets_.size() * sizeof(Vec2<float>)),
-											 cell_offsets_.data(), 0); // NOLINT no flags = readonly
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_OFFSETS_SSBO_BINDING_LOCATION,
-									 instance_offsets_ssbo_id_);
-	glNamedBufferStorage(state_map_ssbo_id_,
-											 static_cast<GLsizei>(cell_states_.size() * sizeof(std::int32_t)),
-											 cell_states_.data(), GL_DYNAMIC_STORAGE_BIT);
+	/// padding bytes of the last word are cleared once, uploads never reach them
+	for (const auto id : {state_map_ssbo_id_, back_state_map_ssbo_id_}) {
+		glNamedBufferStorage(id, static_cast<GLsizeiptr>(stateMapSize()), nullptr,
+												 GL_DYNAMIC_STORAGE_BIT);
+		glClearNamedBufferData(id, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+	}
+	uploadStates();
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, STATE_MAP_SSBO_BINDING_LOCATION,
 									 state_map_ssbo_id_);
+	++states_version_;
 }
 
 void CSIM::CellMap::clear() {
 	std::fill(cell_states_.begin(), cell_states_.end(), 0);
+	uploadStates();
+	++states_version_;
+}
+
+void CSIM::CellMap::downloadStates() noexcept {
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	glGetNamedBufferSubData(state_map_ssbo_id_, 0,
+													static_cast<GLsizeiptr>(cell_states_.size() * sizeof(CellState)),
+													cell_states_.data());
+}
+
+void CSIM::CellMap::uploadStates() noexcept {
 	glNamedBufferSubData(state_map_ssbo_id_, 0,
-											 static_cast<GLsizei>(cell_states_.size() * sizeof(std::int32_t)),
+											 static_cast<GLsizeiptr>(cell_states_.size() * sizeof(CellState)),
 											 cell_states_.data());
 }
 
-void CSIM::CellMap::generateOffsets() noexcept {
-	for (auto y = 0ul; y < height_; ++y) {
-		for (auto x = 0ul; x < width_; ++x) {
-			cell_offsets_.at(x + y * width_) = {static_cast<float>(x), -static_cast<float>(y)};
-		}
-	}
+void CSIM::CellMap::swapStateMaps() noexcept {
+	std::swap(state_map_ssbo_id_, back_state_map_ssbo_id_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, STATE_MAP_SSBO_BINDING_LOCATION,
+									 state_map_ssbo_id_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, STATE_MAP_COPY_SSBO_BINDING_LOCATION,
+									 back_state_map_ssbo_id_);
 }
 
 static std::future<void> saving_future;
@@ -208,6 +210,7 @@ bool CSIM::CellMap::saveTextureToFile(const std::filesystem::path& path) const n
 			!path.has_extension() || path.extension() != ".png") {
 		return false;
 	}
+	const TraceRecorder::Zone zone(trace_, "CellMap::saveTextureToFile", true);
 	std::vector<unsigned char> pixels(width_ * height_ * 4);
 	glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_.fbo_id_);
 	glReadPixels(
@@ -224,8 +227,10 @@ bool CSIM::CellMap::saveTextureToFile(const std::filesystem::path& path) const n
 		img = std::move(pixels),
 		img_path = path,
 		img_width = width_,
-		img_height = height_] {
+		img_height = height_,
+		trace = trace_] {
 
+		const TraceRecorder::Zone encode_zone(trace, "png encoding");
 		std::vector<unsigned char> img_reversed_in_y(img_width * img_height * 4);
 		for (std::size_t y{0}; y < img_height; ++y) {
 				for (std::size_t x{0}; x < 4 * img_width; x+=4) {
@@ -248,8 +253,8 @@ void CSIM::CellMap::destroy() noexcept {
 	fbo_.destroy();
 
 	std::array<GLuint, 2> buffers; // NOLINT
-	buffers[0] = instance_offsets_ssbo_id_;
-	buffers[1] = state_map_ssbo_id_;
+	buffers[0] = state_map_ssbo_id_;
+	buffers[1] = back_state_map_ssbo_id_;
 
 	glDeleteBuffers(buffers.size(), buffers.data());
 }
@@ -3,6 +3,8 @@
 //
 #include "cli_emulator/cellsim_cli_emulator.hpp"
 
+#include <cpu/hash_life.hpp>
+#include <profiler/trace_recorder.hpp>
 #include <project_config/config.hpp>
 #include <rules/rule_config.hpp>
 
@@ -38,28 +40,6 @@ struct VecSizeValidator : public CLI::Validator {
 	}
 };
 */
-/**
- * checks if passed argument have only 0/1 and is contained in range [min_size, max_size]
- */
-struct BinaryNumberValidator : public CLI::Validator {
-	BinaryNumberValidator(std::size_t min_length, std::size_t max_length) {
-		name_ = "binary number validator";
-		func_ = [min_length, max_length](const std::string &num) {
-			if (num.length() >= min_length && num.length() <= max_length) {
-				for (const char c : num) {
-					if (c != '0' && c != '1') {
-						return fmt::format("string {} contains char that isn't 0 or 1", num);
-					}
-				}
-				return std::string();
-			} else {
-				return fmt::format("binary num length {} isn't between {} and {}", num, min_length,
-													 max_length);
-			}
-		};
-	}
-};
-
 static auto DynamicRangeValidatorUtil(std::size_t value, std::size_t min, std::size_t max) {
 	if (value >= min && value < max) {
 		return std::string();
@@ -103,79 +83,64 @@ void CSIM::AppCLIEmulator::setCLI() {
 			->required();
 	config.subcmd_rule =
 			config.cmd_set->add_subcommand("rule", "modify current rule or switch to another rule");
-	config.subsubcmd_rule_1dbinary =
-			config.subcmd_rule->add_subcommand("1dbinary", "1d binary is one dimensional ca rule");
-	config.subsubcmd_rule_1dbinary
-			->add_option("-r,--range", config.options_1d_binary.range,
-									 "describes range of the neighbourhood (0 ..<= 4)")
-			->check(CLI::Range(RuleConfig1DBinary::RANGE_LIM.x, RuleConfig1DBinary::RANGE_LIM.y))
-			->required();
-	config.subsubcmd_rule_1dbinary
-			->add_option("-p,--patern-match-code", config.options_1d_binary.pattern_match_code,
-									 "defines which patterns of size 2*<range>+1 qualify cell for "
-									 "birth/survival, 1 = qualifed, 0 = unqualified, goes from min to max")
-			->check(CLI::BinaryNumberValidator(RuleConfig1DBinary::RANGE_LIM.x + 1,
-																				 2 * RuleConfig1DBinary::RANGE_LIM.y + 1))
+	config.options_rule.setCLI(config.subcmd_rule);
+	config.subcmd_backend = config.cmd_set->add_subcommand(
+			"backend", "switch between gpu (compute shaders), cpu (thread pool) and hashlife "
+								 "simulation");
+	config.subcmd_backend
+			->add_option("-b,--backend", config.options_backend.backend,
+									 "simulation backend, cpu backend supports 2dlife and 2dcyclic rules, "
+									 "hashlife backend runs 2dlife rules on cpu and enables jump command")
+			->check(CLI::IsMember({"gpu", "cpu", "hashlife"}))
 			->required();
-	config.subsubcmd_rule_1dtotalistic = config.subcmd_rule->add_subcommand(
-			"1dtotalistic", "1d totalistic is one dimensional ca rule");
-	config.subsubcmd_rule_1dtotalistic
-			->add_option("-r,--range", config.options_1d_totalistic.range,
-									 "describes range of the neighbourhood (0 ..<= 10)")
-			->check(CLI::Range(RuleConfig1DTotalistic::RANGE_LIM.x, RuleConfig1DTotalistic::RANGE_LIM.y))
+	config.options_backend.threads_option =
+			config.subcmd_backend
+					->add_option("-t,--threads", config.options_backend.threads,
+											 "number of cpu backend threads (default = number of hardware threads)")
+					->check(CLI::Range(1u, 1024u));
+	config.options_backend.memory_option =
+			config.subcmd_backend
+					->add_option("-m,--memory", config.options_backend.memory,
+											 "hashlife node cache budget in MiB (default = 256)")
+					->check(CLI::Range(std::size_t{16}, std::size_t{1} << 20u));
+	config.options_backend.active_tiles = config.subcmd_backend->add_flag(
+			"-a,--active-tiles", "2D rules recompute only tiles which changed or border on a changed "
+													 "tile in the last generation");
+	config.options_backend.shared_tiles = config.subcmd_backend->add_flag(
+			"-s,--shared-tiles",
+			"2D life and cyclic rules on the gpu stage every tile with its halo in shared memory instead "
+			"of reading all neighbours from the state map, maps whose width isn't a multiple of 4 keep "
+			"the direct kernel");
+	config.options_backend.temporal_block_option =
+			config.subcmd_backend
+					->add_option("-k,--temporal-block", config.options_backend.temporal_block,
+											 "generations computed per pass over the map, every step advances 2D rules "
+											 "by this many generations (default = 1), gpu box sum rules for large "
+											 "2dcyclic ranges ignore it")
+					->check(CLI::Range(1, 64));
+	config.subcmd_minimap =
+			config.cmd_set->add_subcommand("minimap", "set how often the cellmap texture is redrawn");
+	config.subcmd_minimap
+			->add_option("-r,--rate", config.option_minimap_rate,
+									 "maximal redraws per second, texture is redrawn only when the cellmap changed "
+									 "(default = 10)")
+			->check(CLI::Range(1.f, 1000.f))
 			->required();
-	config.options_1d_totalistic.exclude_center = config.subsubcmd_rule_1dtotalistic->add_flag(
-			"-e,--exclude-center", "if set then center cell won't be taken into account");
-	config.subsubcmd_rule_1dtotalistic->add_option("-s,--survive-conditions",
-																								 config.options_1d_totalistic.survival_conditions,
-																								 "array of sums which qualify cell for survival");
-	config.subsubcmd_rule_1dtotalistic->add_option("-b,--birth-conditions",
-																								 config.options_1d_totalistic.birth_conditions,
-																								 "array of sums which qualify cell for birth");
-	config.subsubcmd_rule_2dcyclic =
-			config.subcmd_rule->add_subcommand("2dcyclic", "2d cyclic is"
-																										 " 2 dimensional ca rule");
-	config.subsubcmd_rule_2dcyclic
-			->add_option("-r,--range", config.options_2d_cyclic.range,
-									 "describes range of the neighbourhood (0 ..<= 10)")
-			->check(CLI::Range(RuleConfig2DCyclic::RANGE_LIM.x, RuleConfig2DCyclic::RANGE_LIM.y))
-			->required();
-	config.subsubcmd_rule_2dcyclic
-			->add_option("-t,--threshold", config.options_2d_cyclic.threshold,
-									 "threshold which divide sums on cells qualifying to"
-									 " be born/survive and to die")
-			->check(CLI::Range(RuleConfig2DCyclic::SUM_LIM.x, RuleConfig2DCyclic::SUM_LIM.y))
-			->required();
-	config.options_2d_cyclic.moore = config.subsubcmd_rule_2dcyclic->add_flag(
-			"-m,--moore", "if set then kernel will be moore type otherwise neumann type");
-	config.options_2d_cyclic.state_insensitive = config.subsubcmd_rule_2dcyclic->add_flag(
-			"-s,--state-insensitive",
-			"if set then all cells with state higher than 0 will be accumulated "
-			"otherwise only cells with next state after processed cell's state "
-			"will be accumulated");
-	config.options_2d_cyclic.exclude_center = config.subsubcmd_rule_2dcyclic->add_flag(
-			"-e, --exclude-center", "if set than center/processed cell's state won't be"
-															" included in computation");
-
-	config.subsubcmd_rule_2dlife = config.subcmd_rule->add_subcommand("2dlife", "2d life is 2 "
-																																							"dimensional CA "
-																																							"rule");
-	config.options_2d_life.moore = config.subsubcmd_rule_2dlife->add_flag(
-			"-m,--moore", "if set then kernel will be moore type otherwise neumann type");
-	config.options_2d_life.state_insensitive = config.subsubcmd_rule_2dlife->add_flag(
-			"-S,--state-insensitive",
-			"if set then all cells with state higher than 0 will be accumulated "
-			"otherwise only cells with next state after processed cell's state "
-			"will be accumulated");
-	config.options_2d_life.exclude_center = config.subsubcmd_rule_2dlife->add_flag(
-			"-e, --exclude-center", "if set than center/processed cell's state won't be"
-															" included in computation");
-	config.subsubcmd_rule_2dlife->add_option("-s,--survive-conditions",
-																					 config.options_2d_life.survival_conditions,
-																					 "array of sums which qualify cell for survival");
-	config.subsubcmd_rule_2dlife->add_option("-b,--birth-conditions",
-																					 config.options_2d_life.birth_conditions,
-																					 "array of sums which qualify cell for birth");
+	config.subcmd_speed = config.cmd_set->add_subcommand(
+			"speed", "run the simulation at a generation rate independent of the frame rate, "
+							 "set counter switches back to stepping every n frames");
+	config.options_speed.gens_option =
+			config.subcmd_speed
+					->add_option("-g,--gens", config.options_speed.gens,
+											 "target generations per second, steps are spread over frames (default = 60)")
+					->check(CLI::Range(.1f, 1e9f));
+	config.options_speed.max_throughput = config.subcmd_speed->add_flag(
+			"-m,--max", "run as many steps per frame as fit within the frame budget");
+	config.options_speed.budget_option =
+			config.subcmd_speed
+					->add_option("-b,--budget", config.options_speed.budget,
+											 "milliseconds per frame which steps may take (default = 12)")
+					->check(CLI::Range(1.f, 1000.f));
 	config.subcmd_counter =
 			config.cmd_set->add_subcommand("counter", "set value of FPS step counter");
 	config.subcmd_counter
@@ -214,4 +179,34 @@ void CSIM::AppCLIEmulator::setCLI() {
 	config.cmd_start = this->parser.add_subcommand("start", "starts stopped simulation");
 	config.cmd_stop =
 			this->parser.add_subcommand("stop", "stops simulation until next start command");
+	config.cmd_jump = this->parser.add_subcommand(
+			"jump", "advances simulation by many generations at once (hashlife backend, 2 state "
+							"2dlife rule with range 1 kernel, power of two cellmap extents)");
+	config.options_jump.power_option =
+			config.cmd_jump
+					->add_option("-p,--power", config.options_jump.power, "jumps 2^power generations")
+					->check(CLI::Range(0u, HashLife::MAX_POWER));
+	config.options_jump.generations_option =
+			config.cmd_jump
+					->add_option("-n,--generations", config.options_jump.generations,
+											 "jumps given number of generations (done in 2^k jumps)")
+					->check(CLI::Range(std::uint64_t{1}, ~std::uint64_t{0}));
+	config.options_jump.power_option->excludes(config.options_jump.generations_option);
+	config.cmd_jump->require_option(1);
+	config.cmd_trace = this->parser.add_subcommand(
+			"trace", "records cpu zones and gpu timestamps of the next frames and writes them as Chrome "
+							 "trace-event json for chrome://tracing or Perfetto");
+	config.options_trace.frames_option =
+			config.cmd_trace
+					->add_option("-f,--frames", config.options_trace.frames,
+											 "starts recording next frames, drops events of the previous recording")
+					->check(CLI::Range(std::size_t{1}, TraceRecorder::MAX_FRAMES));
+	config.options_trace.stop =
+			config.cmd_trace->add_flag("-s,--stop", "stops recording before all its frames passed");
+	config.options_trace.output_option = config.cmd_trace->add_option(
+			"-o,--output", config.options_trace.output,
+			"writes events of the last recording to json file, overwrites existing file");
+	config.options_trace.frames_option->excludes(config.options_trace.stop);
+	config.options_trace.frames_option->excludes(config.options_trace.output_option);
+	config.cmd_trace->require_option(1, 2);
 }
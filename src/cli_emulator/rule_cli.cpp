@@ -0,0 +1,128 @@
+#include "cli_emulator/rule_cli.hpp"
+
+#include <fmt/format.h>
+
+namespace CLI {
+/**
+ * checks if passed argument have only 0/1 and is contained in range [min_size, max_size]
+ */
+struct BinaryNumberValidator : public CLI::Validator {
+	BinaryNumberValidator(std::size_t min_length, std::size_t max_length) {
+		name_ = "binary number validator";
+		func_ = [min_length, max_length](const std::string &num) {
+			if (num.length() >= min_length && num.length() <= max_length) {
+				for (const char c : num) {
+					if (c != '0' && c != '1') {
+						return fmt::format("string {} contains char that isn't 0 or 1", num);
+					}
+				}
+				return std::string();
+			} else {
+				return fmt::format("binary num length {} isn't between {} and {}", num, min_length,
+													 max_length);
+			}
+		};
+	}
+};
+
+} // namespace CLI
+
+void CSIM::RuleCLIOptions::setCLI(CLI::App *cmd_rule) {
+	subsubcmd_rule_1dbinary =
+			cmd_rule->add_subcommand("1dbinary", "1d binary is one dimensional ca rule");
+	subsubcmd_rule_1dbinary
+			->add_option("-r,--range", options_1d_binary.range,
+									 "describes range of the neighbourhood (0 ..<= 4)")
+			->check(CLI::Range(RuleConfig1DBinary::RANGE_LIM.x, RuleConfig1DBinary::RANGE_LIM.y))
+			->required();
+	subsubcmd_rule_1dbinary
+			->add_option("-p,--patern-match-code", options_1d_binary.pattern_match_code,
+									 "defines which patterns of size 2*<range>+1 qualify cell for "
+									 "birth/survival, 1 = qualifed, 0 = unqualified, goes from min to max")
+			->check(CLI::BinaryNumberValidator(RuleConfig1DBinary::RANGE_LIM.x + 1,
+																				 2 * RuleConfig1DBinary::RANGE_LIM.y + 1))
+			->required();
+	subsubcmd_rule_1dtotalistic =
+			cmd_rule->add_subcommand("1dtotalistic", "1d totalistic is one dimensional ca rule");
+	subsubcmd_rule_1dtotalistic
+			->add_option("-r,--range", options_1d_totalistic.range,
+									 "describes range of the neighbourhood (0 ..<= 1000)")
+			->check(CLI::Range(RuleConfig1DTotalistic::RANGE_LIM.x, RuleConfig1DTotalistic::RANGE_LIM.y))
+			->required();
+	options_1d_totalistic.exclude_center = subsubcmd_rule_1dtotalistic->add_flag(
+			"-e,--exclude-center", "if set then center cell won't be taken into account");
+	subsubcmd_rule_1dtotalistic->add_option("-s,--survive-conditions",
+																					options_1d_totalistic.survival_conditions,
+																					"array of sums which qualify cell for survival");
+	subsubcmd_rule_1dtotalistic->add_option("-b,--birth-conditions",
+																					options_1d_totalistic.birth_conditions,
+																					"array of sums which qualify cell for birth");
+	subsubcmd_rule_2dcyclic =
+			cmd_rule->add_subcommand("2dcyclic", "2d cyclic is 2 dimensional ca rule");
+	subsubcmd_rule_2dcyclic
+			->add_option("-r,--range", options_2d_cyclic.range,
+									 "describes range of the neighbourhood (0 ..<= 10)")
+			->check(CLI::Range(RuleConfig2DCyclic::RANGE_LIM.x, RuleConfig2DCyclic::RANGE_LIM.y))
+			->required();
+	subsubcmd_rule_2dcyclic
+			->add_option("-t,--threshold", options_2d_cyclic.threshold,
+									 "threshold which divide sums on cells qualifying to"
+									 " be born/survive and to die")
+			->check(CLI::Range(RuleConfig2DCyclic::SUM_LIM.x, RuleConfig2DCyclic::SUM_LIM.y))
+			->required();
+	options_2d_cyclic.moore = subsubcmd_rule_2dcyclic->add_flag(
+			"-m,--moore", "if set then kernel will be moore type otherwise neumann type");
+	options_2d_cyclic.state_insensitive = subsubcmd_rule_2dcyclic->add_flag(
+			"-s,--state-insensitive",
+			"if set then all cells with state higher than 0 will be accumulated "
+			"otherwise only cells with next state after processed cell's state "
+			"will be accumulated");
+	options_2d_cyclic.exclude_center = subsubcmd_rule_2dcyclic->add_flag(
+			"-e, --exclude-center", "if set than center/processed cell's state won't be"
+															" included in computation");
+
+	subsubcmd_rule_2dlife = cmd_rule->add_subcommand("2dlife", "2d life is 2 dimensional CA rule");
+	options_2d_life.moore = subsubcmd_rule_2dlife->add_flag(
+			"-m,--moore", "if set then kernel will be moore type otherwise neumann type");
+	options_2d_life.state_insensitive = subsubcmd_rule_2dlife->add_flag(
+			"-S,--state-insensitive",
+			"if set then all cells with state higher than 0 will be accumulated "
+			"otherwise only cells with next state after processed cell's state "
+			"will be accumulated");
+	options_2d_life.exclude_center = subsubcmd_rule_2dlife->add_flag(
+			"-e, --exclude-center", "if set than center/processed cell's state won't be"
+															" included in computation");
+	subsubcmd_rule_2dlife->add_option("-s,--survive-conditions", options_2d_life.survival_conditions,
+																		"array of sums which qualify cell for survival");
+	subsubcmd_rule_2dlife->add_option("-b,--birth-conditions", options_2d_life.birth_conditions,
+																		"array of sums which qualify cell for birth");
+}
+
+std::shared_ptr<CSIM::RuleConfig> CSIM::RuleCLIOptions::parsedRuleConfig(
+		const std::function<std::shared_ptr<Shader>(RuleConfigType)> &make_shader) const {
+	if (subsubcmd_rule_1dtotalistic->parsed()) {
+		const auto &args = options_1d_totalistic;
+		return std::make_shared<RuleConfig1DTotalistic>(
+				static_cast<std::int32_t>(args.range), args.exclude_center->empty(),
+				args.survival_conditions, args.birth_conditions,
+				make_shader(RuleConfigType::TOTALISTIC_1D));
+	}
+	if (subsubcmd_rule_1dbinary->parsed()) {
+		const auto &args = options_1d_binary;
+		return std::make_shared<RuleConfig1DBinary>(args.range, args.pattern_match_code,
+																								make_shader(RuleConfigType::BINARY_1D));
+	}
+	if (subsubcmd_rule_2dcyclic->parsed()) {
+		const auto &args = options_2d_cyclic;
+		return std::make_shared<RuleConfig2DCyclic>(
+				args.range, args.threshold, !args.moore->empty(), !args.state_insensitive->empty(),
+				args.exclude_center->empty(), make_shader(RuleConfigType::CYCLIC_2D));
+	}
+	if (subsubcmd_rule_2dlife->parsed()) {
+		const auto &args = options_2d_life;
+		return std::make_shared<RuleConfig2DLife>(
+				!args.moore->empty(), !args.state_insensitive->empty(), args.exclude_center->empty(),
+				args.survival_conditions, args.birth_conditions, make_shader(RuleConfigType::LIFE_2D));
+	}
+	return nullptr;
+}
@@ -0,0 +1,81 @@
+#include "cpu/active_tiles.hpp"
+
+#include <algorithm>
+
+CSIM::ActiveTiles::ActiveTiles(Vec2<std::int32_t> tile_size, Vec2<std::int32_t> reach) noexcept
+		: tile_size_(tile_size), reach_(reach) {
+}
+
+CSIM::Vec2<std::int32_t> CSIM::ActiveTiles::tileReach(Vec2<std::int32_t> resolution,
+																											 Vec2<std::int32_t> tile_size,
+																											 Vec2<std::int32_t> reach) noexcept {
+	const auto axis = [](std::int32_t extent, std::int32_t size, std::int32_t axis_reach) {
+		const auto partial = static_cast<std::int32_t>(extent % size != 0);
+		return (axis_reach + size - 1) / size + (axis_reach > 0 ? partial : 0);
+	};
+	return {axis(resolution.x, tile_size.x, reach.x), axis(resolution.y, tile_size.y, reach.y)};
+}
+
+bool CSIM::ActiveTiles::update(Vec2<std::int32_t> resolution) {
+	if (resolution.x != resolution_.x || resolution.y != resolution_.y) {
+		resolution_ = resolution;
+		tile_count_ = {(resolution.x + tile_size_.x - 1) / tile_size_.x,
+									 (resolution.y + tile_size_.y - 1) / tile_size_.y};
+		tile_reach_ = tileReach(resolution, tile_size_, reach_);
+		const auto count =
+				static_cast<std::size_t>(tile_count_.x) * static_cast<std::size_t>(tile_count_.y);
+		changed_.assign(count, 0);
+		active_.assign(count, 0);
+		all_active_ = true;
+	}
+
+	active_tiles_.clear();
+	if (all_active_) {
+		all_active_ = false;
+		for (std::uint32_t tile = 0; tile < changed_.size(); ++tile) {
+			active_tiles_.push_back(tile);
+		}
+		std::fill(changed_.begin(), changed_.end(), 0);
+		return true;
+	}
+
+	/// window wider than the map covers the whole axis instead of visiting tiles more than once
+	const auto full_x = 2 * tile_reach_.x + 1 >= tile_count_.x;
+	const auto full_y = 2 * tile_reach_.y + 1 >= tile_count_.y;
+	const auto span_x = full_x ? tile_count_.x : 2 * tile_reach_.x + 1;
+	const auto span_y = full_y ? tile_count_.y : 2 * tile_reach_.y + 1;
+	const auto wrap = [](std::int32_t value, std::int32_t extent) {
+		return value < 0 ? value + extent : (value >= extent ? value - extent : value);
+	};
+	for (std::int32_t y = 0; y < tile_count_.y; ++y) {
+		for (std::int32_t x = 0; x < tile_count_.x; ++x) {
+			if (changed_[static_cast<std::size_t>(x + y * tile_count_.x)] == 0) {
+				continue;
+			}
+			const auto first_x = full_x ? 0 : x - tile_reach_.x;
+			const auto first_y = full_y ? 0 : y - tile_reach_.y;
+			for (std::int32_t j = 0; j < span_y; ++j) {
+				const auto row = wrap(first_y + j, tile_count_.y) * tile_count_.x;
+				for (std::int32_t i = 0; i < span_x; ++i) {
+					active_[static_cast<std::size_t>(row + wrap(first_x + i, tile_count_.x))] = 1;
+				}
+			}
+		}
+	}
+	/// list keeps row major order so that neighbouring tiles end up on the same worker
+	for (std::uint32_t tile = 0; tile < active_.size(); ++tile) {
+		if (active_[tile] != 0) {
+			active_tiles_.push_back(tile);
+			active_[tile] = 0;
+		}
+	}
+	std::fill(changed_.begin(), changed_.end(), 0);
+	return false;
+}
+
+CSIM::Vec4<std::int32_t> CSIM::ActiveTiles::tileBounds(std::uint32_t tile) const noexcept {
+	const auto x = static_cast<std::int32_t>(tile) % tile_count_.x * tile_size_.x;
+	const auto y = static_cast<std::int32_t>(tile) / tile_count_.x * tile_size_.y;
+	return {x, y, std::min(x + tile_size_.x, resolution_.x),
+					std::min(y + tile_size_.y, resolution_.y)};
+}
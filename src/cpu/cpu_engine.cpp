@@ -0,0 +1,29 @@
+#include "cpu/cpu_engine.hpp"
+#include "cpu/cpu_engine_1d_binary.hpp"
+#include "cpu/cpu_engine_1d_totalistic.hpp"
+#include "cpu/cpu_engine_2d.hpp"
+#include "cpu/cpu_engine_box_sum.hpp"
+#include "cpu/cpu_engine_life_swar.hpp"
+
+std::unique_ptr<CSIM::CPUEngine> CSIM::makeCPUEngine(const RuleConfig &rule_config,
+																										 std::int32_t state_count,
+																										 std::shared_ptr<ThreadPool> thread_pool,
+																										 bool active_tiles) {
+	if (CPUEngine1DBinary::supports(rule_config)) {
+		return std::make_unique<CPUEngine1DBinary>(rule_config, std::move(thread_pool));
+	}
+	if (CPUEngine1DTotalistic::supports(rule_config)) {
+		return std::make_unique<CPUEngine1DTotalistic>(rule_config, std::move(thread_pool));
+	}
+	if (CPUEngineLifeSWAR::supports(rule_config, state_count)) {
+		return std::make_unique<CPUEngineLifeSWAR>(rule_config, std::move(thread_pool), active_tiles);
+	}
+	/// box sums are computed for whole rows, so the engine doesn't track active tiles
+	if (CPUEngineBoxSum2D::supports(rule_config)) {
+		return std::make_unique<CPUEngineBoxSum2D>(rule_config, std::move(thread_pool));
+	}
+	if (CPUEngine2D::supports(rule_config)) {
+		return std::make_unique<CPUEngine2D>(rule_config, std::move(thread_pool), active_tiles);
+	}
+	return nullptr;
+}
@@ -0,0 +1,325 @@
+#include "cpu/cpu_engine_1d_binary.hpp"
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+static constexpr std::int32_t WORD_BITS{64};
+static constexpr std::uint64_t ALL_ONES{~static_cast<std::uint64_t>(0)};
+static constexpr std::uint32_t LOOKUP_CELLS{8}; /*!< center cells resolved by one lookup */
+
+/// same state update as the 1D binary shader: alive cell advances up to the last state, born cell
+/// gets state 1, dead cell gets 0 (lane_mask is all ones if the cell is alive in the next row)
+static CSIM::utils::CellState nextState(std::int32_t state, std::int32_t state_count,
+																				std::int32_t lane_mask) noexcept {
+	return static_cast<CSIM::utils::CellState>(
+			(state + ((state + 1 < state_count) | (state == 0))) & lane_mask);
+}
+
+/// writes next states of 64 cells, bit i of bits is set if cell i is alive in the next row
+static void writeWord(CSIM::utils::CellState *cells, std::uint64_t bits,
+											std::int32_t state_count) noexcept {
+	std::int32_t x{0};
+	// NOLINTBEGIN intrinsics interface
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+	/// byte k of spread(b) is b, anded with lane bits it leaves bit k of b in byte k
+	constexpr std::uint64_t BYTE_SPREAD{0x0101010101010101u};
+	constexpr std::uint64_t LANE_BITS{0x8040201008040201u};
+	const auto spread = [bits](std::int32_t first) {
+		return static_cast<std::int64_t>(((bits >> first) & 0xFFu) * BYTE_SPREAD);
+	};
+	/// cell grows if state + 1 < state_count or state == 0, that is state <= max(state_count - 2, 0)
+	const auto last_growing = static_cast<char>(std::max(state_count - 2, 0));
+#endif
+#if defined(__AVX2__)
+	const auto lane_bits = _mm256_set1_epi64x(static_cast<std::int64_t>(LANE_BITS));
+	const auto zero = _mm256_setzero_si256();
+	const auto bound = _mm256_set1_epi8(last_growing);
+	for (; x < WORD_BITS; x += 32) {
+		const auto pattern =
+				_mm256_setr_epi64x(spread(x), spread(x + 8), spread(x + 16), spread(x + 24));
+		const auto alive = _mm256_cmpeq_epi8(_mm256_and_si256(pattern, lane_bits), lane_bits);
+		auto *lanes = reinterpret_cast<__m256i *>(cells + x);
+		const auto state = _mm256_loadu_si256(lanes);
+		/// advance is -1 for cells whose state grows
+		const auto advance = _mm256_cmpeq_epi8(_mm256_subs_epu8(state, bound), zero);
+		const auto grown = _mm256_sub_epi8(state, advance);
+		_mm256_storeu_si256(lanes, _mm256_and_si256(alive, grown));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const auto lane_bits = _mm_set1_epi64x(static_cast<std::int64_t>(LANE_BITS));
+	const auto zero = _mm_setzero_si128();
+	const auto bound = _mm_set1_epi8(last_growing);
+	for (; x < WORD_BITS; x += 16) {
+		const auto pattern = _mm_set_epi64x(spread(x + 8), spread(x));
+		const auto alive = _mm_cmpeq_epi8(_mm_and_si128(pattern, lane_bits), lane_bits);
+		auto *lanes = reinterpret_cast<__m128i *>(cells + x);
+		const auto state = _mm_loadu_si128(lanes);
+		/// advance is -1 for cells whose state grows
+		const auto advance = _mm_cmpeq_epi8(_mm_subs_epu8(state, bound), zero);
+		const auto grown = _mm_sub_epi8(state, advance);
+		_mm_storeu_si128(lanes, _mm_and_si128(alive, grown));
+	}
+#endif
+	// NOLINTEND
+	for (; x < WORD_BITS; ++x) {
+		const auto lane_mask = -static_cast<std::int32_t>((bits >> x) & 1u);
+		cells[x] = nextState(cells[x], state_count, lane_mask); // NOLINT
+	}
+}
+
+/// word of the row shifted so that bit i holds cell i + offset, |offset| < WORD_BITS
+static std::uint64_t shifted(std::uint64_t prev, std::uint64_t cur, std::uint64_t next,
+														 std::int32_t offset) noexcept {
+	if (offset > 0) {
+		return (cur >> offset) | (next << (WORD_BITS - offset));
+	}
+	if (offset < 0) {
+		return (cur << -offset) | (prev >> (WORD_BITS + offset));
+	}
+	return cur;
+}
+
+CSIM::CPUEngine1DBinary::CPUEngine1DBinary(const RuleConfig &rule_config,
+																					 std::shared_ptr<ThreadPool> thread_pool)
+		: thread_pool_(std::move(thread_pool)) {
+	if (!supports(rule_config)) {
+		throw std::invalid_argument("1D binary engine supports only 1D binary configs");
+	}
+	const auto &config = static_cast<const RuleConfig1DBinary &>(rule_config).config();
+	range_ = config.range;
+
+	const auto pattern_bits = static_cast<std::uint32_t>(2 * range_ + 1);
+	const auto code = std::span(config.pattern_match_code);
+	std::vector<bool> patterns(std::size_t{1} << pattern_bits);
+	for (std::size_t pattern = 0; pattern < patterns.size(); ++pattern) {
+		patterns[pattern] = ((code[pattern >> 5u] >> (pattern & 0x1Fu)) & 1u) != 0;
+	}
+
+	std::map<std::array<std::uint16_t, 3>, std::uint16_t> unique;
+	expression_result_ = compile(patterns, 0, pattern_bits, unique);
+	if (expression_.size() <= MAX_EXPRESSION_NODES) {
+		return;
+	}
+	expression_.clear();
+
+	/// bit q of a window is cell at offset q - range of the first center cell, pattern match code
+	/// takes the leftmost cell as the most significant bit
+	const auto window_bits = LOOKUP_CELLS + pattern_bits - 1;
+	const auto pattern_mask = (1u << pattern_bits) - 1;
+	lookup_.resize(std::size_t{1} << window_bits);
+	for (std::uint32_t window = 0; window < lookup_.size(); ++window) {
+		std::uint32_t cells{0};
+		for (std::uint32_t cell = 0; cell < LOOKUP_CELLS; ++cell) {
+			const auto neighbourhood = (window >> cell) & pattern_mask;
+			std::uint32_t pattern{0};
+			for (std::uint32_t q = 0; q < pattern_bits; ++q) {
+				pattern |= ((neighbourhood >> q) & 1u) << (pattern_bits - 1 - q);
+			}
+			cells |= static_cast<std::uint32_t>(patterns[pattern]) << cell;
+		}
+		lookup_[window] = static_cast<std::uint8_t>(cells);
+	}
+}
+
+bool CSIM::CPUEngine1DBinary::supports(const RuleConfig &rule_config) noexcept {
+	if (rule_config.ruleConfigType() != RuleConfigType::BINARY_1D) {
+		return false;
+	}
+	const auto range = static_cast<const RuleConfig1DBinary &>(rule_config).config().range;
+	return range >= 0 && static_cast<std::uint32_t>(range) <= RuleConfig1DBinary::RANGE_LIM.y;
+}
+
+std::uint16_t
+CSIM::CPUEngine1DBinary::compile(const std::vector<bool> &patterns, std::size_t first,
+																 std::uint32_t bit,
+																 std::map<std::array<std::uint16_t, 3>, std::uint16_t> &unique) {
+	if (bit == 0) {
+		return static_cast<std::uint16_t>(patterns[first]);
+	}
+	const auto input = static_cast<std::uint16_t>(bit - 1);
+	const auto low = compile(patterns, first, bit - 1, unique);
+	const auto high = compile(patterns, first + (std::size_t{1} << (bit - 1)), bit - 1, unique);
+	if (low == high) {
+		return low;
+	}
+	const auto [node, inserted] =
+			unique.try_emplace({input, low, high}, static_cast<std::uint16_t>(expression_.size() + 2));
+	if (inserted) {
+		expression_.push_back({input, low, high});
+	}
+	return node->second;
+}
+
+void CSIM::CPUEngine1DBinary::step(std::vector<CellState> &states,
+																	 Vec2<std::int32_t> resolution, std::int32_t state_count,
+																	 std::int32_t iteration) {
+	run(states, resolution, state_count, iteration, 1);
+}
+
+void CSIM::CPUEngine1DBinary::run(std::vector<CellState> &states,
+																	Vec2<std::int32_t> resolution, std::int32_t state_count,
+																	std::int32_t iteration, std::int32_t generations) {
+	if (generations <= 0) {
+		return;
+	}
+	const auto width = resolution.x;
+	const auto words = static_cast<std::size_t>((width + WORD_BITS - 1) / WORD_BITS);
+	auto read_row = (iteration % resolution.y + resolution.y) % resolution.y;
+
+	pack(states.data() + static_cast<std::size_t>(read_row) * static_cast<std::size_t>(width),
+			 width);
+	next_row_.assign(words + 2, 0);
+	for (std::int32_t generation = 0; generation < generations; ++generation) {
+		read_row = read_row + 1 == resolution.y ? 0 : read_row + 1;
+		auto *row =
+				states.data() + static_cast<std::size_t>(read_row) * static_cast<std::size_t>(width);
+		if (words < PARALLEL_MIN_WORDS) {
+			processWords(row, width, state_count, 0, words);
+		} else {
+			thread_pool_->parallelForDynamic(
+					words, WORD_GRAIN, [&](std::size_t begin, std::size_t end, std::size_t /*worker*/) {
+						processWords(row, width, state_count, begin, end);
+					});
+		}
+		/// written row is the read row of the next generation
+		pad(next_row_, width);
+		std::swap(read_row_, next_row_);
+	}
+}
+
+void CSIM::CPUEngine1DBinary::pack(const CellState *row, std::int32_t width) {
+	const auto words = static_cast<std::size_t>((width + WORD_BITS - 1) / WORD_BITS);
+	read_row_.assign(words + 2, 0);
+	const auto task = [&](std::size_t begin, std::size_t end, std::size_t /*worker*/) {
+		for (auto word = begin; word < end; ++word) {
+			const auto first = static_cast<std::int32_t>(word) * WORD_BITS;
+			const auto count = std::min(WORD_BITS, width - first);
+			std::uint64_t bits{0};
+			for (std::int32_t bit = 0; bit < count; ++bit) {
+				bits |= static_cast<std::uint64_t>(row[first + bit] > 0) << bit; // NOLINT
+			}
+			read_row_[word + 1] = bits;
+		}
+	};
+	if (words < PARALLEL_MIN_WORDS) {
+		task(0, words, 0);
+	} else {
+		thread_pool_->parallelFor(words, task);
+	}
+	pad(read_row_, width);
+}
+
+void CSIM::CPUEngine1DBinary::pad(std::vector<std::uint64_t> &row, std::int32_t width) noexcept {
+	const auto words = row.size() - 2;
+	if (width % WORD_BITS == 0) {
+		row.front() = row[words];
+		row.back() = row[1];
+		return;
+	}
+	const auto cell = [&](std::int32_t x) {
+		x = (x % width + width) % width;
+		return (row[static_cast<std::size_t>(x / WORD_BITS) + 1] >> (x % WORD_BITS)) & 1u;
+	};
+	/// tail of the last word and the right guard word continue with cells from the row begin
+	const auto tail = width % WORD_BITS;
+	row[words] &= (std::uint64_t{1} << tail) - 1;
+	row.back() = 0;
+	for (auto x = width; x < static_cast<std::int32_t>(words + 1) * WORD_BITS; ++x) {
+		row[static_cast<std::size_t>(x / WORD_BITS) + 1] |= cell(x) << (x % WORD_BITS);
+	}
+	row.front() = 0;
+	for (std::int32_t x = -WORD_BITS; x < 0; ++x) {
+		row.front() |= cell(x) << (x + WORD_BITS);
+	}
+}
+
+void CSIM::CPUEngine1DBinary::processWords(CellState *row, std::int32_t width,
+																					 std::int32_t state_count, std::size_t begin,
+																					 std::size_t end) noexcept {
+	for (auto block = begin; block < end; block += BLOCK_WORDS) {
+		const auto block_end = std::min(block + BLOCK_WORDS, end);
+		evaluateWords(block, block_end);
+
+		for (auto word = block; word < block_end; ++word) {
+			const auto bits = next_row_[word + 1];
+			const auto first = static_cast<std::int32_t>(word) * WORD_BITS;
+			const auto count = std::min(WORD_BITS, width - first);
+			auto *cells = row + first; // NOLINT
+			if (bits == 0) {
+				std::fill(cells, cells + count, 0); // NOLINT
+				continue;
+			}
+			if (count < WORD_BITS) {
+				for (std::int32_t bit = 0; bit < count; ++bit) {
+					const auto lane_mask = -static_cast<std::int32_t>((bits >> bit) & 1u);
+					cells[bit] = nextState(cells[bit], state_count, lane_mask); // NOLINT
+				}
+				continue;
+			}
+			writeWord(cells, bits, state_count);
+		}
+	}
+}
+
+void CSIM::CPUEngine1DBinary::evaluateWords(std::size_t begin, std::size_t end) noexcept {
+	if (!lookup_.empty()) {
+		for (auto word = begin; word < end; ++word) {
+			next_row_[word + 1] = lookupWord(read_row_[word], read_row_[word + 1], read_row_[word + 2]);
+		}
+		return;
+	}
+
+	/// expression is evaluated node by node over the whole block, so that interpreting the nodes
+	/// costs little and every node is a simple loop over words
+	const auto count = end - begin;
+	std::array<std::array<std::uint64_t, BLOCK_WORDS>, MAX_PATTERN_BITS> inputs; // NOLINT
+	for (std::int32_t input = 0; input <= 2 * range_; ++input) {
+		auto &shifted_words = inputs[static_cast<std::size_t>(input)]; // NOLINT
+		for (std::size_t i = 0; i < count; ++i) {
+			const auto word = begin + i;
+			shifted_words[i] =
+					shifted(read_row_[word], read_row_[word + 1], read_row_[word + 2], range_ - input);
+		}
+	}
+	std::array<std::array<std::uint64_t, BLOCK_WORDS>, MAX_EXPRESSION_NODES + 2> values; // NOLINT
+	values[0].fill(0);
+	values[1].fill(ALL_ONES);
+	for (std::size_t node = 0; node < expression_.size(); ++node) {
+		const auto &mux = expression_[node];
+		const auto &selector = inputs[mux.input]; // NOLINT
+		const auto &high = values[mux.high];			// NOLINT
+		const auto &low = values[mux.low];				// NOLINT
+		auto &value = values[node + 2];						// NOLINT
+		for (std::size_t i = 0; i < count; ++i) {
+			value[i] = (selector[i] & high[i]) | (~selector[i] & low[i]); // NOLINT
+		}
+	}
+	const auto &result = values[expression_result_]; // NOLINT
+	std::copy(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(count),
+						next_row_.begin() + static_cast<std::ptrdiff_t>(begin + 1));
+}
+
+std::uint64_t CSIM::CPUEngine1DBinary::lookupWord(std::uint64_t prev, std::uint64_t cur,
+																									std::uint64_t next) const noexcept {
+	const auto window_bits = LOOKUP_CELLS + 2 * static_cast<std::uint32_t>(range_);
+	const auto window_mask = (std::uint64_t{1} << window_bits) - 1;
+	/// bit i of window holds cell i - range, so byte j starts the window of cells 8j..8j+7
+	const auto window = range_ == 0 ? cur : (cur << range_) | (prev >> (WORD_BITS - range_));
+	std::uint64_t result{0};
+	for (std::uint32_t byte = 0; byte + 1 < sizeof(std::uint64_t); ++byte) {
+		const auto shift = byte * LOOKUP_CELLS;
+		result |= static_cast<std::uint64_t>(lookup_[(window >> shift) & window_mask]) << shift;
+	}
+	/// window of the last byte reaches into the next word
+	constexpr auto LAST_SHIFT = WORD_BITS - static_cast<std::int32_t>(LOOKUP_CELLS);
+	const auto last = (cur >> (LAST_SHIFT - range_)) |
+										(next << (LOOKUP_CELLS + static_cast<std::uint32_t>(range_)));
+	return result | (static_cast<std::uint64_t>(lookup_[last & window_mask]) << LAST_SHIFT);
+}
@@ -0,0 +1,180 @@
+#include "cpu/cpu_engine_1d_totalistic.hpp"
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+static std::int32_t wrap(std::int32_t value, std::int32_t extent) noexcept {
+	value %= extent;
+	return value < 0 ? value + extent : value;
+}
+
+/// same state update as the 1D totalistic shader: alive cell advances up to the last state, born
+/// cell gets state 1, dead cell gets 0 (lane_mask is all ones if the cell is alive in the next row)
+static CSIM::utils::CellState nextState(std::int32_t state, std::int32_t state_count,
+																				std::int32_t lane_mask) noexcept {
+	return static_cast<CSIM::utils::CellState>(
+			(state + ((state + 1 < state_count) | (state == 0))) & lane_mask);
+}
+
+/**
+ * computes count kernel sums, sums[i] = window[i] - base[i] - (center_high[i] - center_low[i]),
+ * center pointers are null if center cell is part of the kernel
+ */
+static void windowSums(const std::uint32_t *window, const std::uint32_t *base,
+											 const std::uint32_t *center_high, const std::uint32_t *center_low,
+											 std::uint32_t *sums, std::size_t count) noexcept {
+	std::size_t i{0};
+	// NOLINTBEGIN intrinsics interface
+#if defined(__AVX2__)
+	for (; i + 8 <= count; i += 8) {
+		const auto load = [i](const std::uint32_t *table) {
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(table + i));
+		};
+		auto sum = _mm256_sub_epi32(load(window), load(base));
+		if (center_high != nullptr) {
+			sum = _mm256_sub_epi32(sum, _mm256_sub_epi32(load(center_high), load(center_low)));
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(sums + i), sum);
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	for (; i + 4 <= count; i += 4) {
+		const auto load = [i](const std::uint32_t *table) {
+			return _mm_loadu_si128(reinterpret_cast<const __m128i *>(table + i));
+		};
+		auto sum = _mm_sub_epi32(load(window), load(base));
+		if (center_high != nullptr) {
+			sum = _mm_sub_epi32(sum, _mm_sub_epi32(load(center_high), load(center_low)));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(sums + i), sum);
+	}
+#endif
+	for (; i < count; ++i) {
+		sums[i] = window[i] - base[i];
+		if (center_high != nullptr) {
+			sums[i] -= center_high[i] - center_low[i];
+		}
+	}
+	// NOLINTEND
+}
+
+CSIM::CPUEngine1DTotalistic::CPUEngine1DTotalistic(const RuleConfig &rule_config,
+																									 std::shared_ptr<ThreadPool> thread_pool)
+		: thread_pool_(std::move(thread_pool)) {
+	if (!supports(rule_config)) {
+		throw std::invalid_argument("1D totalistic engine supports only 1D totalistic configs");
+	}
+	const auto &config = static_cast<const RuleConfig1DTotalistic &>(rule_config).config();
+	range_ = config.range;
+	center_active_ = config.center_active != 0;
+
+	/// sums go from 0 to 2 * range + 1
+	const auto sum_count = static_cast<std::size_t>(2 * range_ + 2);
+	const auto survival = std::span(config.survival_conditions_hashmap);
+	const auto birth = std::span(config.birth_conditions_hashmap);
+	transitions_.resize(2 * sum_count);
+	for (std::size_t sum = 0; sum < sum_count; ++sum) {
+		transitions_[2 * sum] = static_cast<std::uint8_t>(birth[sum] != 0);
+		transitions_[2 * sum + 1] = static_cast<std::uint8_t>(survival[sum] != 0);
+	}
+}
+
+bool CSIM::CPUEngine1DTotalistic::supports(const RuleConfig &rule_config) noexcept {
+	if (rule_config.ruleConfigType() != RuleConfigType::TOTALISTIC_1D) {
+		return false;
+	}
+	const auto range = static_cast<const RuleConfig1DTotalistic &>(rule_config).config().range;
+	return range >= 0 && static_cast<std::uint32_t>(range) <= RuleConfig1DTotalistic::RANGE_LIM.y;
+}
+
+void CSIM::CPUEngine1DTotalistic::step(std::vector<CellState> &states,
+																			 Vec2<std::int32_t> resolution, std::int32_t state_count,
+																			 std::int32_t iteration) {
+	const auto width = static_cast<std::size_t>(resolution.x);
+	const auto read_row = wrap(iteration, resolution.y);
+	const auto write_row = read_row + 1 == resolution.y ? 0 : read_row + 1;
+
+	/// prefix is built before any cell is written, so 1 row maps read the previous generation
+	buildPrefix(states.data() + static_cast<std::size_t>(read_row) * width, resolution.x);
+
+	auto *row = states.data() + static_cast<std::size_t>(write_row) * width;
+	if (width < PARALLEL_MIN_CELLS) {
+		processCells(row, state_count, 0, width);
+	} else {
+		thread_pool_->parallelForDynamic(
+				width, CELL_GRAIN, [&](std::size_t begin, std::size_t end, std::size_t /*worker*/) {
+					processCells(row, state_count, begin, end);
+				});
+	}
+}
+
+void CSIM::CPUEngine1DTotalistic::buildPrefix(const CellState *row, std::int32_t width) {
+	/// extended row index i maps to cell i - range, window of cell x is [x, x + 2 * range]
+	const auto extended = static_cast<std::size_t>(width + 2 * range_);
+	prefix_.resize(extended + 1);
+	prefix_[0] = 0;
+
+	const auto count_band = [&](std::size_t begin, std::size_t end) {
+		std::uint32_t running{0};
+		for (auto i = begin; i < end; ++i) {
+			const auto x = static_cast<std::int32_t>(i) - range_;
+			const auto cell = x >= 0 && x < width ? row[x] : row[wrap(x, width)]; // NOLINT
+			running += static_cast<std::uint32_t>(cell > 0);
+			prefix_[i + 1] = running;
+		}
+		return running;
+	};
+	if (extended < PARALLEL_MIN_CELLS) {
+		count_band(0, extended);
+		return;
+	}
+
+	/// bands count their cells independently, then every band is shifted by totals of previous
+	/// bands
+	const auto band_count = thread_pool_->threadCount();
+	band_offsets_.assign(band_count + 1, 0);
+	thread_pool_->parallelFor(band_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (auto band = begin; band < end; ++band) {
+			const auto [first, last] = ThreadPool::band(extended, band, band_count);
+			band_offsets_[band + 1] = count_band(first, last);
+		}
+	});
+	for (std::size_t band = 0; band < band_count; ++band) {
+		band_offsets_[band + 1] += band_offsets_[band];
+	}
+	thread_pool_->parallelFor(band_count, [&](std::size_t begin, std::size_t end, std::size_t) {
+		for (auto band = begin; band < end; ++band) {
+			const auto [first, last] = ThreadPool::band(extended, band, band_count);
+			const auto offset = band_offsets_[band];
+			for (auto i = first; i < last; ++i) {
+				prefix_[i + 1] += offset;
+			}
+		}
+	});
+}
+
+void CSIM::CPUEngine1DTotalistic::processCells(CellState *row, std::int32_t state_count,
+																							 std::size_t begin, std::size_t end) const noexcept {
+	const auto span = static_cast<std::size_t>(2 * range_ + 1);
+	const auto reach = static_cast<std::size_t>(range_);
+	std::array<std::uint32_t, BLOCK_CELLS> sums; // NOLINT initialized by windowSums
+	for (auto block = begin; block < end; block += BLOCK_CELLS) {
+		const auto count = std::min(BLOCK_CELLS, end - block);
+		const auto *base = prefix_.data() + block;
+		windowSums(base + span, base, center_active_ ? nullptr : base + reach + 1,
+							 center_active_ ? nullptr : base + reach, sums.data(), count);
+
+		for (std::size_t i = 0; i < count; ++i) {
+			auto &cell = row[block + i]; // NOLINT
+			const auto alive = transitions_[2 * sums[i] + static_cast<std::size_t>(cell > 0)];
+			cell = nextState(cell, state_count, -static_cast<std::int32_t>(alive));
+		}
+	}
+}
@@ -0,0 +1,386 @@
+#include "cpu/cpu_engine_2d.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+
+static std::int32_t wrap(std::int32_t value, std::int32_t extent) noexcept {
+	value %= extent;
+	return value < 0 ? value + extent : value;
+}
+
+/// same state update as the 2D_life shader: alive cell advances up to the last state, born cell
+/// gets state 1, dead cell gets 0 (lane_mask is all ones if the cell is alive in next generation)
+static CSIM::utils::CellState nextState(std::int32_t state, std::int32_t state_count,
+																				std::int32_t lane_mask) noexcept {
+	return static_cast<CSIM::utils::CellState>(
+			(state + ((state + 1 < state_count) | (state == 0))) & lane_mask);
+}
+
+/**
+ * copies count cells of the row starting at column begin, columns wrap around (even several times
+ * on rows narrower than count)
+ */
+static void copyWrapped(const CSIM::utils::CellState *row, std::int32_t width, std::int32_t begin,
+												std::int32_t count, CSIM::utils::CellState *out) noexcept {
+	auto x = wrap(begin, width);
+	while (count > 0) {
+		const auto length = std::min(count, width - x);
+		std::copy_n(row + x, length, out); // NOLINT
+		out += length;										 // NOLINT
+		count -= length;
+		x = 0;
+	}
+}
+
+CSIM::CPUEngine2D::CPUEngine2D(const RuleConfig &rule_config,
+															 std::shared_ptr<ThreadPool> thread_pool, bool active_tiles)
+		: thread_pool_(std::move(thread_pool)) {
+	switch (rule_config.ruleConfigType()) {
+	case RuleConfigType::LIFE_2D: {
+		const auto &config = static_cast<const RuleConfig2DLife &>(rule_config).config();
+		const auto offsets =
+				std::span(config.offsets).first(static_cast<std::size_t>(config.offsets_count));
+		std::transform(offsets.begin(), offsets.end(), std::back_inserter(offsets_),
+									 [](Vec4<std::int32_t> offset) {
+										 return Vec2<std::int32_t>{offset.x, offset.y};
+									 });
+		/// sum can't exceed number of offsets so only that part of hashmaps is needed
+		const auto sum_count = std::min(offsets_.size() + 1, RuleConfig2DLife::MAX_OPTIONS);
+		const auto survival = std::span(config.survival_conditions_hashmap).first(sum_count);
+		const auto birth = std::span(config.birth_conditions_hashmap).first(sum_count);
+		survival_.assign(survival.begin(), survival.end());
+		birth_.assign(birth.begin(), birth.end());
+		survival_.resize(offsets_.size() + 1, 0);
+		birth_.resize(offsets_.size() + 1, 0);
+
+		state_insensitive_ = config.state_insensitive != 0;
+		wrap_states_ = false;
+		life_table_ = LifeTable::compile(static_cast<const RuleConfig2DLife &>(rule_config));
+	} break;
+	case RuleConfigType::CYCLIC_2D: {
+		const auto &config = static_cast<const RuleConfig2DCyclic &>(rule_config).config();
+		const auto offsets =
+				std::span(config.offsets).first(static_cast<std::size_t>(config.offsets_count));
+		offsets_.assign(offsets.begin(), offsets.end());
+		/// cyclic rule survives/births when sum reaches the threshold
+		survival_.resize(offsets_.size() + 1);
+		for (std::size_t sum = 0; sum < survival_.size(); ++sum) {
+			survival_[sum] =
+					static_cast<std::uint8_t>(static_cast<std::int32_t>(sum) >= config.threshold);
+		}
+		birth_ = survival_;
+
+		state_insensitive_ = config.state_insensitive != 0;
+		wrap_states_ = true;
+	} break;
+	default:
+		throw std::invalid_argument("cpu 2d engine supports only 2D life and 2D cyclic rule configs");
+	}
+
+	for (const auto offset : offsets_) {
+		reach_x_ = std::max(reach_x_, std::abs(offset.x));
+		reach_y_ = std::max(reach_y_, std::abs(offset.y));
+	}
+	if (active_tiles) {
+		active_tiles_.emplace(Vec2<std::int32_t>{TILE_SIZE, TILE_SIZE},
+													Vec2<std::int32_t>{reach_x_, reach_y_});
+	}
+}
+
+bool CSIM::CPUEngine2D::supports(const RuleConfig &rule_config) noexcept {
+	return rule_config.ruleConfigType() == RuleConfigType::LIFE_2D ||
+				 rule_config.ruleConfigType() == RuleConfigType::CYCLIC_2D;
+}
+
+void CSIM::CPUEngine2D::step(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+														 std::int32_t state_count, std::int32_t /*iteration*/) {
+	back_buffer_.resize(states.size());
+	const auto *src = states.data();
+	auto *dst = back_buffer_.data();
+
+	if (active_tiles_) {
+		stepActiveTiles(src, dst, resolution, state_count);
+	} else {
+		thread_pool_->parallelForDynamic(
+				static_cast<std::size_t>(resolution.y), ROW_GRAIN,
+				[&](std::size_t row_begin, std::size_t row_end, std::size_t) {
+					processRect(src, dst, resolution, state_count,
+											{0, static_cast<std::int32_t>(row_begin), resolution.x,
+											 static_cast<std::int32_t>(row_end)});
+				});
+	}
+
+	std::swap(states, back_buffer_);
+}
+
+void CSIM::CPUEngine2D::run(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+														std::int32_t state_count, std::int32_t iteration,
+														std::int32_t generations) {
+	/// active tiles are tracked between single generations, so they are stepped one by one
+	const auto block_generations = MAX_BLOCK_HALO / std::max({reach_x_, reach_y_, 1});
+	if (active_tiles_ || block_generations < 2) {
+		CPUEngine::run(states, resolution, state_count, iteration, generations);
+		return;
+	}
+	for (std::int32_t generation = 0; generation < generations; generation += block_generations) {
+		const auto count = std::min(block_generations, generations - generation);
+		if (count == 1) {
+			step(states, resolution, state_count, iteration + generation);
+		} else {
+			stepBlock(states, resolution, state_count, count);
+		}
+	}
+}
+
+void CSIM::CPUEngine2D::stepBlock(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+																	std::int32_t state_count, std::int32_t generations) {
+	back_buffer_.resize(states.size());
+	const auto *src = states.data();
+	auto *dst = back_buffer_.data();
+
+	const auto halo_x = generations * reach_x_;
+	const auto halo_y = generations * reach_y_;
+	const auto buffer_size =
+			static_cast<std::size_t>(BLOCK_TILE_SIZE + 2 * MAX_BLOCK_HALO) *
+			static_cast<std::size_t>(BLOCK_TILE_SIZE + 2 * MAX_BLOCK_HALO);
+	block_buffers_.resize(thread_pool_->threadCount());
+	for (auto &buffer : block_buffers_) {
+		buffer.resize(2 * buffer_size);
+	}
+
+	const Vec2<std::int32_t> tile_count{(resolution.x + BLOCK_TILE_SIZE - 1) / BLOCK_TILE_SIZE,
+																			(resolution.y + BLOCK_TILE_SIZE - 1) / BLOCK_TILE_SIZE};
+	const auto tile_columns = static_cast<std::size_t>(tile_count.x);
+	thread_pool_->parallelForDynamic(
+			tile_columns * static_cast<std::size_t>(tile_count.y), 1,
+			[&](std::size_t begin, std::size_t end, std::size_t worker) {
+				auto *front = block_buffers_[worker].data();
+				auto *back = front + buffer_size; // NOLINT
+				for (auto tile = begin; tile < end; ++tile) {
+					const auto tile_x = static_cast<std::int32_t>(tile % tile_columns) * BLOCK_TILE_SIZE;
+					const auto tile_y = static_cast<std::int32_t>(tile / tile_columns) * BLOCK_TILE_SIZE;
+					const Vec2<std::int32_t> size{std::min(BLOCK_TILE_SIZE, resolution.x - tile_x),
+																				std::min(BLOCK_TILE_SIZE, resolution.y - tile_y)};
+					const Vec2<std::int32_t> local{size.x + 2 * halo_x, size.y + 2 * halo_y};
+
+					for (std::int32_t y = 0; y < local.y; ++y) {
+						const auto row = wrap(tile_y - halo_y + y, resolution.y);
+						const auto *src_row = src + static_cast<std::ptrdiff_t>(row) * resolution.x; // NOLINT
+						auto *local_row = front + static_cast<std::ptrdiff_t>(y) * local.x;					// NOLINT
+						copyWrapped(src_row, resolution.x, tile_x - halo_x, local.x, local_row);
+					}
+					/// cells closer than reach to the border of the valid area depend on cells outside
+					/// of it, so every generation leaves reach less cells on each side
+					for (std::int32_t generation = 1; generation <= generations; ++generation) {
+						processRect(front, back, local, state_count,
+												{generation * reach_x_, generation * reach_y_,
+												 local.x - generation * reach_x_, local.y - generation * reach_y_});
+						std::swap(front, back);
+					}
+					for (std::int32_t y = 0; y < size.y; ++y) {
+						const auto local_row = static_cast<std::ptrdiff_t>(y + halo_y) * local.x;
+						const auto dst_row = static_cast<std::ptrdiff_t>(tile_y + y) * resolution.x;
+						std::copy_n(front + local_row + halo_x, size.x, dst + dst_row + tile_x); // NOLINT
+					}
+				}
+			});
+
+	std::swap(states, back_buffer_);
+}
+
+void CSIM::CPUEngine2D::invalidate() noexcept {
+	if (active_tiles_) {
+		active_tiles_->invalidate();
+	}
+}
+
+void CSIM::CPUEngine2D::stepActiveTiles(const CellState *src, CellState *dst,
+																				Vec2<std::int32_t> resolution, std::int32_t state_count) {
+	/// transition depends on state count, previous activity says nothing after it changed
+	if (state_count != tracked_state_count_) {
+		active_tiles_->invalidate();
+		tracked_state_count_ = state_count;
+	}
+	active_tiles_->update(resolution);
+
+	/// back buffer holds the previous generation, quiescent tiles are equal in both buffers
+	const auto &tiles = active_tiles_->activeTiles();
+	thread_pool_->parallelForDynamic(
+			tiles.size(), 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+				for (auto i = begin; i < end; ++i) {
+					const auto bounds = active_tiles_->tileBounds(tiles[i]);
+					processRect(src, dst, resolution, state_count, bounds);
+					for (auto y = bounds.y; y < bounds.w; ++y) {
+						const auto row = static_cast<std::ptrdiff_t>(y) * resolution.x;
+						if (!std::equal(dst + row + bounds.x, dst + row + bounds.z, src + row + bounds.x)) {
+							active_tiles_->markChanged(tiles[i]);
+							break;
+						}
+					}
+				}
+			});
+}
+
+void CSIM::CPUEngine2D::processRect(const CellState *src, CellState *dst,
+																		Vec2<std::int32_t> resolution, std::int32_t state_count,
+																		Vec4<std::int32_t> bounds) const noexcept {
+	if (life_table_ && state_insensitive_) {
+		processRectTable<true>(src, dst, resolution, state_count, bounds);
+	} else if (life_table_) {
+		processRectTable<false>(src, dst, resolution, state_count, bounds);
+	} else if (state_insensitive_) {
+		processRect<true>(src, dst, resolution, state_count, bounds);
+	} else {
+		processRect<false>(src, dst, resolution, state_count, bounds);
+	}
+}
+
+template <bool STATE_INSENSITIVE>
+void CSIM::CPUEngine2D::processRect(const CellState *src, CellState *dst,
+																		Vec2<std::int32_t> resolution, std::int32_t state_count,
+																		Vec4<std::int32_t> bounds) const noexcept {
+	const auto width = resolution.x;
+	const auto height = resolution.y;
+	const auto offsets_count = offsets_.size();
+	/// rows of the band which are read through every offset, at most 441 offsets
+	constexpr std::size_t MAX_OFFSETS{
+			(2 * RuleConfig2DCyclic::RANGE_LIM.y + 1) * (2 * RuleConfig2DCyclic::RANGE_LIM.y + 1)};
+	std::array<const CellState *, MAX_OFFSETS> rows{};
+
+	const auto sum = [&](std::int32_t x, std::int32_t base_state, auto column) {
+		std::int32_t result{0};
+		for (std::size_t i = 0; i < offsets_count; ++i) {
+			const auto state = rows[i][column(x + offsets_[i].x)]; // NOLINT
+			if constexpr (STATE_INSENSITIVE) {
+				result += static_cast<std::int32_t>(state > 0);
+			} else {
+				result += static_cast<std::int32_t>(state == base_state + 1);
+			}
+		}
+		return result;
+	};
+	const auto inner_column = [](std::int32_t x) { return x; };
+	const auto wrapped_column = [width](std::int32_t x) { return wrap(x, width); };
+
+	/// same transition as in 2D_life/2D_cyclic compute shaders
+	const auto process = [&](const CellState *src_row, CellState *dst_row, std::int32_t x,
+													 auto column) {
+		const std::int32_t base_state = src_row[x]; // NOLINT
+		const auto cell_sum = static_cast<std::size_t>(sum(x, base_state, column));
+		auto new_state = base_state;
+		if (base_state > 0 || (wrap_states_ && base_state != 0)) {
+			if (survival_[cell_sum] != 0) {
+				new_state = base_state + 1;
+				if (new_state >= state_count) {
+					new_state = wrap_states_ ? 0 : base_state;
+				}
+			} else {
+				new_state = 0;
+			}
+		} else if (birth_[cell_sum] != 0) {
+			new_state = 1;
+		}
+		dst_row[x] = static_cast<CellState>(new_state); // NOLINT
+	};
+
+	/// columns near the borders wrap around, inner ones don't need to
+	const auto inner_begin = std::clamp(std::min(reach_x_, width), bounds.x, bounds.z);
+	const auto inner_end = std::clamp(std::max(inner_begin, width - reach_x_), inner_begin, bounds.z);
+	for (auto y = bounds.y; y < bounds.w; ++y) {
+		for (std::size_t i = 0; i < offsets_count; ++i) {
+			const auto row = wrap(y + offsets_[i].y, height);
+			rows[i] = src + static_cast<std::ptrdiff_t>(row) * width; // NOLINT
+		}
+		const auto *src_row = src + static_cast<std::ptrdiff_t>(y) * width; // NOLINT
+		auto *dst_row = dst + static_cast<std::ptrdiff_t>(y) * width;				// NOLINT
+
+		for (auto x = bounds.x; x < inner_begin; ++x) {
+			process(src_row, dst_row, x, wrapped_column);
+		}
+		for (std::int32_t x = inner_begin; x < inner_end; ++x) {
+			process(src_row, dst_row, x, inner_column);
+		}
+		for (auto x = inner_end; x < bounds.z; ++x) {
+			process(src_row, dst_row, x, wrapped_column);
+		}
+	}
+}
+
+template <bool STATE_INSENSITIVE>
+void CSIM::CPUEngine2D::processRectTable(const CellState *src, CellState *dst,
+																				 Vec2<std::int32_t> resolution, std::int32_t state_count,
+																				 Vec4<std::int32_t> bounds) const noexcept {
+	const auto width = resolution.x;
+	const auto height = resolution.y;
+	const auto &table = *life_table_;
+	/// pattern row of the bit at offset 3 * row within the pattern, see LifeTable
+	constexpr std::uint32_t ROW_BITS{3};
+
+	for (auto y = bounds.y; y < bounds.w; ++y) {
+		const std::array<const CellState *, 3> rows{
+				src + static_cast<std::ptrdiff_t>(wrap(y - 1, height)) * width, // NOLINT
+				src + static_cast<std::ptrdiff_t>(y) * width,										// NOLINT
+				src + static_cast<std::ptrdiff_t>(wrap(y + 1, height)) * width}; // NOLINT
+		auto *dst_row = dst + static_cast<std::ptrdiff_t>(y) * width; // NOLINT
+
+		if constexpr (STATE_INSENSITIVE) {
+			/// alive flags of a column of the neighbourhood, pattern slides along the row by dropping
+			/// the left column and adding the right one
+			const auto column = [&rows](std::int32_t x) {
+				return static_cast<std::uint32_t>(rows[0][x] > 0) |													 // NOLINT
+							 static_cast<std::uint32_t>(rows[1][x] > 0) << ROW_BITS |					 // NOLINT
+							 static_cast<std::uint32_t>(rows[2][x] > 0) << (2 * ROW_BITS); // NOLINT
+			};
+			const auto process = [&](std::int32_t x, std::uint32_t &pattern, std::int32_t right) {
+				pattern |= column(right) << 2u;
+				dst_row[x] = nextState(rows[1][x], state_count, -table[pattern]); // NOLINT
+				constexpr std::uint32_t KEEP_MASK{0xDBu}; /// first two columns of every row
+				pattern = (pattern >> 1u) & KEEP_MASK;
+			};
+
+			auto pattern = column(wrap(bounds.x - 1, width)) | column(bounds.x) << 1u;
+			const auto inner_end = std::min(bounds.z, width - 1);
+			auto x = bounds.x;
+			for (; x < inner_end; ++x) {
+				process(x, pattern, x + 1);
+			}
+			for (; x < bounds.z; ++x) {
+				process(x, pattern, wrap(x + 1, width));
+			}
+		} else {
+			/// neighbour counts if it is in the state after the center state, center bit is alive flag
+			const auto process = [&](std::int32_t x, std::int32_t left, std::int32_t right) {
+				const std::int32_t base_state = rows[1][x]; // NOLINT
+				const auto match = [next = base_state + 1](std::int32_t state) {
+					return static_cast<std::uint32_t>(state == next);
+				};
+				const auto alive = static_cast<std::uint32_t>(base_state > 0);
+				// NOLINTBEGIN pattern bits, see LifeTable
+				const auto pattern = match(rows[0][left]) | match(rows[0][x]) << 1u |
+														 match(rows[0][right]) << 2u | match(rows[1][left]) << 3u |
+														 alive << 4u | match(rows[1][right]) << 5u |
+														 match(rows[2][left]) << 6u | match(rows[2][x]) << 7u |
+														 match(rows[2][right]) << 8u;
+				// NOLINTEND
+				dst_row[x] = nextState(base_state, state_count, -table[pattern]); // NOLINT
+			};
+
+			/// columns near the borders wrap around, inner ones don't need to
+			const auto inner_begin = std::clamp(std::min(1, width), bounds.x, bounds.z);
+			const auto inner_end = std::clamp(std::max(inner_begin, width - 1), inner_begin, bounds.z);
+			for (auto x = bounds.x; x < inner_begin; ++x) {
+				process(x, wrap(x - 1, width), wrap(x + 1, width));
+			}
+			for (auto x = inner_begin; x < inner_end; ++x) {
+				process(x, x - 1, x + 1);
+			}
+			for (auto x = inner_end; x < bounds.z; ++x) {
+				process(x, wrap(x - 1, width), wrap(x + 1, width));
+			}
+		}
+	}
+}
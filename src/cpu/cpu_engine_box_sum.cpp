@@ -0,0 +1,266 @@
+#include "cpu/cpu_engine_box_sum.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+static std::int32_t wrap(std::int32_t value, std::int32_t extent) noexcept {
+	value %= extent;
+	return value < 0 ? value + extent : value;
+}
+
+/**
+ * same transition as in 2D_cyclic compute shader
+ */
+static std::int32_t cyclicTransition(std::int32_t base_state, std::int32_t sum,
+																		 std::int32_t threshold, std::int32_t state_count) noexcept {
+	if (sum < threshold) {
+		return 0;
+	}
+	if (base_state == 0) {
+		return 1;
+	}
+	return base_state + 1 >= state_count ? 0 : base_state + 1;
+}
+
+/**
+ * Evaluates one row of cells, kernel sum of cell x is sum of plus[i][x] - minus[i][x]. Tables are
+ * unsigned so that differences stay correct even if accumulated values overflow
+ */
+template <std::size_t TERMS>
+static void evaluateRow(const std::array<const std::uint32_t *, TERMS> &plus,
+												const std::array<const std::uint32_t *, TERMS> &minus,
+												const CSIM::utils::CellState *src, CSIM::utils::CellState *dst,
+												std::int32_t width, std::int32_t threshold, std::int32_t state_count,
+												bool center_active) noexcept {
+	std::int32_t x{0};
+	// NOLINTBEGIN intrinsics interface
+#if defined(__AVX2__)
+	const auto zero = _mm256_setzero_si256();
+	const auto one = _mm256_set1_epi32(1);
+	const auto threshold_bound = _mm256_set1_epi32(threshold - 1);
+	const auto state_bound = _mm256_set1_epi32(state_count);
+	/// packed bytes of 8 cells end up in the low dwords of both 128 bit lanes
+	const auto low_dwords = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+	for (; x + 8 <= width; x += 8) {
+		auto sum = zero;
+		for (std::size_t i = 0; i < TERMS; ++i) {
+			const auto added = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(plus[i] + x));
+			const auto removed = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(minus[i] + x));
+			sum = _mm256_sub_epi32(_mm256_add_epi32(sum, added), removed);
+		}
+		/// states are widened to 32 bits for the arithmetic and narrowed back when stored
+		const auto base =
+				_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + x)));
+		if (!center_active) {
+			/// center is part of the box, alive mask is -1
+			sum = _mm256_add_epi32(sum, _mm256_cmpgt_epi32(base, zero));
+		}
+		const auto reached = _mm256_cmpgt_epi32(sum, threshold_bound);
+		auto next = _mm256_add_epi32(base, one);
+		next = _mm256_and_si256(next, _mm256_cmpgt_epi32(state_bound, next));
+		const auto value = _mm256_blendv_epi8(next, one, _mm256_cmpeq_epi32(base, zero));
+		const auto words = _mm256_packs_epi32(_mm256_and_si256(reached, value), zero);
+		const auto bytes = _mm256_packus_epi16(words, zero);
+		const auto packed = _mm256_permutevar8x32_epi32(bytes, low_dwords);
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(dst + x), _mm256_castsi256_si128(packed));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const auto zero = _mm_setzero_si128();
+	const auto one = _mm_set1_epi32(1);
+	const auto threshold_bound = _mm_set1_epi32(threshold - 1);
+	const auto state_bound = _mm_set1_epi32(state_count);
+	for (; x + 4 <= width; x += 4) {
+		auto sum = zero;
+		for (std::size_t i = 0; i < TERMS; ++i) {
+			const auto added = _mm_loadu_si128(reinterpret_cast<const __m128i *>(plus[i] + x));
+			const auto removed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(minus[i] + x));
+			sum = _mm_sub_epi32(_mm_add_epi32(sum, added), removed);
+		}
+		/// states are widened to 32 bits for the arithmetic and narrowed back when stored
+		std::int32_t loaded{0};
+		std::memcpy(&loaded, src + x, sizeof(loaded));
+		const auto base =
+				_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(loaded), zero), zero);
+		if (!center_active) {
+			/// center is part of the box, alive mask is -1
+			sum = _mm_add_epi32(sum, _mm_cmpgt_epi32(base, zero));
+		}
+		const auto reached = _mm_cmpgt_epi32(sum, threshold_bound);
+		auto next = _mm_add_epi32(base, one);
+		next = _mm_and_si128(next, _mm_cmpgt_epi32(state_bound, next));
+		const auto dead = _mm_cmpeq_epi32(base, zero);
+		const auto value = _mm_or_si128(_mm_and_si128(dead, one), _mm_andnot_si128(dead, next));
+		const auto words = _mm_packs_epi32(_mm_and_si128(reached, value), zero);
+		const auto stored = _mm_cvtsi128_si32(_mm_packus_epi16(words, zero));
+		std::memcpy(dst + x, &stored, sizeof(stored));
+	}
+#endif
+	for (; x < width; ++x) {
+		std::uint32_t sum{0};
+		for (std::size_t i = 0; i < TERMS; ++i) {
+			sum += plus[i][x] - minus[i][x];
+		}
+		const auto base_state = src[x];
+		auto cell_sum = static_cast<std::int32_t>(sum);
+		if (!center_active && base_state > 0) {
+			--cell_sum;
+		}
+		dst[x] = static_cast<CSIM::utils::CellState>(
+				cyclicTransition(base_state, cell_sum, threshold, state_count));
+	}
+	// NOLINTEND
+}
+
+CSIM::CPUEngineBoxSum2D::CPUEngineBoxSum2D(const RuleConfig &rule_config,
+																					 std::shared_ptr<ThreadPool> thread_pool)
+		: thread_pool_(std::move(thread_pool)) {
+	if (!supports(rule_config)) {
+		throw std::invalid_argument(
+				"cpu box sum engine supports only state insensitive 2D cyclic rule configs");
+	}
+	const auto &cyclic_config = static_cast<const RuleConfig2DCyclic &>(rule_config);
+	range_ = cyclic_config.range();
+	moore_ = cyclic_config.moore();
+	center_active_ = cyclic_config.centerActive();
+	threshold_ = cyclic_config.config().threshold;
+}
+
+bool CSIM::CPUEngineBoxSum2D::supports(const RuleConfig &rule_config) noexcept {
+	if (rule_config.ruleConfigType() != RuleConfigType::CYCLIC_2D) {
+		return false;
+	}
+	const auto &cyclic_config = static_cast<const RuleConfig2DCyclic &>(rule_config);
+	return cyclic_config.config().state_insensitive != 0 && cyclic_config.range() >= MIN_RANGE;
+}
+
+void CSIM::CPUEngineBoxSum2D::step(std::vector<CellState> &states,
+																	 Vec2<std::int32_t> resolution, std::int32_t state_count,
+																	 std::int32_t /*iteration*/) {
+	back_buffer_.resize(states.size());
+	scratch_.resize(thread_pool_->threadCount());
+	const auto *src = states.data();
+	auto *dst = back_buffer_.data();
+
+	/// every chunk builds its own tables, so chunks are the unit of work stealing
+	thread_pool_->parallelForDynamic(
+			static_cast<std::size_t>(resolution.y), static_cast<std::size_t>(CHUNK_ROWS),
+			[&](std::size_t row_begin, std::size_t row_end, std::size_t worker) {
+				const auto end = static_cast<std::int32_t>(row_end);
+				for (auto begin = static_cast<std::int32_t>(row_begin); begin < end;
+						 begin += CHUNK_ROWS) {
+					processChunk(src, dst, resolution, state_count, begin,
+											 std::min(begin + CHUNK_ROWS, end), scratch_[worker]);
+				}
+			});
+
+	std::swap(states, back_buffer_);
+}
+
+void CSIM::CPUEngineBoxSum2D::processChunk(const CellState *src, CellState *dst,
+																					 Vec2<std::int32_t> resolution, std::int32_t state_count,
+																					 std::int32_t row_begin, std::int32_t row_end,
+																					 std::vector<std::uint32_t> &scratch) const noexcept {
+	// NOLINTBEGIN pointer arithmetic over scratch tables
+	const auto width = resolution.x;
+	const auto height = resolution.y;
+	const auto range = range_;
+	/// table column c holds prefix up to map column c - range - 1, table row j maps to
+	/// row_begin + j - range - 1
+	const auto table_width = static_cast<std::size_t>(width + 2 * range + 1);
+	const auto table_height = static_cast<std::size_t>(row_end - row_begin + 2 * range + 1);
+	const auto table_size = table_width * table_height;
+	const std::size_t table_count = moore_ ? 1 : 2;
+	scratch.resize(table_count * table_size + table_width);
+
+	/// moore: column sums of row prefixes, neumann: down-right (first) and down-left (second)
+	/// diagonal sums of row prefixes
+	auto *first = scratch.data();
+	auto *second = first + table_size;
+	auto *prefix = first + table_count * table_size;
+
+	for (std::size_t j = 0; j < table_height; ++j) {
+		const auto *src_row =
+				src + static_cast<std::ptrdiff_t>(
+									wrap(row_begin + static_cast<std::int32_t>(j) - range - 1, height)) *
+									width;
+		/// padding columns wrap around (possibly more than once), inner columns are copied
+		std::uint32_t running{0};
+		std::int32_t c{0};
+		for (; c <= range; ++c) {
+			running += static_cast<std::uint32_t>(src_row[wrap(c - range - 1, width)] > 0);
+			prefix[c] = running;
+		}
+		for (std::int32_t x = 0; x < width; ++x, ++c) {
+			running += static_cast<std::uint32_t>(src_row[x] > 0);
+			prefix[c] = running;
+		}
+		for (; c < static_cast<std::int32_t>(table_width); ++c) {
+			running += static_cast<std::uint32_t>(src_row[wrap(c - range - 1, width)] > 0);
+			prefix[c] = running;
+		}
+
+		auto *first_row = first + j * table_width;
+		if (j == 0) {
+			std::copy_n(prefix, table_width, first_row);
+			if (!moore_) {
+				std::copy_n(prefix, table_width, second);
+			}
+			continue;
+		}
+		const auto *first_prev = first_row - table_width;
+		if (moore_) {
+			for (std::size_t i = 0; i < table_width; ++i) {
+				first_row[i] = prefix[i] + first_prev[i];
+			}
+		} else {
+			auto *second_row = second + j * table_width;
+			const auto *second_prev = second_row - table_width;
+			first_row[0] = prefix[0];
+			for (std::size_t i = 1; i < table_width; ++i) {
+				first_row[i] = prefix[i] + first_prev[i - 1];
+			}
+			for (std::size_t i = 0; i + 1 < table_width; ++i) {
+				second_row[i] = prefix[i] + second_prev[i + 1];
+			}
+			second_row[table_width - 1] = prefix[table_width - 1];
+		}
+	}
+
+	const auto at = [table_width](const std::uint32_t *table, std::int32_t row,
+																std::int32_t column) {
+		return table + static_cast<std::size_t>(row) * table_width + static_cast<std::size_t>(column);
+	};
+	for (auto y = row_begin; y < row_end; ++y) {
+		/// table row and column (x + range + 1) of the evaluated cell
+		const auto j = y - row_begin + range + 1;
+		const auto *src_row = src + static_cast<std::ptrdiff_t>(y) * width;
+		auto *dst_row = dst + static_cast<std::ptrdiff_t>(y) * width;
+		if (moore_) {
+			/// box rows j - range ..= j + range, columns x - range ..= x + range
+			const std::array<const std::uint32_t *, 2> plus{at(first, j + range, 2 * range + 1),
+																											at(first, j - range - 1, 0)};
+			const std::array<const std::uint32_t *, 2> minus{at(first, j - range - 1, 2 * range + 1),
+																											 at(first, j + range, 0)};
+			evaluateRow(plus, minus, src_row, dst_row, width, threshold_, state_count, center_active_);
+		} else {
+			/// diamond row j + dy spans columns x - (range - |dy|) ..= x + (range - |dy|), right ends
+			/// lie on two diagonal segments of the prefix table, left ends (exclusive) on another two
+			const std::array<const std::uint32_t *, 4> plus{
+					at(first, j, 2 * range + 1), at(second, j + range, range + 1),
+					at(second, j - range - 1, range + 1), at(first, j, 0)};
+			const std::array<const std::uint32_t *, 4> minus{
+					at(first, j - range - 1, range), at(second, j, 2 * range + 1), at(second, j, 0),
+					at(first, j + range, range)};
+			evaluateRow(plus, minus, src_row, dst_row, width, threshold_, state_count, center_active_);
+		}
+	}
+	// NOLINTEND
+}
@@ -0,0 +1,263 @@
+#include "cpu/cpu_engine_life_swar.hpp"
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+
+static constexpr std::size_t WORD_BITS{64};
+static constexpr std::uint64_t ALL_ONES{~static_cast<std::uint64_t>(0)};
+
+struct FullAdderResult {
+	std::uint64_t sum;	 /*!< weight 1 */
+	std::uint64_t carry; /*!< weight 2 */
+};
+
+/// full adder operating on 64 independent lanes
+static FullAdderResult fullAdd(std::uint64_t a, std::uint64_t b, std::uint64_t c) noexcept {
+	const auto a_xor_b = a ^ b;
+	return {a_xor_b ^ c, (a & b) | (c & a_xor_b)};
+}
+
+CSIM::CPUEngineLifeSWAR::CPUEngineLifeSWAR(const RuleConfig &rule_config,
+																					 std::shared_ptr<ThreadPool> thread_pool,
+																					 bool active_tiles)
+		: thread_pool_(std::move(thread_pool)) {
+	if (!supports(rule_config, 2)) {
+		throw std::invalid_argument("swar engine supports only state insensitive 2D life configs");
+	}
+	const auto &config = static_cast<const RuleConfig2DLife &>(rule_config).config();
+	const auto offsets =
+			std::span(config.offsets).first(static_cast<std::size_t>(config.offsets_count));
+
+	input_selectors_.fill(static_cast<std::uint8_t>(KERNEL_SIZE));
+	std::transform(offsets.begin(), offsets.end(), input_selectors_.begin(),
+								 [](Vec4<std::int32_t> offset) {
+									 return static_cast<std::uint8_t>((offset.y + 1) * 3 + (offset.x + 1));
+								 });
+
+	const auto survival = std::span(config.survival_conditions_hashmap);
+	const auto birth = std::span(config.birth_conditions_hashmap);
+	for (std::size_t sum = 0; sum <= offsets.size(); ++sum) {
+		if (survival[sum] == 0 && birth[sum] == 0) {
+			continue;
+		}
+		SumCondition condition{};
+		for (std::size_t bit = 0; bit < condition.count_masks.size(); ++bit) {
+			condition.count_masks[bit] = ((sum >> bit) & 1u) != 0 ? ALL_ONES : 0;
+		}
+		condition.survival_mask = survival[sum] != 0 ? ALL_ONES : 0;
+		condition.birth_mask = birth[sum] != 0 ? ALL_ONES : 0;
+		sum_conditions_.push_back(condition);
+	}
+
+	if (active_tiles) {
+		active_tiles_.emplace(Vec2<std::int32_t>{1, TILE_ROWS}, Vec2<std::int32_t>{1, 1});
+	}
+}
+
+bool CSIM::CPUEngineLifeSWAR::supports(const RuleConfig &rule_config,
+																			 std::int32_t state_count) noexcept {
+	if (rule_config.ruleConfigType() != RuleConfigType::LIFE_2D || state_count > 2) {
+		return false;
+	}
+	const auto &config = static_cast<const RuleConfig2DLife &>(rule_config).config();
+	if (config.state_insensitive == 0 ||
+			config.offsets_count > static_cast<std::int32_t>(KERNEL_SIZE)) {
+		return false;
+	}
+	const auto offsets =
+			std::span(config.offsets).first(static_cast<std::size_t>(config.offsets_count));
+	return std::all_of(offsets.begin(), offsets.end(), [](Vec4<std::int32_t> offset) {
+		return offset.x >= -1 && offset.x <= 1 && offset.y >= -1 && offset.y <= 1;
+	});
+}
+
+void CSIM::CPUEngineLifeSWAR::step(std::vector<CellState> &states,
+																	 Vec2<std::int32_t> resolution, std::int32_t state_count,
+																	 std::int32_t iteration) {
+	run(states, resolution, state_count, iteration, 1);
+}
+
+void CSIM::CPUEngineLifeSWAR::run(std::vector<CellState> &states,
+																	Vec2<std::int32_t> resolution, std::int32_t /*state_count*/,
+																	std::int32_t /*iteration*/, std::int32_t generations) {
+	if (resolution.x <= 0 || resolution.y <= 0 || generations <= 0) {
+		return;
+	}
+	/// in active tile mode nothing else touched the states since the last run, unless invalidated
+	if (!packed_valid_ || resolution.x != packed_resolution_.x ||
+			resolution.y != packed_resolution_.y) {
+		pack(states, resolution);
+		if (active_tiles_) {
+			active_tiles_->invalidate();
+		}
+	} else {
+		initial_ = front_;
+		continuous_ = front_;
+	}
+
+	for (std::int32_t generation = 0; generation < generations; ++generation) {
+		if (active_tiles_) {
+			stepActiveTiles(resolution);
+		} else {
+			thread_pool_->parallelForDynamic(
+					static_cast<std::size_t>(resolution.y), ROW_GRAIN,
+					[this, resolution](std::size_t row_begin, std::size_t row_end, std::size_t) {
+						processWords(resolution, {0, static_cast<std::int32_t>(row_begin),
+																			static_cast<std::int32_t>(words_per_row_),
+																			static_cast<std::int32_t>(row_end)});
+					});
+		}
+		std::swap(front_, back_);
+	}
+
+	unpack(states, resolution);
+	packed_valid_ = active_tiles_.has_value();
+	packed_resolution_ = resolution;
+}
+
+void CSIM::CPUEngineLifeSWAR::invalidate() noexcept {
+	packed_valid_ = false;
+}
+
+void CSIM::CPUEngineLifeSWAR::stepActiveTiles(Vec2<std::int32_t> resolution) {
+	active_tiles_->update({static_cast<std::int32_t>(words_per_row_), resolution.y});
+
+	/// back map holds the previous generation, quiescent tiles are equal in both maps
+	const auto &tiles = active_tiles_->activeTiles();
+	thread_pool_->parallelForDynamic(
+			tiles.size(), 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+				for (auto i = begin; i < end; ++i) {
+					if (processWords(resolution, active_tiles_->tileBounds(tiles[i]))) {
+						active_tiles_->markChanged(tiles[i]);
+					}
+				}
+			});
+}
+
+void CSIM::CPUEngineLifeSWAR::pack(const std::vector<CellState> &states,
+																	 Vec2<std::int32_t> resolution) {
+	const auto width = static_cast<std::size_t>(resolution.x);
+	const auto height = static_cast<std::size_t>(resolution.y);
+	words_per_row_ = (width + WORD_BITS - 1) / WORD_BITS;
+	last_bit_ = static_cast<std::uint32_t>((width - 1) % WORD_BITS);
+	last_word_mask_ = ALL_ONES >> (WORD_BITS - 1 - last_bit_);
+
+	front_.resize(words_per_row_ * height);
+	back_.resize(words_per_row_ * height);
+
+	thread_pool_->parallelFor(height, [&](std::size_t row_begin, std::size_t row_end, std::size_t) {
+		for (std::size_t y = row_begin; y < row_end; ++y) {
+			const auto row = std::span(states).subspan(y * width, width);
+			for (std::size_t word_i = 0; word_i < words_per_row_; ++word_i) {
+				const auto cells = row.subspan(word_i * WORD_BITS,
+																			 std::min(WORD_BITS, width - word_i * WORD_BITS));
+				std::uint64_t word{0};
+				for (std::size_t bit = 0; bit < cells.size(); ++bit) {
+					word |= static_cast<std::uint64_t>(cells[bit] > 0) << bit;
+				}
+				front_[y * words_per_row_ + word_i] = word;
+			}
+		}
+	});
+
+	initial_ = front_;
+	continuous_ = front_;
+}
+
+void CSIM::CPUEngineLifeSWAR::unpack(std::vector<CellState> &states,
+																		 Vec2<std::int32_t> resolution) {
+	const auto width = static_cast<std::size_t>(resolution.x);
+	const auto height = static_cast<std::size_t>(resolution.y);
+
+	thread_pool_->parallelFor(height, [&](std::size_t row_begin, std::size_t row_end, std::size_t) {
+		for (std::size_t y = row_begin; y < row_end; ++y) {
+			const auto row = std::span(states).subspan(y * width, width);
+			for (std::size_t word_i = 0; word_i < words_per_row_; ++word_i) {
+				const auto index = y * words_per_row_ + word_i;
+				const auto word = front_[index];
+				const auto continuous = continuous_[index];
+				/// no cell changed and no cell died and got born again, host states are up to date
+				if (word == initial_[index] && continuous == initial_[index]) {
+					continue;
+				}
+				const auto cells = row.subspan(word_i * WORD_BITS,
+																			 std::min(WORD_BITS, width - word_i * WORD_BITS));
+				for (std::size_t bit = 0; bit < cells.size(); ++bit) {
+					if (((word >> bit) & 1u) == 0) {
+						cells[bit] = 0;
+					} else if (((continuous >> bit) & 1u) == 0) {
+						cells[bit] = 1;
+					} /// cell alive during whole run keeps its state (same as in 2D_life shader)
+				}
+			}
+		}
+	});
+}
+
+bool CSIM::CPUEngineLifeSWAR::processWords(Vec2<std::int32_t> resolution,
+																					 Vec4<std::int32_t> bounds) noexcept {
+	const auto height = static_cast<std::size_t>(resolution.y);
+	const auto last_word = words_per_row_ - 1;
+	bool changed{false};
+
+	for (auto y = static_cast<std::size_t>(bounds.y); y < static_cast<std::size_t>(bounds.w); ++y) {
+		const std::array<const std::uint64_t *, 3> rows{
+				&front_[((y + height - 1) % height) * words_per_row_],
+				&front_[y * words_per_row_],
+				&front_[((y + 1) % height) * words_per_row_],
+		};
+		auto *dst = &back_[y * words_per_row_];
+		auto *continuous = &continuous_[y * words_per_row_];
+
+		for (auto word_i = static_cast<std::size_t>(bounds.x);
+				 word_i < static_cast<std::size_t>(bounds.z); ++word_i) {
+			/// west, center and east shifted words of rows above, current and below. Cells shifted
+			/// over the row border come from the opposite side of the row (torus topology)
+			std::array<std::uint64_t, KERNEL_SIZE + 1> shifted; // NOLINT initialized below
+			for (std::size_t r = 0; r < rows.size(); ++r) {
+				const auto *row = rows[r]; // NOLINT
+				const auto word = row[word_i]; // NOLINT
+				const auto carry_west =
+						word_i == 0 ? (row[last_word] >> last_bit_) & 1u : row[word_i - 1] >> 63u; // NOLINT
+				const auto carry_east =
+						word_i == last_word ? (row[0] & 1u) << last_bit_ : row[word_i + 1] << 63u; // NOLINT
+				shifted[r * 3 + 0] = (word << 1u) | carry_west;
+				shifted[r * 3 + 1] = word;
+				shifted[r * 3 + 2] = (word >> 1u) | carry_east;
+			}
+			shifted[KERNEL_SIZE] = 0;
+
+			const auto input = [&](std::size_t i) { return shifted[input_selectors_[i]]; };
+			/// adder tree summing up to 9 one bit inputs into 4 bit count
+			const auto a = fullAdd(input(0), input(1), input(2));
+			const auto b = fullAdd(input(3), input(4), input(5));
+			const auto c = fullAdd(input(6), input(7), input(8));
+			const auto ones = fullAdd(a.sum, b.sum, c.sum);
+			const auto twos = fullAdd(a.carry, b.carry, c.carry);
+			const auto twos_carry = twos.sum & ones.carry;
+			const std::array<std::uint64_t, 4> count{
+					ones.sum,
+					twos.sum ^ ones.carry,
+					twos.carry ^ twos_carry,
+					twos.carry & twos_carry,
+			};
+
+			const auto alive = rows[1][word_i]; // NOLINT
+			std::uint64_t next{0};
+			for (const auto &condition : sum_conditions_) {
+				const auto match =
+						~((count[0] ^ condition.count_masks[0]) | (count[1] ^ condition.count_masks[1]) |
+							(count[2] ^ condition.count_masks[2]) | (count[3] ^ condition.count_masks[3]));
+				next |= match & ((alive & condition.survival_mask) | (~alive & condition.birth_mask));
+			}
+			if (word_i == last_word) {
+				next &= last_word_mask_;
+			}
+			dst[word_i] = next;						// NOLINT
+			continuous[word_i] &= next; // NOLINT
+			changed |= next != alive;
+		}
+	}
+	return changed;
+}
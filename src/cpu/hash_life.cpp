@@ -0,0 +1,429 @@
+#include "cpu/hash_life.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <stdexcept>
+
+static constexpr std::size_t NW{0};
+static constexpr std::size_t NE{1};
+static constexpr std::size_t SW{2};
+static constexpr std::size_t SE{3};
+
+static constexpr std::size_t MIN_NODE_CAPACITY{1u << 16u};
+
+/**
+ * @return 4x4 cells of 8x8 grid (bit y * 8 + x) starting at x, y as leaf bitmap (bit y * 4 + x)
+ */
+static std::uint32_t window4x4(std::uint64_t grid, std::uint32_t x, std::uint32_t y) noexcept {
+	constexpr std::uint64_t ROW_MASK{0xF};
+	std::uint32_t bits{0};
+	for (std::uint32_t row = 0; row < 4; ++row) {
+		bits |= static_cast<std::uint32_t>((grid >> ((y + row) * 8 + x)) & ROW_MASK) << (row * 4);
+	}
+	return bits;
+}
+
+/**
+ * places 2x2 cells (bit y * 2 + x) into grid with given row stride at x, y
+ */
+static std::uint64_t place2x2(std::uint32_t cells, std::uint32_t stride, std::uint32_t x,
+															std::uint32_t y) noexcept {
+	std::uint64_t bits{0};
+	for (std::uint32_t j = 0; j < 2; ++j) {
+		for (std::uint32_t i = 0; i < 2; ++i) {
+			bits |= static_cast<std::uint64_t>((cells >> (j * 2 + i)) & 1u) << ((y + j) * stride + x + i);
+		}
+	}
+	return bits;
+}
+
+static bool supportsRuleConfig(const CSIM::RuleConfig &rule_config) noexcept {
+	if (rule_config.ruleConfigType() != CSIM::RuleConfigType::LIFE_2D) {
+		return false;
+	}
+	const auto &config = static_cast<const CSIM::RuleConfig2DLife &>(rule_config).config();
+	if (config.state_insensitive == 0) {
+		return false;
+	}
+	const auto offsets =
+			std::span(config.offsets).first(static_cast<std::size_t>(config.offsets_count));
+	return std::all_of(offsets.begin(), offsets.end(), [](CSIM::Vec4<std::int32_t> offset) {
+		return offset.x >= -1 && offset.x <= 1 && offset.y >= -1 && offset.y <= 1;
+	});
+}
+
+std::size_t CSIM::HashLife::NodeKeyHash::operator()(const NodeKey &key) const noexcept {
+	/// splitmix64 finalizer over the children
+	std::uint64_t hash{key.level};
+	for (const auto child : key.children) {
+		hash = (hash ^ child) * 0x9E3779B97F4A7C15ull; // NOLINT
+		hash ^= hash >> 31u;													 // NOLINT
+	}
+	return hash;
+}
+
+CSIM::HashLife::HashLife(const RuleConfig &rule_config, std::size_t memory_budget)
+		: memory_budget_(memory_budget),
+			node_capacity_(std::max(memory_budget / bytesPerNode(), MIN_NODE_CAPACITY)) {
+	if (!supportsRuleConfig(rule_config)) {
+		throw std::invalid_argument("hashlife supports only state insensitive range 1 2D life configs");
+	}
+	const auto &config = static_cast<const RuleConfig2DLife &>(rule_config).config();
+	const auto offsets =
+			std::span(config.offsets).first(static_cast<std::size_t>(config.offsets_count));
+	const auto survival = std::span(config.survival_conditions_hashmap);
+	const auto birth = std::span(config.birth_conditions_hashmap);
+
+	/// same transition as in 2D_life compute shader restricted to two states
+	for (std::uint32_t cells = 0; cells < leaf_step_.size(); ++cells) {
+		std::uint8_t next{0};
+		for (std::uint32_t y = 1; y < 3; ++y) {
+			for (std::uint32_t x = 1; x < 3; ++x) {
+				std::size_t sum{0};
+				for (const auto offset : offsets) {
+					const auto bit = (y + static_cast<std::uint32_t>(offset.y)) * 4 + x +
+													 static_cast<std::uint32_t>(offset.x);
+					sum += (cells >> bit) & 1u;
+				}
+				const auto alive = ((cells >> (y * 4 + x)) & 1u) != 0;
+				if ((alive ? survival[sum] : birth[sum]) != 0) {
+					next |= static_cast<std::uint8_t>(1u << ((y - 1) * 2 + x - 1));
+				}
+			}
+		}
+		leaf_step_[cells] = next; // NOLINT
+	}
+}
+
+bool CSIM::HashLife::supports(const RuleConfig &rule_config, std::int32_t state_count,
+															Vec2<std::int32_t> resolution) noexcept {
+	return state_count <= 2 && resolution.x > 0 && resolution.y > 0 &&
+				 std::has_single_bit(static_cast<std::uint32_t>(resolution.x)) &&
+				 std::has_single_bit(static_cast<std::uint32_t>(resolution.y)) &&
+				 supportsRuleConfig(rule_config);
+}
+
+void CSIM::HashLife::advance(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+														 std::uint32_t power) {
+	if (power > MAX_POWER) {
+		throw std::invalid_argument("hashlife jump power exceeds MAX_POWER");
+	}
+	advanceBy(states, resolution, std::uint64_t{1} << power);
+}
+
+void CSIM::HashLife::advanceBy(std::vector<CellState> &states, Vec2<std::int32_t> resolution,
+															 std::uint64_t generations) {
+	if (generations == 0) {
+		return;
+	}
+	/// garbage collection could have raised the capacity over the budget during previous call
+	node_capacity_ = std::max(memory_budget_ / bytesPerNode(), MIN_NODE_CAPACITY);
+	if (memoryUsage() > memory_budget_) {
+		clear();
+	}
+
+	/// map is tiled up to power of two square, it stays periodic since extents divide its side
+	const auto side = std::max(resolution.x, resolution.y);
+	const auto map_level =
+			std::max<std::uint32_t>(MIN_MAP_LEVEL, std::bit_width(static_cast<std::uint32_t>(side) - 1));
+	auto map = build(states, resolution, 0, 0, map_level);
+	for (std::uint32_t power = 0; power <= MAX_POWER; ++power) {
+		if (((generations >> power) & 1u) != 0) {
+			pins_.assign(1, map);
+			map = advanceMap(map, power);
+		}
+	}
+	pins_.clear();
+
+	write(map, states, resolution, 0, 0);
+}
+
+void CSIM::HashLife::setMemoryBudget(std::size_t memory_budget) noexcept {
+	memory_budget_ = memory_budget;
+	node_capacity_ = std::max(memory_budget_ / bytesPerNode(), MIN_NODE_CAPACITY);
+}
+
+void CSIM::HashLife::clear() noexcept {
+	/// nothing is referenced between advance calls, whole cache can be released
+	cache_ = {};
+	nodes_ = {};
+	free_nodes_ = {};
+}
+
+std::size_t CSIM::HashLife::memoryUsage() const noexcept {
+	return nodes_.capacity() * sizeof(Node) +
+				 cache_.size() * (bytesPerNode() - sizeof(Node) - sizeof(void *)) +
+				 cache_.bucket_count() * sizeof(void *);
+}
+
+std::size_t CSIM::HashLife::bytesPerNode() noexcept {
+	/// node, cache entry with its link and bucket pointer
+	return sizeof(Node) + sizeof(std::pair<const NodeKey, NodeId>) + 2 * sizeof(void *);
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::makeLeaf(std::uint32_t bits) {
+	return insert({LEAF_LEVEL, {bits, 0, 0, 0}});
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::makeNode(NodeId nw, NodeId ne, NodeId sw, NodeId se) {
+	return insert({level(nw) + 1, {nw, ne, sw, se}});
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::insert(const NodeKey &key) {
+	if (const auto it = cache_.find(key); it != cache_.end()) {
+		return it->second;
+	}
+	if (cache_.size() >= node_capacity_) {
+		collectGarbage();
+	}
+
+	NodeId node;
+	if (free_nodes_.empty()) {
+		node = static_cast<NodeId>(nodes_.size());
+		nodes_.emplace_back();
+	} else {
+		node = free_nodes_.back();
+		free_nodes_.pop_back();
+	}
+	nodes_[node] = {key.children, INVALID_NODE, key.level, false};
+	cache_.emplace(key, node);
+	return node;
+}
+
+void CSIM::HashLife::collectGarbage() {
+	for (const auto node : pins_) {
+		mark(node);
+	}
+	/// memoized results aren't roots, they are dropped so that no result points at a freed node
+	std::erase_if(cache_, [this](const auto &entry) {
+		auto &node = nodes_[entry.second];
+		node.result = INVALID_NODE;
+		if (node.marked) {
+			node.marked = false;
+			return false;
+		}
+		free_nodes_.push_back(entry.second);
+		return true;
+	});
+	/// pinned nodes alone don't fit into the budget, let the cache grow instead of thrashing
+	if (cache_.size() > node_capacity_ / 2) {
+		node_capacity_ = cache_.size() * 2;
+	}
+}
+
+void CSIM::HashLife::mark(NodeId node) noexcept {
+	auto &entry = nodes_[node];
+	if (entry.marked) {
+		return;
+	}
+	entry.marked = true;
+	if (entry.level > LEAF_LEVEL) {
+		for (const auto quadrant : entry.children) {
+			mark(quadrant);
+		}
+	}
+}
+
+std::uint64_t CSIM::HashLife::gather8x8(NodeId node) const noexcept {
+	constexpr std::uint64_t ROW_MASK{0xF};
+	std::uint64_t grid{0};
+	for (std::size_t quadrant = 0; quadrant < 4; ++quadrant) {
+		const auto cells = child(child(node, quadrant), NW);
+		const auto x = static_cast<std::uint32_t>((quadrant & 1u) * 4);
+		const auto y = static_cast<std::uint32_t>((quadrant >> 1u) * 4);
+		for (std::uint32_t row = 0; row < 4; ++row) {
+			grid |= ((cells >> (row * 4)) & ROW_MASK) << ((y + row) * 8 + x);
+		}
+	}
+	return grid;
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::result(NodeId node) {
+	if (nodes_[node].result != INVALID_NODE) {
+		return nodes_[node].result;
+	}
+	const auto node_level = level(node);
+	if (node_level == LEAF_LEVEL + 1) {
+		const auto next = leafResult(node);
+		nodes_[node].result = next;
+		return next;
+	}
+
+	/// every intermediate node has to survive garbage collection triggered by nested calls
+	const auto pins_size = pins_.size();
+	const auto pin = [this](NodeId pinned) {
+		pins_.push_back(pinned);
+		return pinned;
+	};
+	const auto nw = child(node, NW);
+	const auto ne = child(node, NE);
+	const auto sw = child(node, SW);
+	const auto se = child(node, SE);
+
+	/// 3x3 overlapping subnodes, each advanced by half of the node's time span at full speed or by
+	/// 2^step_power_ otherwise
+	const auto n00 = pin(result(nw));
+	const auto n01 = pin(result(pin(centeredHorizontal(nw, ne))));
+	const auto n02 = pin(result(ne));
+	const auto n10 = pin(result(pin(centeredVertical(nw, sw))));
+	const auto n11 = pin(result(pin(centered(node))));
+	const auto n12 = pin(result(pin(centeredVertical(ne, se))));
+	const auto n20 = pin(result(sw));
+	const auto n21 = pin(result(pin(centeredHorizontal(sw, se))));
+	const auto n22 = pin(result(se));
+
+	const std::array<NodeId, 4> quadrants{
+			pin(makeNode(n00, n01, n10, n11)), pin(makeNode(n01, n02, n11, n12)),
+			pin(makeNode(n10, n11, n20, n21)), pin(makeNode(n11, n12, n21, n22))};
+	std::array<NodeId, 4> next_quadrants{};
+	/// at full speed quadrants are advanced once more, otherwise only their centers are taken
+	const auto full_speed = node_level <= step_power_ + 2;
+	for (std::size_t quadrant = 0; quadrant < 4; ++quadrant) {
+		next_quadrants[quadrant] =
+				pin(full_speed ? result(quadrants[quadrant]) : centered(quadrants[quadrant]));
+	}
+	const auto next =
+			makeNode(next_quadrants[NW], next_quadrants[NE], next_quadrants[SW], next_quadrants[SE]);
+
+	pins_.resize(pins_size);
+	nodes_[node].result = next;
+	return next;
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::leafResult(NodeId node) {
+	const auto grid = gather8x8(node);
+	std::uint64_t cells{0};
+	if (step_power_ == 0) {
+		/// center 4x4 after one generation from four 4x4 windows
+		for (std::uint32_t y = 1; y < 4; y += 2) {
+			for (std::uint32_t x = 1; x < 4; x += 2) {
+				cells |= place2x2(leaf_step_[window4x4(grid, x, y)], 4, x - 1, y - 1);
+			}
+		}
+	} else {
+		/// center 6x6 after first generation, then center 4x4 after second one
+		std::uint64_t inner{0};
+		for (std::uint32_t y = 0; y < 6; y += 2) {
+			for (std::uint32_t x = 0; x < 6; x += 2) {
+				inner |= place2x2(leaf_step_[window4x4(grid, x, y)], 8, x, y);
+			}
+		}
+		for (std::uint32_t y = 0; y < 4; y += 2) {
+			for (std::uint32_t x = 0; x < 4; x += 2) {
+				cells |= place2x2(leaf_step_[window4x4(inner, x, y)], 4, x, y);
+			}
+		}
+	}
+	return makeLeaf(static_cast<std::uint32_t>(cells));
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::centered(NodeId node) {
+	if (level(node) == LEAF_LEVEL + 1) {
+		constexpr std::uint32_t OFFSET{2};
+		return makeLeaf(window4x4(gather8x8(node), OFFSET, OFFSET));
+	}
+	return makeNode(child(child(node, NW), SE), child(child(node, NE), SW),
+									child(child(node, SW), NE), child(child(node, SE), NW));
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::centeredHorizontal(NodeId west, NodeId east) {
+	return makeNode(child(west, NE), child(east, NW), child(west, SE), child(east, SW));
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::centeredVertical(NodeId north, NodeId south) {
+	return makeNode(child(north, SW), child(north, SE), child(south, NW), child(south, NE));
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::build(const std::vector<CellState> &states,
+																						 Vec2<std::int32_t> resolution, std::int32_t x,
+																						 std::int32_t y, std::uint32_t node_level) {
+	if (node_level == LEAF_LEVEL) {
+		std::uint32_t cells{0};
+		for (std::int32_t row = 0; row < 4; ++row) {
+			const auto offset = static_cast<std::size_t>(((y + row) % resolution.y) * resolution.x);
+			for (std::int32_t column = 0; column < 4; ++column) {
+				if (states[offset + static_cast<std::size_t>((x + column) % resolution.x)] > 0) {
+					cells |= 1u << static_cast<std::uint32_t>(row * 4 + column);
+				}
+			}
+		}
+		return makeLeaf(cells);
+	}
+	const auto half = std::int32_t{1} << (node_level - 1);
+	const auto pins_size = pins_.size();
+	std::array<NodeId, 4> quadrants{};
+	for (std::size_t quadrant = 0; quadrant < 4; ++quadrant) {
+		const auto quadrant_x = x + static_cast<std::int32_t>(quadrant & 1u) * half;
+		const auto quadrant_y = y + static_cast<std::int32_t>(quadrant >> 1u) * half;
+		quadrants[quadrant] = build(states, resolution, quadrant_x, quadrant_y, node_level - 1);
+		pins_.push_back(quadrants[quadrant]);
+	}
+	const auto node = makeNode(quadrants[NW], quadrants[NE], quadrants[SW], quadrants[SE]);
+	pins_.resize(pins_size);
+	return node;
+}
+
+void CSIM::HashLife::write(NodeId node, std::vector<CellState> &states,
+													 Vec2<std::int32_t> resolution, std::int32_t x,
+													 std::int32_t y) const noexcept {
+	if (x >= resolution.x || y >= resolution.y) {
+		return;
+	}
+	const auto node_level = level(node);
+	if (node_level == LEAF_LEVEL) {
+		const auto cells = child(node, NW);
+		for (std::int32_t row = 0; row < 4 && y + row < resolution.y; ++row) {
+			for (std::int32_t column = 0; column < 4 && x + column < resolution.x; ++column) {
+				auto &state = states[static_cast<std::size_t>((y + row) * resolution.x + x + column)];
+				if (((cells >> static_cast<std::uint32_t>(row * 4 + column)) & 1u) != 0) {
+					state = state > 0 ? state : CellState{1};
+				} else {
+					state = 0;
+				}
+			}
+		}
+		return;
+	}
+	const auto half = std::int32_t{1} << (node_level - 1);
+	for (std::size_t quadrant = 0; quadrant < 4; ++quadrant) {
+		write(child(node, quadrant), states, resolution,
+					x + static_cast<std::int32_t>(quadrant & 1u) * half,
+					y + static_cast<std::int32_t>(quadrant >> 1u) * half);
+	}
+}
+
+CSIM::HashLife::NodeId CSIM::HashLife::advanceMap(NodeId map, std::uint32_t power) {
+	setStepPower(power);
+	const auto map_level = level(map);
+	/// root tiled from the map has result offset by multiple of map side, so its corner subnode of
+	/// the map level is the advanced map
+	const auto root_level = std::max(map_level, power) + 2;
+	const auto pins_size = pins_.size();
+	auto root = map;
+	pins_.push_back(root);
+	while (level(root) < root_level) {
+		root = makeNode(root, root, root, root);
+		pins_.push_back(root);
+	}
+	auto next = result(root);
+	while (level(next) > map_level) {
+		next = child(next, NW);
+	}
+	pins_.resize(pins_size);
+	return next;
+}
+
+void CSIM::HashLife::setStepPower(std::uint32_t power) noexcept {
+	if (power == step_power_) {
+		return;
+	}
+	/// nodes up to level step + 2 always memoize full speed results, those stay valid
+	const auto valid_level = std::min(power, step_power_) + 2;
+	for (const auto &entry : cache_) {
+		if (nodes_[entry.second].level > valid_level) {
+			nodes_[entry.second].result = INVALID_NODE;
+		}
+	}
+	step_power_ = power;
+}
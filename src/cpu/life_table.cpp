@@ -0,0 +1,30 @@
+#include "cpu/life_table.hpp"
+
+#include <span>
+
+CSIM::LifeTable CSIM::LifeTable::compile(const RuleConfig2DLife &rule_config) {
+	const auto &config = rule_config.config();
+	std::uint32_t kernel{0};
+	for (const auto offset :
+			 std::span(config.offsets).first(static_cast<std::size_t>(config.offsets_count))) {
+		kernel |= 1u << static_cast<std::uint32_t>((offset.y + 1) * 3 + offset.x + 1);
+	}
+	/// range 1 kernels have at most 9 offsets
+	std::uint32_t survival{0};
+	std::uint32_t birth{0};
+	for (std::uint32_t sum = 0; sum <= 9; ++sum) {
+		// NOLINTBEGIN interfacing with gl
+		survival |= static_cast<std::uint32_t>(config.survival_conditions_hashmap[sum] != 0) << sum;
+		birth |= static_cast<std::uint32_t>(config.birth_conditions_hashmap[sum] != 0) << sum;
+		// NOLINTEND
+	}
+	const auto state_insensitive = config.state_insensitive != 0;
+
+	for (const auto *table :
+			 {&CONWAY_LIFE_TABLE, &HIGH_LIFE_TABLE, &DAY_AND_NIGHT_TABLE, &SEEDS_TABLE}) {
+		if (table->compiledFrom(kernel, survival, birth, state_insensitive)) {
+			return *table;
+		}
+	}
+	return {kernel, survival, birth, state_insensitive};
+}
@@ -0,0 +1,220 @@
+#include "cpu/thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+static constexpr std::uint64_t HALF_BITS{32};
+static constexpr std::uint64_t HALF_MASK{(std::uint64_t{1} << HALF_BITS) - 1};
+
+static std::uint64_t packRange(std::uint64_t begin, std::uint64_t end) noexcept {
+	return begin | (end << HALF_BITS);
+}
+
+static std::pair<std::size_t, std::size_t> unpackRange(std::uint64_t range) noexcept {
+	return {range & HALF_MASK, range >> HALF_BITS};
+}
+
+static std::uint64_t nanoseconds(std::chrono::steady_clock::duration duration) noexcept {
+	return static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+CSIM::ThreadPool::ThreadPool(std::size_t thread_count) {
+	const auto worker_count = std::max(thread_count, static_cast<std::size_t>(1)) - 1;
+	worker_states_ = std::make_unique<Worker[]>(worker_count + 1); // NOLINT
+	workers_.reserve(worker_count);
+	for (std::size_t worker = 1; worker <= worker_count; ++worker) {
+		workers_.emplace_back(&ThreadPool::workerLoop, this, worker);
+	}
+}
+
+void CSIM::ThreadPool::parallelFor(std::size_t item_count, const Task &task) {
+	dispatch(item_count, 0, task);
+}
+
+void CSIM::ThreadPool::parallelForDynamic(std::size_t item_count, std::size_t grain,
+																					const Task &task) {
+	/// ranges are packed into 32 bit halves, larger tasks fall back to static bands
+	if (item_count > HALF_MASK) {
+		dispatch(item_count, 0, task);
+		return;
+	}
+	grain = std::max(grain, static_cast<std::size_t>(1));
+	for (std::size_t worker = 0; worker < threadCount(); ++worker) {
+		const auto [begin, end] = band(item_count, worker, threadCount());
+		worker_states_[worker].range.store(packRange(begin, end), std::memory_order_relaxed);
+	}
+	dispatch(item_count, grain, task);
+}
+
+void CSIM::ThreadPool::dispatch(std::size_t item_count, std::size_t grain, const Task &task) {
+	if (item_count == 0) {
+		return;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	if (workers_.empty() || item_count == 1) {
+		const auto chunk = grain == 0 ? item_count : grain;
+		for (std::size_t begin = 0; begin < item_count; begin += chunk) {
+			task(begin, std::min(begin + chunk, item_count), 0);
+		}
+		const auto elapsed = nanoseconds(std::chrono::steady_clock::now() - start);
+		auto &stats = worker_states_[0].stats;
+		stats.busy_ns += elapsed;
+		stats.items += item_count;
+		wall_ns_ += elapsed;
+		return;
+	}
+
+	{
+		/// mutex publishes worker ranges to workers as well
+		const std::lock_guard lock(mutex_);
+		task_ = &task;
+		item_count_ = item_count;
+		grain_ = grain;
+		pending_workers_ = workers_.size();
+		++generation_;
+	}
+	work_cv_.notify_all();
+
+	/// calling thread is worker 0
+	process(0, task, item_count, grain);
+
+	std::unique_lock lock(mutex_);
+	done_cv_.wait(lock, [this] { return pending_workers_ == 0; });
+	task_ = nullptr;
+	wall_ns_ += nanoseconds(std::chrono::steady_clock::now() - start);
+}
+
+void CSIM::ThreadPool::process(std::size_t worker, const Task &task, std::size_t item_count,
+															 std::size_t grain) {
+	auto &stats = worker_states_[worker].stats;
+	const auto run = [&](std::size_t begin, std::size_t end) {
+		const auto start = std::chrono::steady_clock::now();
+		task(begin, end, worker);
+		stats.busy_ns += nanoseconds(std::chrono::steady_clock::now() - start);
+		stats.items += end - begin;
+	};
+
+	if (grain == 0) {
+		if (const auto [begin, end] = band(item_count, worker, threadCount()); begin < end) {
+			run(begin, end);
+		}
+		return;
+	}
+	std::size_t begin{0};
+	std::size_t end{0};
+	do {
+		while (take(worker_states_[worker], grain, begin, end)) {
+			run(begin, end);
+		}
+	} while (steal(worker, grain));
+}
+
+bool CSIM::ThreadPool::take(Worker &worker, std::size_t grain, std::size_t &begin,
+														std::size_t &end) noexcept {
+	auto range = worker.range.load(std::memory_order_acquire);
+	while (true) {
+		const auto [range_begin, range_end] = unpackRange(range);
+		if (range_begin >= range_end) {
+			return false;
+		}
+		const auto taken_end = std::min(range_end, range_begin + grain);
+		if (worker.range.compare_exchange_weak(range, packRange(taken_end, range_end),
+																					 std::memory_order_acq_rel)) {
+			begin = range_begin;
+			end = taken_end;
+			return true;
+		}
+	}
+}
+
+bool CSIM::ThreadPool::steal(std::size_t worker, std::size_t grain) noexcept {
+	while (true) {
+		/// victim with the most remaining items, their cost is unknown so count is the best guess
+		std::size_t victim{worker};
+		std::size_t victim_size{0};
+		for (std::size_t i = 1; i < threadCount(); ++i) {
+			const auto candidate = (worker + i) % threadCount();
+			const auto [begin, end] =
+					unpackRange(worker_states_[candidate].range.load(std::memory_order_relaxed));
+			if (end > begin && end - begin > victim_size) {
+				victim = candidate;
+				victim_size = end - begin;
+			}
+		}
+		if (victim_size == 0) {
+			return false;
+		}
+
+		auto &victim_range = worker_states_[victim].range;
+		auto range = victim_range.load(std::memory_order_acquire);
+		const auto [begin, end] = unpackRange(range);
+		if (begin >= end) {
+			continue;
+		}
+		/// small deques are taken whole, otherwise owner keeps the front half
+		const auto size = end - begin;
+		const auto stolen_begin = size <= grain ? begin : begin + size / 2;
+		if (victim_range.compare_exchange_strong(range, packRange(begin, stolen_begin),
+																						 std::memory_order_acq_rel)) {
+			worker_states_[worker].range.store(packRange(stolen_begin, end), std::memory_order_release);
+			++worker_states_[worker].stats.steals;
+			return true;
+		}
+	}
+}
+
+std::vector<CSIM::ThreadPool::WorkerStats> CSIM::ThreadPool::workerStats() const {
+	std::vector<WorkerStats> stats(threadCount());
+	for (std::size_t worker = 0; worker < stats.size(); ++worker) {
+		stats[worker] = worker_states_[worker].stats;
+	}
+	return stats;
+}
+
+void CSIM::ThreadPool::resetStats() noexcept {
+	for (std::size_t worker = 0; worker < threadCount(); ++worker) {
+		worker_states_[worker].stats = {};
+	}
+	wall_ns_ = 0;
+}
+
+void CSIM::ThreadPool::workerLoop(std::size_t worker) {
+	std::size_t seen_generation{0};
+	while (true) {
+		const Task *task{nullptr};
+		std::size_t item_count{0};
+		std::size_t grain{0};
+		{
+			std::unique_lock lock(mutex_);
+			work_cv_.wait(lock, [this, seen_generation] {
+				return stop_ || generation_ != seen_generation;
+			});
+			if (stop_) {
+				return;
+			}
+			seen_generation = generation_;
+			task = task_;
+			item_count = item_count_;
+			grain = grain_;
+		}
+
+		process(worker, *task, item_count, grain);
+
+		const std::lock_guard lock(mutex_);
+		if (--pending_workers_ == 0) {
+			done_cv_.notify_one();
+		}
+	}
+}
+
+CSIM::ThreadPool::~ThreadPool() {
+	{
+		const std::lock_guard lock(mutex_);
+		stop_ = true;
+	}
+	work_cv_.notify_all();
+	for (auto &worker : workers_) {
+		worker.join();
+	}
+}
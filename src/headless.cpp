@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <cli_emulator/rule_cli.hpp>
+#include <cpu/cpu_engine.hpp>
+#include <cpu/hash_life.hpp>
+#include <cpu/thread_pool.hpp>
+#include <rules/rule_config.hpp>
+
+#ifdef HEADLESS_GPU
+#include <cellmap/cellmap.hpp>
+#include <rules/rule.hpp>
+#include <window/window.hpp>
+#endif
+
+/// headless runner steps rules on the cpu engines without any window or GL context, builds with
+/// the offscreen window (surfaceless EGL) can also run them with compute shaders (gpu backend)
+
+struct HeadlessOptions {
+	std::int32_t width{0};
+	std::int32_t height{0};
+	std::uint64_t generations{0};
+	std::uint64_t seed{1};
+	double density{.5}; // NOLINT
+	std::int32_t state_count{2};
+	std::filesystem::path output{"final.pgm"};
+	std::uint64_t period{0}; /*!< generations between snapshots, 0 disables snapshots */
+	std::string backend{"cpu"};
+	std::uint32_t threads{0};
+	std::size_t memory{0}; /*!< hashlife node cache budget in MiB */
+	CLI::Option *threads_option;
+	CLI::Option *memory_option;
+	CLI::Option *active_tiles;
+};
+
+/**
+ * fills the map with alive cells at random, 1D rules get only their first row filled since the
+ * following rows are the next generations
+ */
+static void seedStates(std::vector<CSIM::CellState> &states, CSIM::Vec2<std::int32_t> resolution,
+											 bool one_dimensional, std::uint64_t seed, double density) {
+	std::mt19937_64 generator{seed};
+	std::bernoulli_distribution alive{density};
+	const auto rows = one_dimensional ? 1 : resolution.y;
+	const auto cell_count = static_cast<std::size_t>(resolution.x) * static_cast<std::size_t>(rows);
+	for (std::size_t i = 0; i < cell_count; ++i) {
+		/// alive cells get state 1, like cells seeded in the app
+		states[i] = static_cast<CSIM::CellState>(alive(generator));
+	}
+}
+
+/**
+ * writes states as binary portable graymap, every pixel is the state of a cell
+ */
+static void writeStates(const std::filesystem::path &path,
+												const std::vector<CSIM::CellState> &states,
+												CSIM::Vec2<std::int32_t> resolution, std::int32_t state_count) {
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error(fmt::format("can't open {} for writing", path.string()));
+	}
+	file << fmt::format("P5\n{} {}\n{}\n", resolution.x, resolution.y, std::max(state_count - 1, 1));
+	file.write(reinterpret_cast<const char *>(states.data()), // NOLINT byte view of the states
+						 static_cast<std::streamsize>(states.size()));
+	if (!file) {
+		throw std::runtime_error(fmt::format("can't write {}", path.string()));
+	}
+}
+
+/**
+ * @return path of the snapshot taken after given generation, placed next to the output file
+ */
+static std::filesystem::path snapshotPath(const std::filesystem::path &output,
+																					std::uint64_t generation) {
+	auto path = output;
+	path.replace_filename(fmt::format("{}_{:010}{}", output.stem().string(), generation,
+																		output.extension().string()));
+	return path;
+}
+
+/**
+ * @return true if config is a 1D rule, rows of the map are then its generations
+ */
+static bool isOneDimensional(const CSIM::RuleConfig &rule_config) noexcept {
+	return rule_config.ruleConfigType() == CSIM::RuleConfigType::TOTALISTIC_1D ||
+				 rule_config.ruleConfigType() == CSIM::RuleConfigType::BINARY_1D;
+}
+
+/**
+ * advances states by the requested number of generations in batches which end at snapshots, then
+ * writes the final states
+ * @param advance advances states by passed number of generations (second argument) starting
+ * from passed generation (first argument)
+ * @param sync makes states hold the current generation
+ */
+static void runBatches(const HeadlessOptions &options, std::vector<CSIM::CellState> &states,
+											 CSIM::Vec2<std::int32_t> resolution,
+											 const std::function<void(std::uint64_t, std::uint64_t)> &advance,
+											 const std::function<void()> &sync) {
+	const auto start = std::chrono::steady_clock::now();
+	std::uint64_t generation{0};
+	while (generation < options.generations) {
+		auto batch = options.generations - generation;
+		if (options.period > 0) {
+			batch = std::min(batch, options.period - generation % options.period);
+		}
+		advance(generation, batch);
+		generation += batch;
+		if (options.period > 0 && generation % options.period == 0 &&
+				generation < options.generations) {
+			sync();
+			writeStates(snapshotPath(options.output, generation), states, resolution,
+									options.state_count);
+		}
+	}
+	sync();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	writeStates(options.output, states, resolution, options.state_count);
+	spdlog::info("[cellsim-headless] {} generations in {:.3f} s ({:.0f} gens/s)", options.generations,
+							 elapsed.count(),
+							 static_cast<double>(options.generations) / std::max(elapsed.count(), 1e-9));
+}
+
+/**
+ * runs the rule on the cpu engines or hashlife
+ */
+static void runOnCPU(const HeadlessOptions &options, const CSIM::RuleCLIOptions &rule_options) {
+	/// configs are run only by cpu engines, so they get no step shaders
+	const auto rule_config =
+			rule_options.parsedRuleConfig([](CSIM::RuleConfigType) { return nullptr; });
+	const CSIM::Vec2<std::int32_t> resolution{options.width, options.height};
+
+	std::vector<CSIM::CellState> states(static_cast<std::size_t>(options.width) *
+																			static_cast<std::size_t>(options.height));
+	seedStates(states, resolution, isOneDimensional(*rule_config), options.seed, options.density);
+
+	if (options.backend == "hashlife") {
+		if (!CSIM::HashLife::supports(*rule_config, options.state_count, resolution)) {
+			throw std::invalid_argument("hashlife backend requires 2 state 2dlife rule with range 1 "
+																	"kernel on a cellmap with power of two extents");
+		}
+		CSIM::HashLife hash_life(*rule_config, options.memory_option->empty()
+																							 ? CSIM::HashLife::DEFAULT_MEMORY_BUDGET
+																							 : options.memory << 20u);
+		runBatches(
+				options, states, resolution,
+				[&](std::uint64_t, std::uint64_t batch) { hash_life.advanceBy(states, resolution, batch); },
+				[] {});
+		return;
+	}
+
+	auto thread_pool = options.threads_option->empty()
+												 ? std::make_shared<CSIM::ThreadPool>()
+												 : std::make_shared<CSIM::ThreadPool>(options.threads);
+	const auto engine = CSIM::makeCPUEngine(*rule_config, options.state_count, std::move(thread_pool),
+																					!options.active_tiles->empty());
+	if (engine == nullptr) {
+		throw std::invalid_argument("there is no cpu engine for the rule");
+	}
+	/// engines take generation counts and iterations as 32 bit integers, only the row which 1D
+	/// rules read depends on the iteration
+	const auto max_batch = static_cast<std::uint64_t>(std::numeric_limits<std::int32_t>::max());
+	const auto height = static_cast<std::uint64_t>(options.height);
+	runBatches(
+			options, states, resolution,
+			[&](std::uint64_t generation, std::uint64_t batch) {
+				for (auto left = batch; left > 0;) {
+					const auto generations = std::min(left, max_batch);
+					const auto iteration = (generation + batch - left) % height;
+					engine->run(states, resolution, options.state_count, static_cast<std::int32_t>(iteration),
+											static_cast<std::int32_t>(generations));
+					left -= generations;
+				}
+			},
+			[] {});
+}
+
+#ifdef HEADLESS_GPU
+/**
+ * runs the rule with compute shaders in an offscreen context, works without a display (e.g. on
+ * Mesa llvmpipe)
+ */
+static void runOnGPU(const HeadlessOptions &options, const CSIM::RuleCLIOptions &rule_options) {
+	CSIM::Window window(options.width, options.height, "cellsim headless");
+	window.loadGL();
+
+	CSIM::CellMap cell_map(static_cast<std::size_t>(options.width),
+												 static_cast<std::size_t>(options.height));
+	const auto rule_config = rule_options.parsedRuleConfig(CSIM::makeStepShader);
+	seedStates(cell_map.cell_states_, cell_map.resolution(), isOneDimensional(*rule_config),
+						 options.seed, options.density);
+	cell_map.uploadStates();
+	const auto rule = CSIM::makeGPURule(rule_config, !options.active_tiles->empty());
+
+	/// downloading states waits for the queued steps, so the measured time covers them
+	runBatches(
+			options, cell_map.cell_states_, cell_map.resolution(),
+			[&](std::uint64_t, std::uint64_t batch) {
+				for (std::uint64_t step = 0; step < batch; ++step) {
+					rule->step(cell_map, options.state_count);
+				}
+			},
+			[&] { cell_map.downloadStates(); });
+
+	rule->destroy();
+	rule_config->destroy();
+	cell_map.destroy();
+	window.destroy();
+}
+#endif
+
+int main(int argc, char **argv) {
+	CLI::App parser{"cellsim headless runner, steps a rule on the cpu and writes the final state map "
+									"(and periodic snapshots) as binary pgm files"};
+	HeadlessOptions options;
+	parser.add_option("-x,--width", options.width, "width of the cell map")
+			->check(CLI::Range(1, std::numeric_limits<std::int32_t>::max()))
+			->required();
+	parser.add_option("-y,--height", options.height, "height of the cell map")
+			->check(CLI::Range(1, std::numeric_limits<std::int32_t>::max()))
+			->required();
+	parser.add_option("-g,--generations", options.generations, "number of generations to run")
+			->required();
+	parser.add_option("-s,--seed", options.seed, "seed of the random initial state (default = 1)");
+	parser
+			.add_option("-d,--density", options.density,
+									 "fraction of cells alive in the initial state (default = 0.5)")
+			->check(CLI::Range(0., 1.));
+	parser
+			.add_option("-c,--states", options.state_count, "number of cell states (default = 2)")
+			->check(CLI::Range(2, 256)); // NOLINT
+	parser.add_option("-o,--output", options.output, "final state map (default = final.pgm)");
+	parser.add_option("-p,--period", options.period,
+										"generations between snapshots, snapshot of generation n is written next to "
+										"the output as <output>_<n>.pgm (default = 0, no snapshots)");
+#ifdef HEADLESS_GPU
+	parser
+			.add_option("-b,--backend", options.backend,
+									"cpu, hashlife or gpu (offscreen GL context, default = cpu)")
+			->check(CLI::IsMember({"cpu", "hashlife", "gpu"}));
+#else
+	parser.add_option("-b,--backend", options.backend, "cpu or hashlife (default = cpu)")
+			->check(CLI::IsMember({"cpu", "hashlife"}));
+#endif
+	options.threads_option =
+			parser
+					.add_option("-t,--threads", options.threads,
+											"number of cpu backend threads (default = number of hardware threads)")
+					->check(CLI::Range(1u, 1024u));
+	options.memory_option =
+			parser
+					.add_option("-m,--memory", options.memory,
+											"hashlife node cache budget in MiB (default = 256)")
+					->check(CLI::Range(std::size_t{16}, std::size_t{1} << 20u));
+	options.active_tiles = parser.add_flag(
+			"-a,--active-tiles", "2D rules recompute only tiles which changed or border on a changed "
+													 "tile in the last generation");
+
+	CSIM::RuleCLIOptions rule_options;
+	rule_options.setCLI(&parser);
+	parser.require_subcommand(1);
+
+	CLI11_PARSE(parser, argc, argv);
+
+	try {
+#ifdef HEADLESS_GPU
+		if (options.backend == "gpu") {
+			runOnGPU(options, rule_options);
+			return EXIT_SUCCESS;
+		}
+#endif
+		runOnCPU(options, rule_options);
+	} catch (const std::exception &ex) {
+		spdlog::critical("[cellsim-headless] {}", ex.what());
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
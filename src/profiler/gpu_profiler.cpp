@@ -0,0 +1,134 @@
+#include "profiler/gpu_profiler.hpp"
+
+#include <algorithm>
+
+#include <glad/glad.h>
+
+CSIM::GPUProfiler::Zone::Zone(GPUProfiler *profiler, ProfilePhase phase) noexcept
+		: profiler_(profiler), phase_(phase) {
+	if (profiler_ != nullptr) {
+		profiler_->begin(phase_);
+	}
+}
+
+CSIM::GPUProfiler::Zone::~Zone() {
+	if (profiler_ != nullptr) {
+		profiler_->end(phase_);
+	}
+}
+
+CSIM::GPUProfiler::GPUProfiler() {
+	for (auto &ring : query_rings_) {
+		glCreateQueries(GL_TIME_ELAPSED, static_cast<GLsizei>(ring.ids.size()), ring.ids.data());
+	}
+}
+
+void CSIM::GPUProfiler::begin(ProfilePhase phase) noexcept {
+	const auto index = static_cast<std::size_t>(phase);
+	zone_starts_[index] = std::chrono::steady_clock::now();
+
+	auto &ring = query_rings_[index];
+	if (gpu_phase_ != PHASE_COUNT || ring.pending == QUERY_RING_SIZE) {
+		++dropped_zones_;
+		return;
+	}
+	const auto slot = (ring.oldest + ring.pending) % QUERY_RING_SIZE;
+	ring.frames[slot] = frame_;
+	++ring.pending;
+	glBeginQuery(GL_TIME_ELAPSED, ring.ids[slot]);
+	gpu_phase_ = index;
+}
+
+void CSIM::GPUProfiler::end(ProfilePhase phase) noexcept {
+	const auto index = static_cast<std::size_t>(phase);
+	if (gpu_phase_ == index) {
+		glEndQuery(GL_TIME_ELAPSED);
+		gpu_phase_ = PHASE_COUNT;
+	}
+	const std::chrono::duration<float, std::milli> elapsed =
+			std::chrono::steady_clock::now() - zone_starts_[index];
+	cpu_ms_[index][frame_ % HISTORY_SIZE] += elapsed.count();
+}
+
+void CSIM::GPUProfiler::endFrame(float frame_seconds) noexcept {
+	/// queries of a phase finish in order, collecting stops at the first one without result
+	for (std::size_t index = 0; index < PHASE_COUNT; ++index) {
+		auto &ring = query_rings_[index];
+		/// query which is still running belongs to a zone which will end later
+		const auto finished = ring.pending - (gpu_phase_ == index ? 1 : 0);
+		for (std::size_t i = 0; i < finished; ++i) {
+			const auto id = ring.ids[ring.oldest];
+			GLint available{GL_FALSE};
+			glGetQueryObjectiv(id, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available == GL_FALSE) {
+				break;
+			}
+			GLuint64 nanoseconds{0};
+			glGetQueryObjectui64v(id, GL_QUERY_RESULT, &nanoseconds);
+			if (frame_ - ring.frames[ring.oldest] < HISTORY_SIZE) {
+				gpu_ms_[index][ring.frames[ring.oldest] % HISTORY_SIZE] +=
+						static_cast<float>(nanoseconds) * 1e-6f; // NOLINT
+			}
+			ring.oldest = (ring.oldest + 1) % QUERY_RING_SIZE;
+			--ring.pending;
+		}
+	}
+
+	frame_ms_[frame_ % HISTORY_SIZE] = frame_seconds * 1000.f; // NOLINT
+	++frame_;
+	const auto slot = frame_ % HISTORY_SIZE;
+	for (std::size_t index = 0; index < PHASE_COUNT; ++index) {
+		gpu_ms_[index][slot] = 0.f;
+		cpu_ms_[index][slot] = 0.f;
+	}
+	cells_[slot] = 0;
+}
+
+float CSIM::GPUProfiler::average(const std::array<float, HISTORY_SIZE> &history,
+																 std::size_t latency) const noexcept {
+	/// ended frames are [0, frame_), the current one is still being timed
+	if (frame_ <= latency) {
+		return 0.f;
+	}
+	const auto last = frame_ - latency;
+	const auto count = std::min<std::uint64_t>(last, AVERAGE_FRAMES);
+	float sum{0.f};
+	for (auto frame = last - count; frame < last; ++frame) {
+		sum += history[frame % HISTORY_SIZE];
+	}
+	return sum / static_cast<float>(count);
+}
+
+float CSIM::GPUProfiler::gpuMilliseconds(ProfilePhase phase) const noexcept {
+	return average(gpu_ms_[static_cast<std::size_t>(phase)], RESULT_LATENCY);
+}
+
+float CSIM::GPUProfiler::cpuMilliseconds(ProfilePhase phase) const noexcept {
+	return average(cpu_ms_[static_cast<std::size_t>(phase)], 0);
+}
+
+std::uint64_t CSIM::GPUProfiler::firstPendingFrame(ProfilePhase phase) const noexcept {
+	const auto &ring = query_rings_[static_cast<std::size_t>(phase)];
+	return ring.pending > 0 ? ring.frames[ring.oldest] : frame_;
+}
+
+double CSIM::GPUProfiler::cellsPerSecond() const noexcept {
+	const auto count = std::min<std::uint64_t>(frame_, AVERAGE_FRAMES);
+	double cells{0.};
+	double milliseconds{0.};
+	for (auto frame = frame_ - count; frame < frame_; ++frame) {
+		cells += static_cast<double>(cells_[frame % HISTORY_SIZE]);
+		milliseconds += static_cast<double>(frame_ms_[frame % HISTORY_SIZE]);
+	}
+	return milliseconds > 0. ? cells * 1000. / milliseconds : 0.; // NOLINT
+}
+
+void CSIM::GPUProfiler::destroy() noexcept {
+	if (gpu_phase_ != PHASE_COUNT) {
+		glEndQuery(GL_TIME_ELAPSED);
+		gpu_phase_ = PHASE_COUNT;
+	}
+	for (auto &ring : query_rings_) {
+		glDeleteQueries(static_cast<GLsizei>(ring.ids.size()), ring.ids.data());
+	}
+}
@@ -0,0 +1,88 @@
+#include "profiler/performance_window.hpp"
+#include <imgui.h>
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <vector>
+
+static void makeBorder(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a) {
+	auto *draw_list = ImGui::GetWindowDrawList();
+	draw_list->AddRect(ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), IM_COL32(r, g, b, a));
+}
+
+static constexpr std::array<const char *, CSIM::GPUProfiler::PHASE_COUNT> PHASE_NAMES{
+		"step", "seed", "readback", "lod pyramid", "draw main", "draw minimap"};
+
+void CSIM::drawPerformanceWindow(const GPUProfiler &profiler) {
+	/// NOLINTBEGIN
+	ImGui::Begin("Performance");
+	ImGui::LabelText("##frame-phases", "Frame phases"); makeBorder(255, 255, 0, 255);
+	if (ImGui::BeginTable("##phase-times", 3)) {
+		ImGui::TableSetupColumn("phase");
+		ImGui::TableSetupColumn("gpu ms");
+		ImGui::TableSetupColumn("cpu ms");
+		ImGui::TableHeadersRow();
+		float gpu_total{0.f};
+		float cpu_total{0.f};
+		for (std::size_t index = 0; index < GPUProfiler::PHASE_COUNT; ++index) {
+			const auto phase = static_cast<ProfilePhase>(index);
+			const auto gpu_ms = profiler.gpuMilliseconds(phase);
+			const auto cpu_ms = profiler.cpuMilliseconds(phase);
+			gpu_total += gpu_ms;
+			cpu_total += cpu_ms;
+			ImGui::TableNextRow();
+			ImGui::TableSetColumnIndex(0);
+			ImGui::TextUnformatted(PHASE_NAMES[index]);
+			ImGui::TableSetColumnIndex(1);
+			ImGui::Text("%.3f", static_cast<double>(gpu_ms));
+			ImGui::TableSetColumnIndex(2);
+			ImGui::Text("%.3f", static_cast<double>(cpu_ms));
+		}
+		ImGui::TableNextRow();
+		ImGui::TableSetColumnIndex(0);
+		ImGui::TextUnformatted("total");
+		ImGui::TableSetColumnIndex(1);
+		ImGui::Text("%.3f", static_cast<double>(gpu_total));
+		ImGui::TableSetColumnIndex(2);
+		ImGui::Text("%.3f", static_cast<double>(cpu_total));
+		ImGui::EndTable();
+	}
+	ImGui::Text("Cells/s :: %.3e", profiler.cellsPerSecond());
+	ImGui::Text("Zones without gpu time :: %lu", static_cast<unsigned long>(profiler.droppedZones()));
+	ImGui::Separator();
+	ImGui::Separator();
+
+	/// ring of frame times starts with the oldest frame at index frame count % history size
+	const auto &frame_ms = profiler.frameMilliseconds();
+	const auto frame_count = static_cast<std::size_t>(
+			std::min<std::uint64_t>(profiler.frameCount(), GPUProfiler::HISTORY_SIZE));
+	ImGui::LabelText("##frame-times", "Frame times"); makeBorder(255, 255, 0, 255);
+	if (frame_count > 0) {
+		std::vector<float> sorted;
+		sorted.reserve(frame_count);
+		for (std::size_t i = 0; i < frame_count; ++i) {
+			sorted.push_back(frame_ms[(profiler.frameCount() - 1 - i) % GPUProfiler::HISTORY_SIZE]);
+		}
+		std::sort(sorted.begin(), sorted.end());
+		ImGui::Text("p50 :: %.2f ms, p99 :: %.2f ms, max :: %.2f ms",
+								static_cast<double>(sorted[sorted.size() / 2]),
+								static_cast<double>(sorted[sorted.size() * 99 / 100]),
+								static_cast<double>(sorted.back()));
+		ImGui::PlotLines("##frame-time-history", frame_ms.data(),
+										 static_cast<int>(frame_ms.size()),
+										 static_cast<int>(profiler.frameCount() % GPUProfiler::HISTORY_SIZE),
+										 "last frames (ms)", 0.f, FLT_MAX, ImVec2(0.f, 60.f));
+
+		/// 1 ms bins, the last one collects all longer frames
+		constexpr std::size_t BIN_COUNT{50};
+		std::array<float, BIN_COUNT> bins{};
+		for (const auto time : sorted) {
+			bins[std::min(static_cast<std::size_t>(std::max(time, 0.f)), BIN_COUNT - 1)] += 1.f;
+		}
+		ImGui::PlotHistogram("##frame-time-histogram", bins.data(), static_cast<int>(bins.size()), 0,
+												 "0 - 50 ms, 1 ms bins", 0.f, FLT_MAX, ImVec2(0.f, 80.f));
+	}
+	ImGui::End();
+	/// NOLINTEND
+}
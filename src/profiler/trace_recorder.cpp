@@ -0,0 +1,191 @@
+#include "profiler/trace_recorder.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <glad/glad.h>
+
+CSIM::TraceRecorder::Zone::Zone(TraceRecorder *recorder, const char *name, bool gpu) noexcept
+		: recorder_(recorder != nullptr && recorder->recording() ? recorder : nullptr), name_(name) {
+	if (recorder_ == nullptr) {
+		return;
+	}
+	if (gpu) {
+		query_pair_ = recorder_->beginGPU(name_);
+	}
+	begin_ns_ = recorder_->now();
+}
+
+CSIM::TraceRecorder::Zone::~Zone() {
+	if (recorder_ == nullptr) {
+		return;
+	}
+	const auto end_ns = recorder_->now();
+	if (query_pair_ != GPU_QUERY_PAIRS) {
+		recorder_->endGPU(query_pair_);
+	}
+	recorder_->record(name_, begin_ns_, end_ns, recorder_->frame_.load(std::memory_order_relaxed),
+										threadIndex());
+}
+
+CSIM::TraceRecorder::TraceRecorder() : main_thread_(threadIndex()) {
+	glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(query_ids_.size()), query_ids_.data());
+}
+
+std::uint32_t CSIM::TraceRecorder::threadIndex() noexcept {
+	static std::atomic<std::uint32_t> next_index{0};
+	thread_local const auto index = next_index.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+void CSIM::TraceRecorder::record(const char *name, std::uint64_t begin_ns, std::uint64_t end_ns,
+																 std::uint64_t frame, std::uint32_t thread) noexcept {
+	const auto index = head_.fetch_add(1, std::memory_order_relaxed);
+	auto &slot = slots_[index & (CAPACITY - 1)];
+	/// odd sequence tells readers that the slot is being rewritten
+	slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.name.store(name, std::memory_order_relaxed);
+	slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+	slot.end_ns.store(end_ns, std::memory_order_relaxed);
+	slot.frame.store(frame, std::memory_order_relaxed);
+	slot.thread.store(thread, std::memory_order_relaxed);
+	slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::size_t CSIM::TraceRecorder::beginGPU(const char *name) noexcept {
+	if (used_pairs_ == GPU_QUERY_PAIRS) {
+		return GPU_QUERY_PAIRS;
+	}
+	const auto pair = (oldest_pair_ + used_pairs_) % GPU_QUERY_PAIRS;
+	++used_pairs_;
+	gpu_zones_[pair] = {name, frame_.load(std::memory_order_relaxed), false};
+	glQueryCounter(query_ids_[2 * pair], GL_TIMESTAMP);
+	return pair;
+}
+
+void CSIM::TraceRecorder::endGPU(std::size_t pair) noexcept {
+	glQueryCounter(query_ids_[2 * pair + 1], GL_TIMESTAMP);
+	gpu_zones_[pair].ended = true;
+}
+
+void CSIM::TraceRecorder::start(std::size_t frames) {
+	if (slots_.empty()) {
+		slots_ = std::vector<Slot>(CAPACITY);
+	}
+	/// gpu timestamps are mapped to recorder time by the offset of clocks sampled together
+	GLint64 gpu_now{0};
+	glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+	gpu_offset_ns_ = static_cast<std::int64_t>(now()) - gpu_now;
+
+	first_event_ = head_.load(std::memory_order_relaxed);
+	first_frame_ = frame_.load(std::memory_order_relaxed);
+	last_frame_ = first_frame_ + std::clamp<std::size_t>(frames, 1, MAX_FRAMES);
+	recording_.store(true, std::memory_order_release);
+}
+
+void CSIM::TraceRecorder::stop() noexcept {
+	if (recording()) {
+		last_frame_ = frame_.load(std::memory_order_relaxed) + 1;
+		recording_.store(false, std::memory_order_release);
+	}
+}
+
+void CSIM::TraceRecorder::endFrame() noexcept {
+	/// zones are collected in order they began, collecting stops at the first one without result
+	while (used_pairs_ > 0 && gpu_zones_[oldest_pair_].ended) {
+		const auto begin_id = query_ids_[2 * oldest_pair_];
+		const auto end_id = query_ids_[2 * oldest_pair_ + 1];
+		GLint available{GL_FALSE};
+		glGetQueryObjectiv(end_id, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_FALSE) {
+			break;
+		}
+		GLint64 begin_gpu{0};
+		GLint64 end_gpu{0};
+		glGetQueryObjecti64v(begin_id, GL_QUERY_RESULT, &begin_gpu);
+		glGetQueryObjecti64v(end_id, GL_QUERY_RESULT, &end_gpu);
+		const auto begin_ns = std::max<std::int64_t>(begin_gpu + gpu_offset_ns_, 0);
+		const auto end_ns = std::max<std::int64_t>(end_gpu + gpu_offset_ns_, begin_ns);
+		const auto &zone = gpu_zones_[oldest_pair_];
+		record(zone.name, static_cast<std::uint64_t>(begin_ns), static_cast<std::uint64_t>(end_ns),
+					 zone.frame, GPU_THREAD);
+		oldest_pair_ = (oldest_pair_ + 1) % GPU_QUERY_PAIRS;
+		--used_pairs_;
+	}
+
+	const auto frame = frame_.load(std::memory_order_relaxed) + 1;
+	frame_.store(frame, std::memory_order_relaxed);
+	if (recording() && frame >= last_frame_) {
+		recording_.store(false, std::memory_order_release);
+	}
+}
+
+std::size_t CSIM::TraceRecorder::writeChromeTrace(const std::filesystem::path &path) const {
+	std::ofstream file(path);
+	if (!file) {
+		throw std::runtime_error(fmt::format("can't open {} for writing", path.string()));
+	}
+	file << "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [\n"
+					"    {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": "
+					"\"cellsim\"}}";
+
+	std::size_t written{0};
+	std::vector<std::uint32_t> threads;
+	const auto head = head_.load(std::memory_order_acquire);
+	const auto first = std::max(first_event_, head > CAPACITY ? head - CAPACITY : 0);
+	for (auto index = first; index < head && !slots_.empty(); ++index) {
+		const auto &slot = slots_[index & (CAPACITY - 1)];
+		const auto sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence != 2 * index + 2) {
+			continue;
+		}
+		const auto *name = slot.name.load(std::memory_order_relaxed);
+		const auto begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+		const auto end_ns = slot.end_ns.load(std::memory_order_relaxed);
+		const auto frame = slot.frame.load(std::memory_order_relaxed);
+		const auto thread = slot.thread.load(std::memory_order_relaxed);
+		/// slot rewritten while it was read
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+			continue;
+		}
+		/// gpu zones of an earlier recording may be collected after the next one started
+		if (frame < first_frame_ || frame >= last_frame_) {
+			continue;
+		}
+		if (std::find(threads.cbegin(), threads.cend(), thread) == threads.cend()) {
+			threads.push_back(thread);
+		}
+		file << fmt::format(",\n    {{\"name\": \"{}\", \"cat\": \"{}\", \"ph\": \"X\", \"pid\": 0, "
+												"\"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}, \"args\": {{\"frame\": {}}}}}",
+												name, thread == GPU_THREAD ? "gpu" : "cpu", thread,
+												static_cast<double>(begin_ns) * 1e-3, // NOLINT microseconds
+												static_cast<double>(end_ns - begin_ns) * 1e-3, frame - first_frame_);
+		++written;
+	}
+
+	for (const auto thread : threads) {
+		auto thread_name = fmt::format("thread {}", thread);
+		if (thread == GPU_THREAD) {
+			thread_name = "gpu";
+		} else if (thread == main_thread_) {
+			thread_name = "main";
+		}
+		file << fmt::format(",\n    {{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, "
+												"\"tid\": {}, \"args\": {{\"name\": \"{}\"}}}}",
+												thread, thread_name);
+	}
+	file << "\n  ]\n}\n";
+	if (!file) {
+		throw std::runtime_error(fmt::format("can't write {}", path.string()));
+	}
+	return written;
+}
+
+void CSIM::TraceRecorder::destroy() noexcept {
+	recording_.store(false, std::memory_order_release);
+	glDeleteQueries(static_cast<GLsizei>(query_ids_.size()), query_ids_.data());
+}
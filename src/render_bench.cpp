@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <fmt/format.h>
+#include <glad/glad.h>
+#include <project_config/config.hpp>
+#include <spdlog/spdlog.h>
+
+#include <cellmap/cellmap.hpp>
+#include <renderer/renderer.hpp>
+#include <shaders/shaders.hpp>
+#include <window/window.hpp>
+
+/// rendering benchmark replays camera paths over fixed random maps in the offscreen window and
+/// times every Renderer::draw call (main view pass, minimap pass into the cell map texture and lod
+/// pyramid) with GL_TIME_ELAPSED queries and the cpu wall clock
+
+/**
+ * PAN moves diagonally over the map at a fixed zoom, ZOOM zooms in on the map center from the whole
+ * map in view to the largest zoom
+ */
+enum class CameraPath { PAN, ZOOM };
+
+struct RenderBenchOptions {
+	std::vector<std::int32_t> maps{512, 2048, 8192}; /*!< extents of the square maps */
+	/// viewports as <width>x<height>
+	std::vector<std::string> viewports{"1280x720", "1920x1080", "3840x2160"};
+	std::vector<float> zooms{.25f, 1.f, 4.f, 16.f}; /*!< pixels per cell of pan paths */
+	std::uint32_t frames{240};											/*!< frames of every path */
+	std::int32_t state_count{8};
+	std::uint64_t seed{1};
+	std::filesystem::path output{"cellsim_render_bench.json"};
+	CLI::Option *static_map;
+};
+
+struct RenderCase {
+	std::int32_t map_size;
+	CSIM::Vec2<int> viewport;
+	CSIM::RenderMode render_mode;
+	bool grid_on;
+	CameraPath path;
+	float pixels_per_cell; /*!< zoom of pan paths, zoom paths end at the largest zoom */
+};
+
+/**
+ * frame times of a case in milliseconds
+ */
+struct RenderResult {
+	RenderCase render_case;
+	std::vector<double> gpu_ms;
+	std::vector<double> cpu_ms;
+	double wall_ms; /*!< time from the first frame until all frames finished per frame */
+};
+
+/**
+ * @param viewport viewport in form <width>x<height>
+ */
+static CSIM::Vec2<int> parseViewport(std::string_view viewport) {
+	CSIM::Vec2<int> result{0, 0};
+	const auto *end = viewport.data() + viewport.size(); // NOLINT
+	const auto width = std::from_chars(viewport.data(), end, result.x);
+	if (width.ec != std::errc() || width.ptr == end || *width.ptr != 'x' ||
+			std::from_chars(width.ptr + 1, end, result.y).ptr != end || result.x <= 0 || result.y <= 0) {
+		throw std::invalid_argument(
+				fmt::format("viewport {} isn't in form <width>x<height>", viewport));
+	}
+	return result;
+}
+
+/**
+ * moves the camera to the position of the path at given fraction of the path
+ * @param progress fraction of the path from 0 to 1
+ */
+static void placeCamera(CSIM::Renderer &renderer, const RenderCase &render_case, float progress,
+												float max_zoom) {
+	const auto map_size = static_cast<float>(render_case.map_size);
+	auto pixels_per_cell = render_case.pixels_per_cell;
+	CSIM::Vec2<float> center{.5f * map_size, .5f * map_size};
+	if (render_case.path == CameraPath::PAN) {
+		center = {(.25f + .5f * progress) * map_size, (.25f + .5f * progress) * map_size};
+	} else {
+		/// exponential zoom, every frame zooms in by the same factor
+		const auto fit = static_cast<float>(render_case.viewport.y) / map_size;
+		pixels_per_cell = fit * std::pow(max_zoom / fit, progress);
+	}
+	/// viewport height spans 2 units, cell (x, y) is centered by offset (-x, y) * scale
+	const auto scale = 2.f * pixels_per_cell / static_cast<float>(render_case.viewport.y);
+	renderer.view_config_.scale = scale;
+	renderer.view_config_.offset = {-(center.x - .5f) * scale, (center.y - .5f) * scale};
+}
+
+/**
+ * draws the path, queries of every frame are read once all frames are queued so timing never
+ * stalls the pipeline
+ */
+static RenderResult drawPath(const RenderBenchOptions &options, CSIM::Renderer &renderer,
+														 const CSIM::CellMap &cell_map, const RenderCase &render_case) {
+	renderer.render_mode_ = render_case.render_mode;
+	renderer.grid_on_ = render_case.grid_on;
+	const auto max_zoom = *std::max_element(options.zooms.begin(), options.zooms.end());
+	const auto frame_progress = [&options](std::uint32_t frame) {
+		return options.frames > 1
+							 ? static_cast<float>(frame) / static_cast<float>(options.frames - 1)
+							 : 0.f;
+	};
+	const auto draw_frame = [&](std::uint32_t frame) {
+		if (options.static_map->empty()) {
+			/// states change every frame as while the simulation runs
+			renderer.markStatesChanged();
+		}
+		placeCamera(renderer, render_case, frame_progress(frame), max_zoom);
+		renderer.draw(render_case.viewport, cell_map);
+	};
+
+	/// first frames resize the main framebuffer and let the driver finish compiling pipelines
+	constexpr std::uint32_t WARMUP_FRAMES{8};
+	for (std::uint32_t frame = 0; frame < WARMUP_FRAMES; ++frame) {
+		draw_frame(frame % options.frames);
+	}
+	glFinish();
+
+	std::vector<GLuint> queries(options.frames);
+	glCreateQueries(GL_TIME_ELAPSED, static_cast<GLsizei>(queries.size()), queries.data());
+	RenderResult result{render_case, {}, {}, 0.};
+	result.cpu_ms.reserve(options.frames);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (std::uint32_t frame = 0; frame < options.frames; ++frame) {
+		glBeginQuery(GL_TIME_ELAPSED, queries[frame]);
+		const auto frame_start = std::chrono::steady_clock::now();
+		draw_frame(frame);
+		const std::chrono::duration<double, std::milli> cpu_time =
+				std::chrono::steady_clock::now() - frame_start;
+		glEndQuery(GL_TIME_ELAPSED);
+		result.cpu_ms.push_back(cpu_time.count());
+	}
+	glFinish();
+	const std::chrono::duration<double, std::milli> wall_time =
+			std::chrono::steady_clock::now() - start;
+	result.wall_ms = wall_time.count() / static_cast<double>(options.frames);
+
+	result.gpu_ms.reserve(options.frames);
+	for (const auto query : queries) {
+		GLuint64 nanoseconds{0};
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+		result.gpu_ms.push_back(static_cast<double>(nanoseconds) * 1e-6); // NOLINT
+	}
+	glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+	return result;
+}
+
+/**
+ * @return json object with mean, 50th, 90th, 99th percentile and max of the frame times
+ */
+static std::string percentiles(std::vector<double> times) {
+	std::sort(times.begin(), times.end());
+	/// nearest rank percentile
+	const auto rank = [&times](double percentile) {
+		const auto index = static_cast<std::size_t>(
+				std::ceil(percentile * static_cast<double>(times.size())));
+		return times[std::clamp(index, std::size_t{1}, times.size()) - 1];
+	};
+	double sum{0.};
+	for (const auto time : times) {
+		sum += time;
+	}
+	const auto mean = sum / static_cast<double>(times.size());
+	return fmt::format("{{\"mean\": {:.4f}, \"p50\": {:.4f}, \"p90\": {:.4f}, \"p99\": {:.4f}, "
+										 "\"max\": {:.4f}}}",
+										 mean, rank(.5), rank(.9), rank(.99), times.back()); // NOLINT
+}
+
+static std::string_view pathName(CameraPath path) noexcept {
+	return path == CameraPath::PAN ? "pan" : "zoom";
+}
+
+static std::string_view renderModeName(CSIM::RenderMode render_mode) noexcept {
+	return render_mode == CSIM::RenderMode::SCREEN ? "screen" : "instanced";
+}
+
+/**
+ * writes frame time statistics of every case as json, times are in milliseconds
+ */
+static void writeResults(const RenderBenchOptions &options, std::string_view device,
+												 const std::vector<RenderResult> &results) {
+	std::ofstream file(options.output);
+	if (!file) {
+		throw std::runtime_error(fmt::format("can't open {} for writing", options.output.string()));
+	}
+	file << fmt::format("{{\n  \"version\": \"{}\",\n  \"git_sha\": \"{}\",\n  \"gpu\": \"{}\",\n"
+											"  \"frames\": {},\n  \"states\": {},\n  \"static_map\": {},\n"
+											"  \"results\": [",
+											CSIM::cmake::config::project_version, CSIM::cmake::config::git_sha, device,
+											options.frames, options.state_count, !options.static_map->empty());
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const auto &result = results[i];
+		const auto &render_case = result.render_case;
+		file << fmt::format(
+				"{}\n    {{\"map\": {}, \"viewport_width\": {}, \"viewport_height\": {}, "
+				"\"render_mode\": \"{}\", \"grid\": {}, \"path\": \"{}\", \"pixels_per_cell\": {}, "
+				"\"gpu_ms\": {}, \"cpu_ms\": {}, \"wall_ms_per_frame\": {:.4f}}}",
+				i == 0 ? "" : ",", render_case.map_size, render_case.viewport.x, render_case.viewport.y,
+				renderModeName(render_case.render_mode), render_case.grid_on,
+				pathName(render_case.path),
+				render_case.path == CameraPath::PAN ? fmt::format("{}", render_case.pixels_per_cell)
+																						: std::string("null"),
+				percentiles(result.gpu_ms), percentiles(result.cpu_ms), result.wall_ms);
+	}
+	file << "\n  ]\n}\n";
+	if (!file) {
+		throw std::runtime_error(fmt::format("can't write {}", options.output.string()));
+	}
+}
+
+static void runRenderBench(const RenderBenchOptions &options) {
+	std::vector<CSIM::Vec2<int>> viewports;
+	for (const auto &viewport : options.viewports) {
+		viewports.push_back(parseViewport(viewport));
+	}
+
+	CSIM::Window window(viewports.front().x, viewports.front().y, "cellsim render bench");
+	window.loadGL();
+	const std::string device = reinterpret_cast<const char *>(glGetString(GL_RENDERER)); // NOLINT
+
+	CSIM::Renderer renderer(
+			viewports.front(),
+			std::make_shared<CSIM::VFShader>("shaders/bin/render_shader/vert.spv",
+																			 "shaders/bin/render_shader/frag.spv"),
+			std::make_shared<CSIM::VFShader>("shaders/bin/screen_shader/vert.spv",
+																			 "shaders/bin/grid_shader/frag.spv"),
+			std::make_shared<CSIM::VFShader>("shaders/bin/screen_shader/vert.spv",
+																			 "shaders/bin/screen_shader/frag.spv"),
+			std::make_shared<CSIM::CShader>("shaders/bin/lod_pyramid/comp.spv"));
+	/// states are shaded from black to white
+	std::vector<CSIM::Vec4<float>> colors;
+	for (std::int32_t state = 0; state < options.state_count; ++state) {
+		const auto value = static_cast<float>(state) / static_cast<float>(options.state_count - 1);
+		colors.push_back({value, value, value, 1.f});
+	}
+	renderer.setColors(colors);
+	/// minimap is redrawn in every frame it is dirty in
+	renderer.setMinimapRate(std::numeric_limits<float>::infinity());
+
+	std::vector<RenderResult> results;
+	for (const auto map_size : options.maps) {
+		CSIM::CellMap cell_map(static_cast<std::size_t>(map_size), static_cast<std::size_t>(map_size));
+		std::mt19937_64 generator{options.seed};
+		std::uniform_int_distribution<std::int32_t> state(0, options.state_count - 1);
+		std::generate(cell_map.cell_states_.begin(), cell_map.cell_states_.end(),
+									[&] { return static_cast<CSIM::CellState>(state(generator)); });
+		cell_map.uploadStates();
+
+		for (const auto viewport : viewports) {
+			for (const auto render_mode : {CSIM::RenderMode::SCREEN, CSIM::RenderMode::INSTANCED}) {
+				for (const bool grid_on : {false, true}) {
+					std::vector<RenderCase> cases;
+					for (const auto zoom : options.zooms) {
+						cases.push_back({map_size, viewport, render_mode, grid_on, CameraPath::PAN, zoom});
+					}
+					cases.push_back({map_size, viewport, render_mode, grid_on, CameraPath::ZOOM, 0.f});
+
+					for (const auto &render_case : cases) {
+						auto result = drawPath(options, renderer, cell_map, render_case);
+						auto gpu_ms = result.gpu_ms;
+						std::nth_element(gpu_ms.begin(), gpu_ms.begin() + gpu_ms.size() / 2, gpu_ms.end());
+						spdlog::info("[cellsim-render-bench] map {} viewport {}x{} {}{} {} {}: gpu median "
+												 "{:.3f} ms, wall {:.3f} ms/frame",
+												 map_size, viewport.x, viewport.y, renderModeName(render_mode),
+												 grid_on ? " grid" : "", pathName(render_case.path),
+												 render_case.path == CameraPath::PAN
+														 ? fmt::format("{} px/cell", render_case.pixels_per_cell)
+														 : std::string("fit to max zoom"),
+												 gpu_ms[gpu_ms.size() / 2], result.wall_ms);
+						results.push_back(std::move(result));
+					}
+				}
+			}
+		}
+		cell_map.destroy();
+	}
+
+	renderer.destroy();
+	window.destroy();
+	writeResults(options, device, results);
+	spdlog::info("[cellsim-render-bench] {} results written to {}", results.size(),
+							 options.output.string());
+}
+
+int main(int argc, char **argv) {
+	CLI::App parser{"cellsim rendering benchmark, replays camera paths over random maps in an "
+									"offscreen context and writes gpu (timer queries) and cpu frame time "
+									"percentiles of Renderer::draw as json"};
+	RenderBenchOptions options;
+	parser
+			.add_option("-m,--maps", options.maps,
+									"extents of the square maps (default = 512 2048 8192)")
+			->check(CLI::Range(1, 1 << 16)); // NOLINT
+	parser.add_option("-v,--viewports", options.viewports,
+										"viewports as <width>x<height> (default = 1280x720 1920x1080 3840x2160)");
+	parser
+			.add_option("-z,--zooms", options.zooms,
+									"pixels per cell of the pan paths, the zoom path zooms from the whole map to the "
+									"largest one (default = 0.25 1 4 16)")
+			->check(CLI::PositiveNumber);
+	parser.add_option("-f,--frames", options.frames, "frames of every path (default = 240)")
+			->check(CLI::Range(1u, 1u << 20u));
+	parser.add_option("-c,--states", options.state_count, "number of cell states (default = 8)")
+			->check(CLI::Range(2, 256)); // NOLINT
+	parser.add_option("-s,--seed", options.seed, "seed of the random maps (default = 1)");
+	parser.add_option("-o,--output", options.output,
+										"json results (default = cellsim_render_bench.json)");
+	options.static_map =
+			parser.add_flag("--static-map",
+											"states don't change between frames, only the camera moves (by default "
+											"states change every frame like during simulation, which redraws the "
+											"minimap and the lod pyramid)");
+
+	CLI11_PARSE(parser, argc, argv);
+
+	try {
+		runRenderBench(options);
+	} catch (const std::exception &ex) {
+		spdlog::critical("[cellsim-render-bench] {}", ex.what());
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -3,31 +3,35 @@
 //
 
 #include "renderer/renderer.hpp"
+#include <profiler/gpu_profiler.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <glad/glad.h>
 
 CSIM::Renderer::Renderer(
 		Vec2<int> win_size,
 		std::shared_ptr<Shader> render_shader,
-		std::shared_ptr<Shader> grid_shader) :
+		std::shared_ptr<Shader> grid_shader,
+		std::shared_ptr<Shader> screen_shader,
+		std::shared_ptr<Shader> lod_shader) :
 	main_fbo_(win_size.x, win_size.y),
 	render_shader_(std::move(render_shader)), 
-	grid_shader_(std::move(grid_shader)) {
+	grid_shader_(std::move(grid_shader)),
+	screen_shader_(std::move(screen_shader)),
+	lod_shader_(std::move(lod_shader)) {
 
 	std::array<GLuint, 4> buffers; // NOLINT initialization through ptr
 	glCreateBuffers(buffers.size(), buffers.data());
 	vbo_id_ = buffers[0];
-	outline_ibo_od_ = buffers[1];
-	view_config_ubo_id_ = buffers[2];
-	colors_ubo_id_ = buffers[3];
+	view_config_ubo_id_ = buffers[1];
+	colors_ubo_id_ = buffers[2];
+	lod_config_ubo_id_ = buffers[3];
 
 	// set up vertex data
 	glNamedBufferStorage(vbo_id_, QUAD.size() * sizeof(float), QUAD.data(),
 											 0); // NOLINT no flags = readonly data
-	// set up outline index data
-	glNamedBufferStorage(outline_ibo_od_, OUTLINE_INDICES.size() * sizeof(std::uint32_t),
-											 OUTLINE_INDICES.data(), 0); // NOLINT no flags = readonly data
 
 	// specify attrib layout
 	glCreateVertexArrays(1, &vao_id_); // NOLINT single vao
@@ -49,6 +53,10 @@ CSIM::Renderer::Renderer(
 	glNamedBufferStorage(colors_ubo_id_, static_cast<GLsizei>(colors_.size() * sizeof(Vec4<float>)),
 											 colors_.data(), GL_DYNAMIC_STORAGE_BIT);
 	glBindBufferBase(GL_UNIFORM_BUFFER, COLORS_UBO_BINDING_LOCATION, colors_ubo_id_);
+
+	glNamedBufferStorage(lod_config_ubo_id_, sizeof(LodConfig), nullptr, GL_DYNAMIC_STORAGE_BIT);
+	constexpr GLuint lod_config_binding{8};
+	glBindBufferBase(GL_UNIFORM_BUFFER, lod_config_binding, lod_config_ubo_id_);
 }
 
 void CSIM::Renderer::setColors(const std::vector<Vec4<float>> &colors) {
@@ -57,6 +65,8 @@ void CSIM::Renderer::setColors(const std::vector<Vec4<float>> &colors) {
 
 	glNamedBufferSubData(colors_ubo_id_, 0,
 											 static_cast<GLsizeiptr>(sizeof(Vec4<float>) * color_count_), colors_.data());
+	main_dirty_ = true;
+	minimap_dirty_ = true;
 }
 
 void CSIM::Renderer::updateView(Vec2<float> offset_vec, float scale_vec) noexcept {
@@ -71,72 +81,238 @@ void CSIM::Renderer::draw(Vec2<int> win_size, const CellMap &cellmap) noexcept {
 		return;
 	}
 
+	/// seeding, clearing and extending the map change the states outside of simulation steps
+	if (cellmap.statesVersion() != states_version_) {
+		states_version_ = cellmap.statesVersion();
+		markStatesChanged();
+	}
+	if (std::memcmp(&clear_color_, &drawn_clear_color_, sizeof(clear_color_)) != 0) {
+		drawn_clear_color_ = clear_color_;
+		main_dirty_ = true;
+		minimap_dirty_ = true;
+	}
+	minimap_elapsed_ += time_step_;
+
 	if (main_fbo_.width() != win_size.x || main_fbo_.height() != win_size.y) {
 		main_fbo_.resize(win_size.x, win_size.y);
+		main_dirty_ = true;
 	}
-	main_fbo_.bind_framebuffer();
-	glClearColor(clear_color_.x, clear_color_.y, clear_color_.z, clear_color_.w);
-	glClear(GL_COLOR_BUFFER_BIT);
-
-	render_shader_->bind();
-	glBindVertexArray(vao_id_);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo_id_);
 
 	view_config_.aspect_ratio = static_cast<float>(win_size.y) / static_cast<float>(win_size.x);
+	view_config_.map_resolution = cellmap.resolution();
+	view_config_.lod_level = lodLevel(win_size);
+	if (view_config_.lod_level > 0) {
+		updateLodPyramid(cellmap);
+		const auto &level = lod_levels_[static_cast<std::size_t>(view_config_.lod_level - 1)];
+		view_config_.lod_resolution = level.resolution;
+		view_config_.lod_offset = level.offset;
+		view_config_.lod_reduction = static_cast<std::int32_t>(lod_reduction_);
+	}
+	const auto instance_count = cullView(view_config_);
+	/// view config members are 4 byte values without padding in between
+	if (std::memcmp(&view_config_, &drawn_view_config_, sizeof(ViewConfig)) != 0 ||
+			grid_on_ != drawn_grid_on_ || render_mode_ != drawn_render_mode_) {
+		drawn_view_config_ = view_config_;
+		drawn_grid_on_ = grid_on_;
+		drawn_render_mode_ = render_mode_;
+		main_dirty_ = true;
+	}
 
-	glNamedBufferSubData(view_config_ubo_id_, 0, sizeof(ViewConfig), &view_config_);
-	glViewport(0, 0, win_size.x, win_size.y);
+	const auto draw_minimap = minimap_dirty_ && minimap_elapsed_ >= 1.f / minimap_rate_;
+	if (!main_dirty_ && !draw_minimap) {
+		return;
+	}
 
+	glBindVertexArray(vao_id_);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_id_);
 	// inserting memory barrier for a shader storages because of the state_map
 	// which is modified in during the step
 	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
-	const auto instance_count = static_cast<GLsizei>(cellmap.cell_offsets_.size());
-	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, QUAD.size() / 2, instance_count);
-	render_shader_->unbind();
 
-	if (grid_on_) {
-		grid_shader_->bind();
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, outline_ibo_od_);
-		glDrawElementsInstanced(GL_LINE_LOOP, 4, GL_UNSIGNED_INT, nullptr, instance_count);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-		grid_shader_->unbind();
+	if (main_dirty_) {
+		const GPUProfiler::Zone zone(profiler_, ProfilePhase::DRAW_MAIN);
+		main_fbo_.bind_framebuffer();
+		glClearColor(clear_color_.x, clear_color_.y, clear_color_.z, clear_color_.w);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		glNamedBufferSubData(view_config_ubo_id_, 0, sizeof(ViewConfig), &view_config_);
+		glViewport(0, 0, win_size.x, win_size.y);
+		drawCells(instance_count);
+
+		if (grid_on_) {
+			/// lines are computed per fragment of a single triangle covering the viewport and blended
+			/// over the cells, so they can fade out with the cell size
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			grid_shader_->bind();
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+			grid_shader_->unbind();
+			glDisable(GL_BLEND);
+		}
+		main_fbo_.unbind_framebuffer();
+		main_dirty_ = false;
 	}
-	main_fbo_.unbind_framebuffer();
 
-	auto cellmap_fbo = cellmap.textureFbo();
-	cellmap_fbo.bind_framebuffer();
-	glClearColor(clear_color_.x, clear_color_.y, clear_color_.z, clear_color_.w);
-	glClear(GL_COLOR_BUFFER_BIT);
-	render_shader_->bind();
-	const auto scale = 2.f / static_cast<float>(cellmap_fbo.height());
-	ViewConfig cellmap_view_config{
-			.offset = {-1.f - scale * (-.5f),
-						1.f - scale * .5f}, // NOLINT (-1.f, 1.f) = left upper corner
-											// (-.5f, .5f) = left upper corner
-											// of cell map
-			.scale = scale,
-			.aspect_ratio =
-					static_cast<float>(cellmap_fbo.width()) / static_cast<float>(cellmap_fbo.height())};
-	glNamedBufferSubData(view_config_ubo_id_, 0, sizeof(ViewConfig), &cellmap_view_config);
-	glViewport(0, 0, cellmap_fbo.width(), cellmap_fbo.height());
+	if (draw_minimap) {
+		const GPUProfiler::Zone zone(profiler_, ProfilePhase::DRAW_MINIMAP);
+		auto cellmap_fbo = cellmap.textureFbo();
+		cellmap_fbo.bind_framebuffer();
+		glClearColor(clear_color_.x, clear_color_.y, clear_color_.z, clear_color_.w);
+		glClear(GL_COLOR_BUFFER_BIT);
+		const auto scale = 2.f / static_cast<float>(cellmap_fbo.height());
+		ViewConfig cellmap_view_config{
+				.offset = {-1.f - scale * (-.5f),
+									 1.f - scale * .5f}, // NOLINT (-1.f, 1.f) = left upper corner
+																				// (-.5f, .5f) = left upper corner
+																				// of cell map
+				.scale = scale,
+				.aspect_ratio =
+						static_cast<float>(cellmap_fbo.width()) / static_cast<float>(cellmap_fbo.height()),
+				.map_resolution = view_config_.map_resolution};
+		const auto cellmap_instance_count = cullView(cellmap_view_config);
+		glNamedBufferSubData(view_config_ubo_id_, 0, sizeof(ViewConfig), &cellmap_view_config);
+		glViewport(0, 0, cellmap_fbo.width(), cellmap_fbo.height());
 
-	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
-	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, QUAD.size() / 2, instance_count);
-	render_shader_->unbind();
-	cellmap_fbo.unbind_framebuffer();
+		drawCells(cellmap_instance_count);
+		cellmap_fbo.unbind_framebuffer();
+		minimap_dirty_ = false;
+		minimap_elapsed_ = 0.f;
+		/// ubo holds the minimap view now, main view is uploaded again on its next redraw
+	}
 
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 }
 
+void CSIM::Renderer::drawCells(std::int32_t instance_count) const noexcept {
+	if (render_mode_ == RenderMode::SCREEN) {
+		/// single triangle covering the viewport, fragments outside of the map are discarded
+		screen_shader_->bind();
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		screen_shader_->unbind();
+		return;
+	}
+	render_shader_->bind();
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, QUAD.size() / 2, instance_count);
+	render_shader_->unbind();
+}
+
+std::int32_t CSIM::Renderer::cullView(ViewConfig &config) noexcept {
+	/// cell (x, y) covers [x - .5, x + .5] x [-y - .5, -y + .5] before scaling, viewport spans
+	/// [-1, 1] on both axes after the transform
+	const auto half_width = 1.f / (config.aspect_ratio * config.scale);
+	const auto half_height = 1.f / config.scale;
+	const auto center_x = -config.offset.x / config.scale;
+	const auto center_y = config.offset.y / config.scale;
+	const auto clamp_cell = [](float value, std::int32_t extent) {
+		return static_cast<std::int32_t>(
+				std::clamp(value, 0.f, static_cast<float>(extent))); // NOLINT float range is checked
+	};
+	const auto resolution = config.map_resolution;
+	const auto begin_x = clamp_cell(std::floor(center_x - half_width + .5f), resolution.x);
+	const auto end_x = clamp_cell(std::floor(center_x + half_width + .5f) + 1.f, resolution.x);
+	const auto begin_y = clamp_cell(std::floor(center_y - half_height + .5f), resolution.y);
+	const auto end_y = clamp_cell(std::floor(center_y + half_height + .5f) + 1.f, resolution.y);
+
+	/// instances of reduced levels are cells of the level
+	const auto level = config.lod_level;
+	const auto level_size = 1 << level;
+	config.visible_origin = {begin_x >> level, begin_y >> level};
+	config.visible_extent = {((end_x + level_size - 1) >> level) - config.visible_origin.x,
+													 ((end_y + level_size - 1) >> level) - config.visible_origin.y};
+	return config.visible_extent.x * config.visible_extent.y;
+}
+
+std::int32_t CSIM::Renderer::lodLevel(Vec2<int> win_size) const noexcept {
+	/// viewport height spans 2 units after the transform
+	const auto cell_pixels = view_config_.scale * static_cast<float>(win_size.y) * .5f;
+	if (!lod_on_ || cell_pixels >= 1.f) {
+		return 0;
+	}
+	/// level count is computed from the resolution the same way updateLodPyramid does
+	auto resolution = view_config_.map_resolution;
+	std::int32_t level_count{0};
+	while (resolution.x > 1 || resolution.y > 1) {
+		resolution = {(resolution.x + 1) / 2, (resolution.y + 1) / 2};
+		++level_count;
+	}
+	const auto level = static_cast<std::int32_t>(std::floor(std::log2(1.f / cell_pixels)));
+	return std::clamp(level, 0, level_count);
+}
+
+void CSIM::Renderer::updateLodPyramid(const CellMap &cellmap) noexcept {
+	const auto resolution = cellmap.resolution();
+	if (resolution.x != lod_map_resolution_.x || resolution.y != lod_map_resolution_.y) {
+		lod_levels_.clear();
+		auto level_resolution = resolution;
+		std::int32_t offset{0};
+		while (level_resolution.x > 1 || level_resolution.y > 1) {
+			level_resolution = {(level_resolution.x + 1) / 2, (level_resolution.y + 1) / 2};
+			lod_levels_.push_back({level_resolution, offset});
+			offset += (level_resolution.x * level_resolution.y + 3) / 4;
+		}
+
+		if (lod_pyramid_ssbo_id_ != 0) {
+			glDeleteBuffers(1, &lod_pyramid_ssbo_id_);
+		}
+		glCreateBuffers(1, &lod_pyramid_ssbo_id_);
+		const auto pyramid_size = static_cast<std::size_t>(std::max(offset, 1)) * sizeof(std::uint32_t);
+		glNamedBufferStorage(lod_pyramid_ssbo_id_, static_cast<GLsizeiptr>(pyramid_size), nullptr, 0);
+		constexpr GLuint binding{10};
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, lod_pyramid_ssbo_id_);
+
+		lod_map_resolution_ = resolution;
+		lod_dirty_ = true;
+	}
+	if (cellmap.statesVersion() != lod_states_version_) {
+		lod_states_version_ = cellmap.statesVersion();
+		lod_dirty_ = true;
+	}
+	if (!lod_dirty_) {
+		return;
+	}
+
+	/// every level is reduced from the one below, level 1 from the state map
+	const GPUProfiler::Zone zone(profiler_, ProfilePhase::LOD_PYRAMID);
+	constexpr std::uint32_t GROUP_SIZE{256};
+	constexpr std::uint32_t MAX_GROUP_COUNT{65535};
+	lod_shader_->bind();
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	auto source = LodLevel{resolution, 0};
+	for (std::size_t i = 0; i < lod_levels_.size(); ++i) {
+		const auto &target = lod_levels_[i];
+		const LodConfig config{.source_resolution = source.resolution,
+													 .target_resolution = target.resolution,
+													 .source_offset = source.offset,
+													 .target_offset = target.offset,
+													 .from_state_map = static_cast<std::int32_t>(i == 0),
+													 .reduction = static_cast<std::int32_t>(lod_reduction_)};
+		glNamedBufferSubData(lod_config_ubo_id_, 0, sizeof(LodConfig), &config);
+
+		/// dispatch for every word of the level, groups wrap into rows when they don't fit one axis
+		const auto cells = target.resolution.x * target.resolution.y;
+		const auto words = static_cast<std::uint32_t>(cells + 3) / 4;
+		const auto group_count = (words + GROUP_SIZE - 1) / GROUP_SIZE;
+		const auto groups_x = std::min(group_count, MAX_GROUP_COUNT);
+		glDispatchCompute(groups_x, (group_count + groups_x - 1) / groups_x, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		source = target;
+	}
+	Shader::unbind();
+	lod_dirty_ = false;
+}
+
 void CSIM::Renderer::destroy() {
 	std::vector<GLuint> buffers;
-	buffers.reserve(4); // NOLINT
+	buffers.reserve(5); // NOLINT
 
 	buffers.push_back(vbo_id_);
-	buffers.push_back(outline_ibo_od_);
 	buffers.push_back(view_config_ubo_id_);
 	buffers.push_back(colors_ubo_id_);
+	buffers.push_back(lod_config_ubo_id_);
+	if (lod_pyramid_ssbo_id_ != 0) {
+		buffers.push_back(lod_pyramid_ssbo_id_);
+	}
 
 	glDeleteBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
 }
@@ -2,7 +2,11 @@
 // Created by reg on 7/29/22.
 //
 #include "rules/rule.hpp"
+#include <cpu/active_tiles.hpp>
+
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <glad/glad.h>
 
 using namespace CSIM::utils;
@@ -23,13 +27,6 @@ CSIM::Rule::Rule(std::shared_ptr<RuleConfig> rule_config)
 											 GL_DYNAMIC_STORAGE_BIT);
 	glNamedBufferStorage(config_ubo_id_, static_cast<GLsizeiptr>(rule_config_->size()),
 											 rule_config_->data(), GL_DYNAMIC_STORAGE_BIT);
-
-	/// binding buffers to binding indices
-	rule_config_->getShader()->bind();
-	glBindBufferBase(GL_UNIFORM_BUFFER, BASE_CONFIG_UBO_BINDING_LOCATION,
-									 base_config_ubo_id_);
-	glBindBufferBase(GL_UNIFORM_BUFFER, CONFIG_UBO_BINDING_LOCATION, config_ubo_id_);
-	rule_config_->getShader()->unbind();
 }
 void CSIM::Rule::setBaseConfig(BaseConfig config, bool update_iteration) noexcept {
 	if (update_iteration) {
@@ -47,7 +44,6 @@ void CSIM::Rule::setRuleConfig(std::shared_ptr<RuleConfig> rule_config) {
 		glCreateBuffers(1, &config_ubo_id_);
 		glNamedBufferStorage(config_ubo_id_, static_cast<GLsizeiptr>(rule_config->size()),
 												 rule_config->data(), GL_DYNAMIC_STORAGE_BIT);
-		glBindBufferBase(GL_UNIFORM_BUFFER, CONFIG_UBO_BINDING_LOCATION, config_ubo_id_);
 	} else {
 		glNamedBufferSubData(config_ubo_id_, 0, static_cast<GLsizeiptr>(rule_config->size()),
 												 rule_config->data());
@@ -55,6 +51,11 @@ void CSIM::Rule::setRuleConfig(std::shared_ptr<RuleConfig> rule_config) {
 	rule_config_ = std::move(rule_config); /// change config
 }
 
+void CSIM::Rule::bindConfigBuffers() noexcept {
+	glBindBufferBase(GL_UNIFORM_BUFFER, BASE_CONFIG_UBO_BINDING_LOCATION, base_config_ubo_id_);
+	glBindBufferBase(GL_UNIFORM_BUFFER, CONFIG_UBO_BINDING_LOCATION, config_ubo_id_);
+}
+
 void CSIM::Rule::destroy() {
 	std::array<GLuint, 2> buffers; // NOLINT
 	buffers[0] = base_config_ubo_id_;
@@ -68,8 +69,9 @@ void CSIM::Rule::destroy() {
 CSIM::Rule1D::Rule1D(std::shared_ptr<RuleConfig> rule_config) : Rule(std::move(rule_config)) {
 }
 
-void CSIM::Rule1D::step(const CellMap &cell_map, std::int32_t state_count) noexcept { // NOLINT
+void CSIM::Rule1D::step(CellMap &cell_map, std::int32_t state_count) noexcept { // NOLINT
 	this->bindConfigShader();
+	this->bindConfigBuffers();
 
 	BaseConfig config;
 	config.map_resolution = cell_map.resolution();
@@ -89,14 +91,180 @@ void CSIM::Rule1D::destroy() {
 	Rule::destroy();
 }
 
+/// Rule1DPrefixSum impl ///
+
+CSIM::Rule1DPrefixSum::Rule1DPrefixSum(std::shared_ptr<RuleConfig> rule_config)
+		: Rule(std::move(rule_config)),
+			prefix_sum_shader_(
+					std::make_shared<CShader>("shaders/bin/1D_totalistic_prefix_sum/comp.spv")) {
+
+	glCreateBuffers(1, &prefix_sum_config_ubo_id_);
+	glNamedBufferStorage(prefix_sum_config_ubo_id_, sizeof(PrefixSumConfig), &prefix_sum_config_,
+											 GL_DYNAMIC_STORAGE_BIT);
+}
+
+bool CSIM::Rule1DPrefixSum::supports(const RuleConfig &rule_config) noexcept {
+	if (rule_config.ruleConfigType() != RuleConfigType::TOTALISTIC_1D) {
+		return false;
+	}
+	return static_cast<const RuleConfig1DTotalistic &>(rule_config).config().range >= MIN_RANGE;
+}
+
+void CSIM::Rule1DPrefixSum::step(CellMap &cell_map, std::int32_t state_count) noexcept {
+	prefix_sum_shader_->bind();
+	this->bindConfigBuffers();
+
+	BaseConfig config;
+	config.map_resolution = cell_map.resolution();
+	config.state_count = state_count;
+	/// iteration will be used to select currently processed row
+	config.iteration = this->iterate() % config.map_resolution.y;
+
+	this->setBaseConfig(config);
+
+	/// row prefixes followed by one total per work group
+	const auto group_count = (config.map_resolution.x + GROUP_SIZE - 1) / GROUP_SIZE;
+	const auto size = sizeof(std::uint32_t) *
+										static_cast<std::size_t>(config.map_resolution.x + group_count);
+	if (size > tables_size_) {
+		if (tables_ssbo_id_ != 0) {
+			glDeleteBuffers(1, &tables_ssbo_id_);
+		}
+		glCreateBuffers(1, &tables_ssbo_id_);
+
+		glNamedBufferStorage(tables_ssbo_id_, static_cast<GLsizeiptr>(size), nullptr, 0);
+
+		tables_size_ = size;
+	}
+	/// box sum rule uses the same indices, so buffers are bound on every step
+	constexpr GLuint config_binding{6};
+	constexpr GLuint tables_binding{7};
+	glBindBufferBase(GL_UNIFORM_BUFFER, config_binding, prefix_sum_config_ubo_id_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, tables_binding, tables_ssbo_id_);
+
+	prefix_sum_config_.group_count = group_count;
+
+	dispatchPass(PASS_SCAN_GROUPS, static_cast<std::uint32_t>(group_count));
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	dispatchPass(PASS_SCAN_TOTALS, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	dispatchPass(PASS_EVALUATE, static_cast<std::uint32_t>(group_count));
+
+	Shader::unbind();
+}
+
+void CSIM::Rule1DPrefixSum::dispatchPass(std::int32_t pass, std::uint32_t group_count) noexcept {
+	prefix_sum_config_.pass = pass;
+	glNamedBufferSubData(prefix_sum_config_ubo_id_, 0, sizeof(PrefixSumConfig), &prefix_sum_config_);
+	glDispatchCompute(group_count, 1, 1);
+}
+
+void CSIM::Rule1DPrefixSum::destroy() {
+	Rule::destroy();
+	prefix_sum_shader_->destroy();
+	glDeleteBuffers(1, &prefix_sum_config_ubo_id_);
+	if (tables_ssbo_id_ != 0) {
+		glDeleteBuffers(1, &tables_ssbo_id_);
+	}
+}
+
 /// Rule2D impl ///
 
-CSIM::Rule2D::Rule2D(std::shared_ptr<RuleConfig> rule_config) : Rule(std::move(rule_config)) {
+CSIM::Rule2D::Rule2D(std::shared_ptr<RuleConfig> rule_config, bool shared_tiles)
+		: Rule(std::move(rule_config)),
+			life_shared_shader_(std::make_shared<CShader>("shaders/bin/2D_life_shared/comp.spv")),
+			cyclic_shared_shader_(std::make_shared<CShader>("shaders/bin/2D_cyclic_shared/comp.spv")),
+			shared_tiles_(shared_tiles) {
 }
 
-void CSIM::Rule2D::step(const CellMap &cell_map, std::int32_t state_count) noexcept {
+void CSIM::Rule2D::step(CellMap &cell_map, std::int32_t state_count) noexcept {
+	this->bindConfigBuffers();
+
+	/// 2D shaders don't read the iteration, it is counted on the host and base config is uploaded
+	/// only when the map or the state count changes
+	const auto iteration = this->iterate();
+	const auto resolution = cell_map.resolution();
+	if (resolution.x != previous_map_resolution_.x || resolution.y != previous_map_resolution_.y ||
+			state_count != previous_state_count_) {
+		BaseConfig config;
+		config.map_resolution = resolution;
+		config.state_count = state_count;
+		config.iteration = iteration;
+		this->setBaseConfig(config);
+
+		previous_map_resolution_ = resolution;
+		previous_state_count_ = state_count;
+	}
+
+	/// previous generation is read from the copy binding, next one is written over the older one
+	cell_map.swapStateMaps();
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	/// shared shaders write whole words per row, so rows have to start on a word boundary
+	const auto config_type = this->ruleConfig()->ruleConfigType();
+	if (shared_tiles_ && resolution.x % 4 == 0 &&
+			(config_type == RuleConfigType::LIFE_2D || config_type == RuleConfigType::CYCLIC_2D)) {
+		if (config_type == RuleConfigType::LIFE_2D) {
+			life_shared_shader_->bind();
+		} else {
+			cyclic_shared_shader_->bind();
+		}
+		glDispatchCompute(static_cast<GLuint>((resolution.x + TILE_WIDTH - 1) / TILE_WIDTH),
+											static_cast<GLuint>((resolution.y + TILE_HEIGHT - 1) / TILE_HEIGHT), 1);
+		Shader::unbind();
+		return;
+	}
+
+	/// dispatch for every word of the map, groups wrap into rows when they don't fit one axis
 	this->bindConfigShader();
+	const auto words = static_cast<std::uint32_t>(cell_map.stateMapSize() / sizeof(std::uint32_t));
+	const auto group_count = (words + GROUP_SIZE - 1) / GROUP_SIZE;
+	const auto groups_x = std::min(group_count, MAX_GROUP_COUNT);
+	glDispatchCompute(groups_x, (group_count + groups_x - 1) / groups_x, 1);
+
+	Shader::unbind();
+}
+
+void CSIM::Rule2D::destroy() {
+	Rule::destroy();
+	life_shared_shader_->destroy();
+	cyclic_shared_shader_->destroy();
+}
+
+/// Rule2DActiveTiles impl ///
+
+static std::int32_t kernelReach(const CSIM::RuleConfig &rule_config) {
+	if (rule_config.ruleConfigType() == CSIM::RuleConfigType::CYCLIC_2D) {
+		return static_cast<const CSIM::RuleConfig2DCyclic &>(rule_config).range();
+	}
+	return 1; /// 2D life kernels have range 1
+}
+
+CSIM::Rule2DActiveTiles::Rule2DActiveTiles(std::shared_ptr<RuleConfig> rule_config)
+		: Rule(std::move(rule_config)),
+			tiles_shader_(std::make_shared<CShader>("shaders/bin/2D_active_tiles/comp.spv")),
+			life_tiles_shader_(std::make_shared<CShader>("shaders/bin/2D_life_tiles/comp.spv")),
+			cyclic_tiles_shader_(std::make_shared<CShader>("shaders/bin/2D_cyclic_tiles/comp.spv")),
+			tiles_config_{{0, 0}, {0, 0}, PASS_LIST, 1}, reach_(kernelReach(*this->ruleConfig())) {
+
+	glCreateBuffers(1, &tiles_config_ubo_id_);
+	glNamedBufferStorage(tiles_config_ubo_id_, sizeof(TilesConfig), &tiles_config_,
+											 GL_DYNAMIC_STORAGE_BIT);
+}
 
+bool CSIM::Rule2DActiveTiles::supports(const RuleConfig &rule_config) noexcept {
+	return rule_config.ruleConfigType() == RuleConfigType::LIFE_2D ||
+				 rule_config.ruleConfigType() == RuleConfigType::CYCLIC_2D;
+}
+
+void CSIM::Rule2DActiveTiles::setRuleConfig(std::shared_ptr<RuleConfig> rule_config) {
+	Rule::setRuleConfig(std::move(rule_config));
+	reach_ = kernelReach(*this->ruleConfig());
+	/// activity under the previous config says nothing about the new one
+	all_active_ = true;
+}
+
+void CSIM::Rule2DActiveTiles::step(CellMap &cell_map, std::int32_t state_count) noexcept {
 	BaseConfig config;
 	config.map_resolution = cell_map.resolution();
 	config.state_count = state_count;
@@ -104,36 +272,430 @@ void CSIM::Rule2D::step(const CellMap &cell_map, std::int32_t state_count) noexc
 
 	this->setBaseConfig(config);
 
-	const auto size = static_cast<GLsizeiptr>(sizeof(std::int32_t) * config.map_resolution.x *
-																						config.map_resolution.y);
+	const Vec2<std::int32_t> tile_count{(config.map_resolution.x + TILE_SIZE - 1) / TILE_SIZE,
+																			(config.map_resolution.y + TILE_SIZE - 1) / TILE_SIZE};
+	const auto tile_total =
+			static_cast<std::size_t>(tile_count.x) * static_cast<std::size_t>(tile_count.y);
 	if (config.map_resolution.x != previous_map_resolution_.x ||
 			config.map_resolution.y != previous_map_resolution_.y) {
-		if (state_map_copy_ssbo_id_ != 0) {
-			glDeleteBuffers(1, &state_map_copy_ssbo_id_);
+		std::array<GLuint, 2> buffers{active_tiles_ssbo_id_, changed_tiles_ssbo_id_};
+		if (active_tiles_ssbo_id_ != 0) {
+			glDeleteBuffers(buffers.size(), buffers.data());
 		}
-		glCreateBuffers(1, &state_map_copy_ssbo_id_);
-
-		glNamedBufferStorage(state_map_copy_ssbo_id_, size, nullptr, 0);
+		glCreateBuffers(buffers.size(), buffers.data());
+		active_tiles_ssbo_id_ = buffers[0];
+		changed_tiles_ssbo_id_ = buffers[1];
 
-		constexpr GLuint binding{6};
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, state_map_copy_ssbo_id_);
+		/// 3 indirect dispatch arguments followed by the list
+		glNamedBufferStorage(active_tiles_ssbo_id_,
+												 static_cast<GLsizeiptr>((3 + tile_total) * sizeof(std::uint32_t)), nullptr,
+												 GL_DYNAMIC_STORAGE_BIT);
+		glNamedBufferStorage(changed_tiles_ssbo_id_,
+												 static_cast<GLsizeiptr>(2 * tile_total * sizeof(std::uint32_t)), nullptr,
+												 0);
 
 		previous_map_resolution_ = config.map_resolution;
+		all_active_ = true;
+	}
+	constexpr GLuint config_binding{7};
+	constexpr GLuint active_tiles_binding{8};
+	constexpr GLuint changed_tiles_binding{9};
+	this->bindConfigBuffers();
+	glBindBufferBase(GL_UNIFORM_BUFFER, config_binding, tiles_config_ubo_id_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, active_tiles_binding, active_tiles_ssbo_id_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, changed_tiles_binding, changed_tiles_ssbo_id_);
+	/// map was seeded, cleared or written by another rule, transitions depend on state count
+	if (cell_map.statesVersion() != states_version_ || state_count != previous_state_count_) {
+		states_version_ = cell_map.statesVersion();
+		previous_state_count_ = state_count;
+		all_active_ = true;
 	}
 
-	glCopyNamedBufferSubData(cell_map.stateMapSsboId(), state_map_copy_ssbo_id_, 0, 0, size);
+	tiles_config_.tile_count = tile_count;
+	tiles_config_.tile_reach = ActiveTiles::tileReach(
+			config.map_resolution, {TILE_SIZE, TILE_SIZE}, {reach_, reach_});
+	tiles_config_.pass = PASS_LIST;
+	tiles_config_.all_active = static_cast<std::int32_t>(all_active_);
+	glNamedBufferSubData(tiles_config_ubo_id_, 0, sizeof(TilesConfig), &tiles_config_);
+
+	/// previous generation is read from the copy binding, sync pass copies active tiles back into
+	/// it, so both state maps hold the same generation and the whole map is copied only when
+	/// tracking restarts
+	cell_map.swapStateMaps();
+	if (all_active_) {
+		glCopyNamedBufferSubData(cell_map.backStateMapSsboId(), cell_map.stateMapSsboId(), 0, 0,
+														 static_cast<GLsizeiptr>(cell_map.stateMapSize()));
+		all_active_ = false;
+	}
+	/// group count x is incremented by the list pass for every active tile
+	constexpr std::array<GLuint, 3> dispatch_arguments{0, 1, 1};
+	glNamedBufferSubData(active_tiles_ssbo_id_, 0, sizeof(dispatch_arguments),
+											 dispatch_arguments.data());
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	tiles_shader_->bind();
+	glDispatchCompute(static_cast<GLuint>((tile_total + LIST_GROUP_SIZE - 1) / LIST_GROUP_SIZE), 1,
+										1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, active_tiles_ssbo_id_);
+	if (this->ruleConfig()->ruleConfigType() == RuleConfigType::LIFE_2D) {
+		life_tiles_shader_->bind();
+	} else {
+		cyclic_tiles_shader_->bind();
+	}
+	glDispatchComputeIndirect(0);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
-	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
-	/// dispatch for every cell on the map
-	glDispatchCompute(static_cast<GLuint>(config.map_resolution.x),
-										static_cast<GLuint>(config.map_resolution.y), 1);
+	setPass(PASS_SYNC);
+	tiles_shader_->bind();
+	glDispatchComputeIndirect(0);
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
 
 	Shader::unbind();
 }
 
-void CSIM::Rule2D::destroy() {
+void CSIM::Rule2DActiveTiles::setPass(std::int32_t pass) noexcept {
+	tiles_config_.pass = pass;
+	glNamedBufferSubData(tiles_config_ubo_id_, offsetof(TilesConfig, pass), sizeof(std::int32_t),
+											 &tiles_config_.pass);
+}
+
+void CSIM::Rule2DActiveTiles::destroy() {
 	Rule::destroy();
-	if (state_map_copy_ssbo_id_ != 0) {
-		glDeleteBuffers(1, &state_map_copy_ssbo_id_);
+	tiles_shader_->destroy();
+	life_tiles_shader_->destroy();
+	cyclic_tiles_shader_->destroy();
+	glDeleteBuffers(1, &tiles_config_ubo_id_);
+	if (active_tiles_ssbo_id_ != 0) {
+		std::array<GLuint, 2> buffers{active_tiles_ssbo_id_, changed_tiles_ssbo_id_};
+		glDeleteBuffers(buffers.size(), buffers.data());
+	}
+}
+
+/// Rule2DTemporal impl ///
+
+CSIM::Rule2DTemporal::Rule2DTemporal(std::shared_ptr<RuleConfig> rule_config,
+																		 std::int32_t generations)
+		: Rule(std::move(rule_config)),
+			life_temporal_shader_(std::make_shared<CShader>("shaders/bin/2D_life_temporal/comp.spv")),
+			cyclic_temporal_shader_(
+					std::make_shared<CShader>("shaders/bin/2D_cyclic_temporal/comp.spv")),
+			temporal_config_{1, kernelReach(*this->ruleConfig())}, generations_(generations) {
+
+	glCreateBuffers(1, &temporal_config_ubo_id_);
+	glNamedBufferStorage(temporal_config_ubo_id_, sizeof(TemporalConfig), &temporal_config_,
+											 GL_DYNAMIC_STORAGE_BIT);
+}
+
+bool CSIM::Rule2DTemporal::supports(const RuleConfig &rule_config) noexcept {
+	return rule_config.ruleConfigType() == RuleConfigType::LIFE_2D ||
+				 rule_config.ruleConfigType() == RuleConfigType::CYCLIC_2D;
+}
+
+void CSIM::Rule2DTemporal::setRuleConfig(std::shared_ptr<RuleConfig> rule_config) {
+	Rule::setRuleConfig(std::move(rule_config));
+	temporal_config_.reach = kernelReach(*this->ruleConfig());
+}
+
+void CSIM::Rule2DTemporal::step(CellMap &cell_map, std::int32_t state_count) noexcept {
+	BaseConfig config;
+	config.map_resolution = cell_map.resolution();
+	config.state_count = state_count;
+	config.iteration = this->iterate(generations_);
+
+	this->setBaseConfig(config);
+
+	constexpr GLuint config_binding{6};
+	this->bindConfigBuffers();
+	glBindBufferBase(GL_UNIFORM_BUFFER, config_binding, temporal_config_ubo_id_);
+
+	if (this->ruleConfig()->ruleConfigType() == RuleConfigType::LIFE_2D) {
+		life_temporal_shader_->bind();
+	} else {
+		cyclic_temporal_shader_->bind();
+	}
+
+	/// halo of generations * reach cells has to fit into shared memory of the work group
+	const auto block_generations = std::max(MAX_HALO / temporal_config_.reach, 1);
+	for (std::int32_t generation = 0; generation < generations_;
+			 generation += temporal_config_.generations) {
+		temporal_config_.generations = std::min(block_generations, generations_ - generation);
+		glNamedBufferSubData(temporal_config_ubo_id_, 0, sizeof(TemporalConfig), &temporal_config_);
+
+		/// work groups read the previous block from the copy binding, so tiles written by other
+		/// groups don't affect their halo
+		cell_map.swapStateMaps();
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		glDispatchCompute(static_cast<GLuint>((config.map_resolution.x + TILE_SIZE - 1) / TILE_SIZE),
+											static_cast<GLuint>((config.map_resolution.y + TILE_SIZE - 1) / TILE_SIZE),
+											1);
+	}
+
+	Shader::unbind();
+}
+
+void CSIM::Rule2DTemporal::destroy() {
+	Rule::destroy();
+	life_temporal_shader_->destroy();
+	cyclic_temporal_shader_->destroy();
+	glDeleteBuffers(1, &temporal_config_ubo_id_);
+}
+
+/// Rule2DBoxSum impl ///
+
+static CSIM::Rule2DBoxSum::BoxSumConfig boxSumConfig(const CSIM::RuleConfig &rule_config) {
+	const auto &cyclic_config = static_cast<const CSIM::RuleConfig2DCyclic &>(rule_config);
+	return {0, cyclic_config.range(), static_cast<std::int32_t>(cyclic_config.moore()),
+					static_cast<std::int32_t>(cyclic_config.centerActive())};
+}
+
+CSIM::Rule2DBoxSum::Rule2DBoxSum(std::shared_ptr<RuleConfig> rule_config)
+		: Rule(std::move(rule_config)),
+			box_sum_shader_(std::make_shared<CShader>("shaders/bin/2D_cyclic_box_sum/comp.spv")),
+			box_sum_config_(boxSumConfig(*this->ruleConfig())) {
+
+	glCreateBuffers(1, &box_sum_config_ubo_id_);
+	glNamedBufferStorage(box_sum_config_ubo_id_, sizeof(BoxSumConfig), &box_sum_config_,
+											 GL_DYNAMIC_STORAGE_BIT);
+}
+
+bool CSIM::Rule2DBoxSum::supports(const RuleConfig &rule_config) noexcept {
+	if (rule_config.ruleConfigType() != RuleConfigType::CYCLIC_2D) {
+		return false;
+	}
+	const auto &cyclic_config = static_cast<const RuleConfig2DCyclic &>(rule_config);
+	return cyclic_config.config().state_insensitive != 0 && cyclic_config.range() >= MIN_RANGE;
+}
+
+void CSIM::Rule2DBoxSum::setRuleConfig(std::shared_ptr<RuleConfig> rule_config) {
+	Rule::setRuleConfig(std::move(rule_config));
+	box_sum_config_ = boxSumConfig(*this->ruleConfig());
+	glNamedBufferSubData(box_sum_config_ubo_id_, 0, sizeof(BoxSumConfig), &box_sum_config_);
+}
+
+void CSIM::Rule2DBoxSum::step(CellMap &cell_map, std::int32_t state_count) noexcept {
+	box_sum_shader_->bind();
+	this->bindConfigBuffers();
+
+	BaseConfig config;
+	config.map_resolution = cell_map.resolution();
+	config.state_count = state_count;
+	config.iteration = this->iterate();
+
+	this->setBaseConfig(config);
+
+	/// tables are padded by range + 1 cells on every side, neumann kernel needs row prefixes and
+	/// both diagonal sums while moore kernel accumulates columns in place
+	const auto table_width = config.map_resolution.x + 2 * box_sum_config_.range + 1;
+	const auto table_height = config.map_resolution.y + 2 * box_sum_config_.range + 1;
+	const std::size_t table_count = box_sum_config_.moore == 1 ? 1 : 3;
+	const auto size = table_count * sizeof(std::uint32_t) * static_cast<std::size_t>(table_width) *
+										static_cast<std::size_t>(table_height);
+	if (size > tables_size_) {
+		if (tables_ssbo_id_ != 0) {
+			glDeleteBuffers(1, &tables_ssbo_id_);
+		}
+		glCreateBuffers(1, &tables_ssbo_id_);
+
+		glNamedBufferStorage(tables_ssbo_id_, static_cast<GLsizeiptr>(size), nullptr, 0);
+
+		tables_size_ = size;
+	}
+	constexpr GLuint config_binding{6};
+	constexpr GLuint tables_binding{7};
+	glBindBufferBase(GL_UNIFORM_BUFFER, config_binding, box_sum_config_ubo_id_);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, tables_binding, tables_ssbo_id_);
+
+	const auto group_count = [](std::int32_t invocations) {
+		return static_cast<std::uint32_t>((invocations + GROUP_SIZE - 1) / GROUP_SIZE);
+	};
+	dispatchPass(PASS_PREFIX, group_count(table_height), 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	dispatchPass(PASS_ACCUMULATE,
+							 group_count(box_sum_config_.moore == 1 ? table_width
+																											: table_width + table_height - 1),
+							 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	/// one invocation per cell, rows are dispatched along y
+	dispatchPass(PASS_EVALUATE, group_count(config.map_resolution.x),
+							 static_cast<std::uint32_t>(config.map_resolution.y));
+
+	Shader::unbind();
+}
+
+void CSIM::Rule2DBoxSum::dispatchPass(std::int32_t pass, std::uint32_t group_count_x,
+																			std::uint32_t group_count_y) noexcept {
+	box_sum_config_.pass = pass;
+	glNamedBufferSubData(box_sum_config_ubo_id_, 0, sizeof(std::int32_t), &box_sum_config_.pass);
+	glDispatchCompute(group_count_x, group_count_y, 1);
+}
+
+void CSIM::Rule2DBoxSum::destroy() {
+	Rule::destroy();
+	box_sum_shader_->destroy();
+	glDeleteBuffers(1, &box_sum_config_ubo_id_);
+	if (tables_ssbo_id_ != 0) {
+		glDeleteBuffers(1, &tables_ssbo_id_);
+	}
+}
+
+/// RuleCPU2D impl ///
+
+CSIM::RuleCPU2D::RuleCPU2D(std::shared_ptr<RuleConfig> rule_config,
+													 std::shared_ptr<ThreadPool> thread_pool, bool active_tiles,
+													 std::int32_t generations)
+		: Rule(std::move(rule_config)), thread_pool_(std::move(thread_pool)),
+			active_tiles_(active_tiles), generations_(generations) {
+}
+
+void CSIM::RuleCPU2D::setRuleConfig(std::shared_ptr<RuleConfig> rule_config) {
+	Rule::setRuleConfig(std::move(rule_config));
+	engine_ = nullptr;
+}
+
+void CSIM::RuleCPU2D::step(CellMap &cell_map, std::int32_t state_count) {
+	/// engine depends on state count (e.g. two state life runs on bit packed engine)
+	if (engine_ == nullptr || engine_state_count_ != state_count) {
+		engine_ = makeCPUEngine(*this->ruleConfig(), state_count, thread_pool_, active_tiles_);
+		engine_state_count_ = state_count;
+		if (engine_ == nullptr) {
+			return;
+		}
+	}
+	syncHostStates(cell_map);
+	/// map was seeded, cleared or resized since the last step
+	if (cell_map.statesVersion() != states_version_) {
+		engine_->invalidate();
+		states_version_ = cell_map.statesVersion();
+	}
+
+	if (generations_ == 1) {
+		engine_->step(cell_map.cell_states_, cell_map.resolution(), state_count, this->iterate());
+	} else {
+		engine_->run(cell_map.cell_states_, cell_map.resolution(), state_count,
+								 this->iterate(generations_), generations_);
+	}
+
+	cell_map.uploadStates();
+}
+
+void CSIM::RuleCPU2D::destroy() {
+	Rule::destroy();
+}
+
+void CSIM::RuleCPU2D::syncHostStates(CellMap &cell_map) {
+	/// gpu rule could have been running on the map before, so the states are taken from the ssbo
+	if (!host_states_synced_) {
+		cell_map.downloadStates();
+		host_states_synced_ = true;
+	}
+}
+
+void CSIM::RuleCPU2D::invalidateEngine() noexcept {
+	if (engine_ != nullptr) {
+		engine_->invalidate();
+	}
+}
+
+/// RuleCPU1D impl ///
+
+CSIM::RuleCPU1D::RuleCPU1D(std::shared_ptr<RuleConfig> rule_config,
+													 std::shared_ptr<ThreadPool> thread_pool)
+		: RuleCPU2D(std::move(rule_config), std::move(thread_pool)) {
+}
+
+/// RuleHashLife impl ///
+
+CSIM::RuleHashLife::RuleHashLife(std::shared_ptr<RuleConfig> rule_config,
+																 std::shared_ptr<ThreadPool> thread_pool,
+																 std::size_t memory_budget, bool active_tiles,
+																 std::int32_t generations)
+		: RuleCPU2D(std::move(rule_config), std::move(thread_pool), active_tiles, generations),
+			memory_budget_(memory_budget) {
+}
+
+void CSIM::RuleHashLife::setRuleConfig(std::shared_ptr<RuleConfig> rule_config) {
+	RuleCPU2D::setRuleConfig(std::move(rule_config));
+	hash_life_ = nullptr;
+}
+
+void CSIM::RuleHashLife::setMemoryBudget(std::size_t memory_budget) noexcept {
+	memory_budget_ = memory_budget;
+	if (hash_life_ != nullptr) {
+		hash_life_->setMemoryBudget(memory_budget);
+	}
+}
+
+bool CSIM::RuleHashLife::jump(CellMap &cell_map, std::int32_t state_count,
+															std::uint64_t generations) {
+	if (!HashLife::supports(*this->ruleConfig(), state_count, cell_map.resolution())) {
+		return false;
+	}
+	/// node cache is kept between jumps so that repeated jumps reuse memoized results
+	if (hash_life_ == nullptr) {
+		hash_life_ = std::make_unique<HashLife>(*this->ruleConfig(), memory_budget_);
+	}
+	syncHostStates(cell_map);
+
+	hash_life_->advanceBy(cell_map.cell_states_, cell_map.resolution(), generations);
+	invalidateEngine();
+
+	cell_map.uploadStates();
+
+	/// iteration counter wraps around the same way as after the equivalent number of steps
+	BaseConfig config;
+	config.map_resolution = cell_map.resolution();
+	config.state_count = state_count;
+	config.iteration = static_cast<std::int32_t>(static_cast<std::uint32_t>(this->iteration()) +
+																							 static_cast<std::uint32_t>(generations));
+	this->setBaseConfig(config, true);
+	return true;
+}
+
+std::shared_ptr<CSIM::Shader> CSIM::makeStepShader(RuleConfigType config_type) {
+	switch (config_type) {
+	case RuleConfigType::TOTALISTIC_1D:
+		return std::make_shared<CShader>("shaders/bin/1D_totalistic/comp.spv");
+	case RuleConfigType::BINARY_1D:
+		return std::make_shared<CShader>("shaders/bin/1D_binary/comp.spv");
+	case RuleConfigType::CYCLIC_2D:
+		return std::make_shared<CShader>("shaders/bin/2D_cyclic/comp.spv");
+	case RuleConfigType::LIFE_2D:
+		return std::make_shared<CShader>("shaders/bin/2D_life/comp.spv");
+	}
+	return nullptr;
+}
+
+CSIM::RuleType CSIM::gpuRuleType(const RuleConfig &rule_config) noexcept {
+	switch (rule_config.ruleConfigType()) {
+	case RuleConfigType::TOTALISTIC_1D:
+		return Rule1DPrefixSum::supports(rule_config) ? RuleType::PREFIX_SUM_1D : RuleType::BASIC_1D;
+	case RuleConfigType::BINARY_1D:
+		return RuleType::BASIC_1D;
+	case RuleConfigType::CYCLIC_2D:
+		return Rule2DBoxSum::supports(rule_config) ? RuleType::BOX_SUM_2D : RuleType::BASIC_2D;
+	case RuleConfigType::LIFE_2D:
+		return RuleType::BASIC_2D;
+	}
+	return RuleType::BASIC_2D;
+}
+
+std::shared_ptr<CSIM::Rule> CSIM::makeGPURule(std::shared_ptr<RuleConfig> rule_config,
+																							 bool active_tiles) {
+	switch (gpuRuleType(*rule_config)) {
+	case RuleType::BASIC_1D:
+		return std::make_shared<Rule1D>(std::move(rule_config));
+	case RuleType::PREFIX_SUM_1D:
+		return std::make_shared<Rule1DPrefixSum>(std::move(rule_config));
+	case RuleType::BOX_SUM_2D:
+		return std::make_shared<Rule2DBoxSum>(std::move(rule_config));
+	default:
+		break;
+	}
+	if (active_tiles) {
+		return std::make_shared<Rule2DActiveTiles>(std::move(rule_config));
 	}
+	return std::make_shared<Rule2D>(std::move(rule_config), false);
 }
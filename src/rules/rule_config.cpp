@@ -48,7 +48,7 @@ static auto generateKernelOffsets(bool moore, bool center_active, std::int32_t r
 				const auto true_x = x + 1;
 				offsets.push_back({true_x, true_y});
 				offsets.push_back({-true_x, true_y});
-				offsets.push_back({true_x - true_y});
+				offsets.push_back({true_x, -true_y});
 				offsets.push_back({-true_x, -true_y});
 			}
 		}
@@ -124,7 +124,8 @@ CSIM::RuleConfig2DCyclic::RuleConfig2DCyclic(std::int32_t range, std::int32_t th
 													{"Threshold", std::to_string(threshold)},
 													{"Kernel type", moore ? "Moore" : "Neumann"},
 													{"State insensitive", state_insensitive ? "Yes" : "No"},
-													{"Center active", center_active ? "Yes" : "No"}}) {
+													{"Center active", center_active ? "Yes" : "No"}}),
+			range_(range), moore_(moore), center_active_(center_active) {
 
 	config_.threshold = threshold;
 	config_.state_insensitive = static_cast<std::int32_t>(state_insensitive);
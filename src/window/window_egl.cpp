@@ -0,0 +1,168 @@
+#include "window/window.hpp"
+
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/// offscreen window, GL context is made current without any surface on a surfaceless EGL display,
+/// so the GL path runs without a display server (e.g. on Mesa llvmpipe). There is no default
+/// framebuffer and no input, everything is drawn into framebuffer objects
+
+static std::runtime_error eglError(std::string_view message) {
+	std::array<char, 8> code{}; // NOLINT
+	const auto result = std::to_chars(code.begin(), code.end(), eglGetError(), 16);
+	return std::runtime_error(std::string(message) + ", egl error 0x" +
+														std::string(code.begin(), result.ptr));
+}
+
+/// surfaceless platform doesn't need a gpu or a display server, default display is used if the
+/// platform isn't available
+static EGLDisplay surfacelessDisplay() {
+	const auto *client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	const std::string_view extensions = client_extensions != nullptr ? client_extensions : "";
+	if (extensions.find("EGL_MESA_platform_surfaceless") != std::string_view::npos) {
+		const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>( // NOLINT
+				eglGetProcAddress("eglGetPlatformDisplayEXT"));
+		if (get_platform_display != nullptr) {
+			auto *display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+			if (display != EGL_NO_DISPLAY) {
+				return display;
+			}
+		}
+	}
+	return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+void CSIM::Window::loadGL() {
+	if (gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress)) == 0) { // NOLINT
+		throw std::runtime_error("glad loader failed");
+	}
+}
+
+/// displays are initialized per window
+void CSIM::Window::initWindowingSystem() {
+}
+
+void CSIM::Window::uninitWindowingSystem() {
+	eglReleaseThread();
+}
+
+struct CSIM::Window::UserData {
+	std::function<void(float)> scroll_callback{nullptr};
+	std::function<void(float, float, float, float)> cursor_callback{nullptr};
+	std::chrono::steady_clock::time_point creation_time{std::chrono::steady_clock::now()};
+};
+
+struct CSIM::Window::WinNative {
+	EGLDisplay display{EGL_NO_DISPLAY};
+	EGLContext context{EGL_NO_CONTEXT};
+	std::int32_t width{0};
+	std::int32_t height{0};
+};
+
+/// there is nothing to report errors through, failures are thrown
+CSIM::Window::Window(std::int32_t width, std::int32_t height, std::string_view /*title*/,
+										 void (* /*error_callback*/)(int, const char *))
+		: win_handle_{std::make_shared<WinNative>()},
+			user_data_(new UserData, [](UserData *ptr) { delete ptr; }) // NOLINT
+{
+	win_handle_->width = width;
+	win_handle_->height = height;
+
+	win_handle_->display = surfacelessDisplay();
+	if (win_handle_->display == EGL_NO_DISPLAY ||
+			eglInitialize(win_handle_->display, nullptr, nullptr) == EGL_FALSE) {
+		throw eglError("egl display initialization failed");
+	}
+	if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE) {
+		throw eglError("egl doesn't support OpenGL");
+	}
+
+	/// surface type defaults to window, surfaceless displays have only pbuffer configs
+	constexpr std::array<EGLint, 5> config_attributes{EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+																										EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+	EGLConfig config{nullptr};
+	EGLint config_count{0};
+	if (eglChooseConfig(win_handle_->display, config_attributes.data(), &config, 1, &config_count) ==
+					EGL_FALSE ||
+			config_count == 0) {
+		throw eglError("egl has no OpenGL config");
+	}
+
+	constexpr std::array<EGLint, 7> context_attributes{EGL_CONTEXT_MAJOR_VERSION,
+																										 GLVERSION_MAJOR,
+																										 EGL_CONTEXT_MINOR_VERSION,
+																										 GLVERSION_MINOR,
+																										 EGL_CONTEXT_OPENGL_PROFILE_MASK,
+																										 EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+																										 EGL_NONE};
+	win_handle_->context = eglCreateContext(win_handle_->display, config, EGL_NO_CONTEXT,
+																					context_attributes.data());
+	if (win_handle_->context == EGL_NO_CONTEXT) {
+		throw eglError("context creation failed");
+	}
+	/// requires EGL_KHR_surfaceless_context
+	if (eglMakeCurrent(win_handle_->display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+										 win_handle_->context) == EGL_FALSE) {
+		throw eglError("context can't be made current without a surface");
+	}
+}
+
+void CSIM::Window::destroy() {
+	eglMakeCurrent(win_handle_->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext(win_handle_->display, win_handle_->context);
+	eglTerminate(win_handle_->display);
+}
+
+void *CSIM::Window::native() {
+	return win_handle_->context;
+}
+
+/// keys and buttons are always released (GLFW_RELEASE)
+int CSIM::Window::getKeyState(int /*key_code*/) {
+	return 0;
+}
+int CSIM::Window::getButtonState(int /*button_code*/) {
+	return 0;
+}
+float CSIM::Window::getTime() {
+	const std::chrono::duration<float> time =
+			std::chrono::steady_clock::now() - user_data_->creation_time;
+	return time.count();
+}
+std::tuple<int, int> CSIM::Window::getWindowSize() {
+	return {win_handle_->width, win_handle_->height};
+}
+
+std::tuple<float, float> CSIM::Window::getMousePos() {
+	return {0.f, 0.f};
+}
+
+bool CSIM::Window::shouldClose() {
+	return false;
+}
+
+void CSIM::Window::pollEvents() {
+}
+
+/// there is no surface to present, queued commands are only flushed
+void CSIM::Window::swapBuffers() {
+	glFlush();
+}
+
+/// callbacks are kept but never invoked, there is no input
+void CSIM::Window::setScrollCallback(const std::function<void(float)> &callback) {
+	user_data_->scroll_callback = callback;
+}
+
+void CSIM::Window::setCursorPosCallback(
+		const std::function<void(float, float, float, float)> &callback) {
+	user_data_->cursor_callback = callback;
+}
@@ -0,0 +1,99 @@
+#include "reference.hpp"
+
+#include <cpu/cpu_engine_2d.hpp>
+#include <cpu/cpu_engine_life_swar.hpp>
+#include <cpu/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace CSIM;
+
+/**
+ * sparse map which quickly settles into mostly quiescent tiles, with a glider crossing tile borders
+ */
+static std::vector<CellState> sparseStates(Vec2<std::int32_t> resolution, std::int32_t state_count,
+																					 std::uint32_t seed) {
+	auto states = randomStates(resolution, state_count, .03, seed);
+	const std::vector<Vec2<std::int32_t>> glider{{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}};
+	for (const auto cell : glider) {
+		states[static_cast<std::size_t>(cell.x + 30 + (cell.y + 30) * resolution.x)] = 1;
+	}
+	return states;
+}
+
+/**
+ * steps the engine and the reference side by side, in the middle of the run a quiescent corner of
+ * the map is overwritten behind the engine's back and the engine is invalidated
+ */
+static void checkActiveTiles(const RuleConfig &rule_config, CPUEngine &engine,
+														 Vec2<std::int32_t> resolution, std::int32_t state_count,
+														 std::uint32_t seed) {
+	auto states = sparseStates(resolution, state_count, seed);
+	auto expected = states;
+	for (std::int32_t generation = 0; generation < 40; ++generation) {
+		if (generation == 20) {
+			for (std::int32_t y = 0; y < 6; ++y) {
+				for (std::int32_t x = 0; x < 6; ++x) {
+					const auto index = static_cast<std::size_t>(resolution.x - 8 + x +
+																											(resolution.y - 8 + y) * resolution.x);
+					states[index] = static_cast<CellState>((x * 3 + y) % state_count);
+					expected[index] = states[index];
+				}
+			}
+			engine.invalidate();
+		}
+		engine.step(states, resolution, state_count, generation);
+		referenceStep2D(rule_config, expected, resolution, state_count);
+		INFO("generation " << generation);
+		REQUIRE(states == expected);
+	}
+}
+
+TEST_CASE("CPUEngine2D with active tiles runs like the reference", "[cpu][2d][active_tiles]") {
+	const std::vector<Vec2<std::int32_t>> resolutions{{160, 128}, {100, 70}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const auto state_insensitive : {true, false}) {
+		for (const std::int32_t state_count : {2, 4}) {
+			const RuleConfig2DLife life(true, state_insensitive, false, {2, 3}, {3}, nullptr);
+			const RuleConfig2DCyclic cyclic(2, 3, false, state_insensitive, false, nullptr);
+			for (const auto resolution : resolutions) {
+				INFO("state insensitive " << state_insensitive << " states " << state_count << " map "
+																	<< resolution.x << "x" << resolution.y);
+				CPUEngine2D life_engine(life, thread_pool, true);
+				checkActiveTiles(life, life_engine, resolution, state_count, 1);
+				CPUEngine2D cyclic_engine(cyclic, thread_pool, true);
+				checkActiveTiles(cyclic, cyclic_engine, resolution, state_count, 2);
+			}
+		}
+	}
+}
+
+TEST_CASE("CPUEngineLifeSWAR with active tiles runs like the reference",
+					"[cpu][swar][active_tiles]") {
+	/// widths with and without a partial last word
+	const std::vector<Vec2<std::int32_t>> resolutions{{192, 128}, {100, 70}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const auto moore : {true, false}) {
+		const RuleConfig2DLife config(moore, true, false, {2, 3}, {3}, nullptr);
+		for (const auto resolution : resolutions) {
+			INFO("moore " << moore << " map " << resolution.x << "x" << resolution.y);
+			CPUEngineLifeSWAR engine(config, thread_pool, true);
+			checkActiveTiles(config, engine, resolution, 2, 3);
+
+			/// runs keep the packed map and the tracked tiles between calls
+			auto states = sparseStates(resolution, 2, 4);
+			auto expected = states;
+			engine.invalidate();
+			for (std::int32_t run = 0; run < 3; ++run) {
+				engine.run(states, resolution, 2, 0, 13);
+				for (std::int32_t generation = 0; generation < 13; ++generation) {
+					referenceStep2D(config, expected, resolution, 2);
+				}
+				INFO("run " << run);
+				REQUIRE(states == expected);
+			}
+		}
+	}
+}
@@ -0,0 +1,123 @@
+#include "reference.hpp"
+
+#include <cpu/cpu_engine_1d_binary.hpp>
+#include <cpu/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+using namespace CSIM;
+
+/**
+ * @return pattern match code of an elementary (range 1) rule in Wolfram's numbering
+ */
+static std::string elementaryCode(std::uint32_t rule) {
+	std::string code;
+	for (std::uint32_t pattern = 0; pattern < 8; ++pattern) {
+		code += ((rule >> pattern) & 1u) != 0 ? '1' : '0';
+	}
+	return code;
+}
+
+/**
+ * @return random pattern match code covering every pattern of range
+ */
+static std::string randomCode(std::int32_t range, std::uint32_t seed) {
+	std::mt19937 generator{seed};
+	std::bernoulli_distribution set{.5};
+	std::string code(std::size_t{1} << static_cast<std::size_t>(2 * range + 1), '0');
+	for (auto &c : code) {
+		c = set(generator) ? '1' : '0';
+	}
+	return code;
+}
+
+/**
+ * steps the engine and the reference side by side over more iterations than rows, then checks a
+ * run of several generations
+ */
+static void checkAgainstReference(const RuleConfig &rule_config, CPUEngine &engine,
+																	Vec2<std::int32_t> resolution, std::int32_t state_count,
+																	std::int32_t iterations, std::uint32_t seed) {
+	auto states = randomStates(resolution, state_count, .4, seed);
+	auto expected = states;
+	for (std::int32_t iteration = 0; iteration < iterations; ++iteration) {
+		engine.step(states, resolution, state_count, iteration);
+		referenceStep1D(rule_config, expected, resolution, state_count, iteration);
+		INFO("iteration " << iteration);
+		REQUIRE(states == expected);
+	}
+
+	engine.run(states, resolution, state_count, iterations, 2 * resolution.y + 1);
+	for (std::int32_t generation = 0; generation < 2 * resolution.y + 1; ++generation) {
+		referenceStep1D(rule_config, expected, resolution, state_count, iterations + generation);
+	}
+	REQUIRE(states == expected);
+}
+
+TEST_CASE("CPUEngine1DBinary runs elementary rules like the reference", "[cpu][1d][binary]") {
+	/// widths around the 64 cell word size
+	const std::vector<Vec2<std::int32_t>> resolutions{{64, 5}, {200, 7}, {65, 4}, {9, 3}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const std::uint32_t rule : {30u, 90u, 110u, 184u, 0u, 255u}) {
+		const RuleConfig1DBinary config(1, elementaryCode(rule), nullptr);
+		for (const auto resolution : resolutions) {
+			for (const std::int32_t state_count : {2, 4}) {
+				INFO("rule " << rule << " map " << resolution.x << "x" << resolution.y << " states "
+										 << state_count);
+				CPUEngine1DBinary engine(config, thread_pool);
+				checkAgainstReference(config, engine, resolution, state_count, 2 * resolution.y + 3,
+															rule);
+			}
+		}
+	}
+}
+
+TEST_CASE("CPUEngine1DBinary runs random pattern match codes like the reference",
+					"[cpu][1d][binary]") {
+	/// neighbourhood of the widest range wraps around the narrowest row several times
+	const std::vector<Vec2<std::int32_t>> resolutions{{64, 4}, {333, 5}, {10, 3}, {3, 4}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+	bool used_expression{false};
+	bool used_lookup{false};
+
+	for (std::int32_t range = 0; range <= static_cast<std::int32_t>(RuleConfig1DBinary::RANGE_LIM.y);
+			 ++range) {
+		for (std::uint32_t seed = 0; seed < 4; ++seed) {
+			const RuleConfig1DBinary config(range, randomCode(range, seed), nullptr);
+			for (const auto resolution : resolutions) {
+				INFO("range " << range << " seed " << seed << " map " << resolution.x << "x"
+											<< resolution.y);
+				CPUEngine1DBinary engine(config, thread_pool);
+				used_expression = used_expression || engine.usesExpression();
+				used_lookup = used_lookup || !engine.usesExpression();
+				checkAgainstReference(config, engine, resolution, 3, 2 * resolution.y + 3, seed);
+			}
+		}
+	}
+	/// both evaluators are covered
+	REQUIRE(used_expression);
+	REQUIRE(used_lookup);
+}
+
+TEST_CASE("CPUEngine1DBinary splits wide rows between workers", "[cpu][1d][binary]") {
+	const auto width =
+			static_cast<std::int32_t>(CPUEngine1DBinary::PARALLEL_MIN_WORDS * 64 + 100);
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const auto &code : {elementaryCode(110), randomCode(4, 7)}) {
+		const RuleConfig1DBinary config(code.size() == 8 ? 1 : 4, code, nullptr);
+		CPUEngine1DBinary engine(config, thread_pool);
+		checkAgainstReference(config, engine, {width, 2}, 2, 3, 5);
+	}
+}
+
+TEST_CASE("CPUEngine1DBinary supports only 1D binary configs", "[cpu][1d][binary]") {
+	REQUIRE(CPUEngine1DBinary::supports(RuleConfig1DBinary(2, randomCode(2, 0), nullptr)));
+	REQUIRE_FALSE(
+			CPUEngine1DBinary::supports(RuleConfig1DTotalistic(2, true, {1}, {2}, nullptr)));
+	REQUIRE_FALSE(CPUEngine1DBinary::supports(
+			RuleConfig2DLife(true, true, false, {2, 3}, {3}, nullptr)));
+}
@@ -0,0 +1,107 @@
+#include "reference.hpp"
+
+#include <cpu/cpu_engine_1d_totalistic.hpp>
+#include <cpu/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace CSIM;
+
+/**
+ * steps the engine and the reference side by side over more iterations than rows
+ */
+static void checkAgainstReference(const RuleConfig &rule_config, CPUEngine &engine,
+																	Vec2<std::int32_t> resolution, std::int32_t state_count,
+																	std::int32_t iterations, std::uint32_t seed) {
+	auto states = randomStates(resolution, state_count, .4, seed);
+	auto expected = states;
+	for (std::int32_t iteration = 0; iteration < iterations; ++iteration) {
+		engine.step(states, resolution, state_count, iteration);
+		referenceStep1D(rule_config, expected, resolution, state_count, iteration);
+		INFO("iteration " << iteration);
+		REQUIRE(states == expected);
+	}
+}
+
+/**
+ * @return sums in [0, 2 * range + 1] taken with probability density
+ */
+static std::vector<std::size_t> randomConditions(std::int32_t range, double density,
+																								 std::uint32_t seed) {
+	std::mt19937 generator{seed};
+	std::bernoulli_distribution taken{density};
+	std::vector<std::size_t> conditions;
+	for (std::size_t sum = 0; sum <= static_cast<std::size_t>(2 * range + 1); ++sum) {
+		if (taken(generator)) {
+			conditions.push_back(sum);
+		}
+	}
+	return conditions;
+}
+
+TEST_CASE("CPUEngine1DTotalistic runs 1D totalistic configs like the reference",
+					"[cpu][1d][totalistic]") {
+	const std::vector<Vec2<std::int32_t>> resolutions{{64, 5}, {301, 4}, {23, 3}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const std::int32_t range : {0, 1, 2, 5, 11}) {
+		for (const auto center_active : {true, false}) {
+			for (std::uint32_t seed = 0; seed < 3; ++seed) {
+				const RuleConfig1DTotalistic config(range, center_active,
+																						randomConditions(range, .5, seed),
+																						randomConditions(range, .3, seed + 10), nullptr);
+				for (const auto resolution : resolutions) {
+					for (const std::int32_t state_count : {2, 5}) {
+						INFO("range " << range << " center " << center_active << " seed " << seed << " map "
+													<< resolution.x << "x" << resolution.y << " states " << state_count);
+						CPUEngine1DTotalistic engine(config, thread_pool);
+						checkAgainstReference(config, engine, resolution, state_count, 2 * resolution.y + 3,
+																	seed);
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("CPUEngine1DTotalistic handles ranges wider than the row", "[cpu][1d][totalistic]") {
+	auto thread_pool = std::make_shared<ThreadPool>(2);
+	/// neighbourhood wraps around the row several times, cells are counted once per occurrence
+	for (const std::int32_t range : {40, 300}) {
+		const RuleConfig1DTotalistic config(range, true, randomConditions(range, .5, 1),
+																				randomConditions(range, .5, 2), nullptr);
+		CPUEngine1DTotalistic engine(config, thread_pool);
+		checkAgainstReference(config, engine, {17, 3}, 3, 7, 4);
+	}
+}
+
+TEST_CASE("CPUEngine1DTotalistic runs the largest range", "[cpu][1d][totalistic]") {
+	const auto range = static_cast<std::int32_t>(RuleConfig1DTotalistic::RANGE_LIM.y);
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+	/// conditions near the largest sum as well, they are only reached by dense rows
+	auto survival = randomConditions(range, .5, 3);
+	survival.push_back(2 * range + 1);
+	const RuleConfig1DTotalistic config(range, true, survival, randomConditions(range, .5, 4),
+																			nullptr);
+	CPUEngine1DTotalistic engine(config, thread_pool);
+	checkAgainstReference(config, engine, {2 * range + 501, 2}, 2, 3, 5);
+}
+
+TEST_CASE("CPUEngine1DTotalistic splits wide rows between workers", "[cpu][1d][totalistic]") {
+	const auto width = static_cast<std::int32_t>(CPUEngine1DTotalistic::PARALLEL_MIN_CELLS + 333);
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const std::int32_t range : {1, 7}) {
+		const RuleConfig1DTotalistic config(range, false, randomConditions(range, .5, 5),
+																				randomConditions(range, .5, 6), nullptr);
+		CPUEngine1DTotalistic engine(config, thread_pool);
+		checkAgainstReference(config, engine, {width, 2}, 2, 3, 6);
+	}
+}
+
+TEST_CASE("CPUEngine1DTotalistic supports only 1D totalistic configs", "[cpu][1d][totalistic]") {
+	REQUIRE(CPUEngine1DTotalistic::supports(RuleConfig1DTotalistic(2, true, {1}, {2}, nullptr)));
+	REQUIRE_FALSE(CPUEngine1DTotalistic::supports(RuleConfig1DBinary(1, "01111000", nullptr)));
+	REQUIRE_FALSE(CPUEngine1DTotalistic::supports(
+			RuleConfig2DLife(true, true, false, {2, 3}, {3}, nullptr)));
+}
@@ -0,0 +1,161 @@
+#include "reference.hpp"
+
+#include <cpu/cpu_engine_2d.hpp>
+#include <cpu/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace CSIM;
+
+/**
+ * steps the engine and the reference side by side and checks every generation
+ */
+static void checkAgainstReference(const RuleConfig &rule_config, CPUEngine &engine,
+																	Vec2<std::int32_t> resolution, std::int32_t state_count,
+																	std::int32_t generations, std::uint32_t seed) {
+	auto states = randomStates(resolution, state_count, .4, seed);
+	auto expected = states;
+	for (std::int32_t generation = 0; generation < generations; ++generation) {
+		engine.step(states, resolution, state_count, generation);
+		referenceStep2D(rule_config, expected, resolution, state_count);
+		INFO("generation " << generation);
+		REQUIRE(states == expected);
+	}
+}
+
+TEST_CASE("CPUEngine2D runs 2D life configs like the reference", "[cpu][2d]") {
+	const std::vector<Vec2<std::int32_t>> resolutions{{64, 64}, {37, 53}, {100, 3}, {5, 7}};
+	const std::vector<std::vector<std::size_t>> survival{{2, 3}, {1, 3, 5, 8}, {0, 4}};
+	const std::vector<std::vector<std::size_t>> birth{{3}, {3, 6, 7, 8}, {1, 2}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const auto moore : {true, false}) {
+		for (const auto state_insensitive : {true, false}) {
+			for (const auto center_active : {true, false}) {
+				for (std::size_t conditions = 0; conditions < survival.size(); ++conditions) {
+					const RuleConfig2DLife config(moore, state_insensitive, center_active,
+																				survival[conditions], birth[conditions], nullptr);
+					for (const auto resolution : resolutions) {
+						for (const std::int32_t state_count : {2, 5}) {
+							INFO("moore " << moore << " state insensitive " << state_insensitive
+														<< " center " << center_active << " conditions " << conditions
+														<< " map " << resolution.x << "x" << resolution.y << " states "
+														<< state_count);
+							CPUEngine2D engine(config, thread_pool);
+							checkAgainstReference(config, engine, resolution, state_count, 4,
+																		static_cast<std::uint32_t>(conditions));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("CPUEngine2D runs 2D cyclic configs like the reference", "[cpu][2d]") {
+	const std::vector<Vec2<std::int32_t>> resolutions{{64, 64}, {41, 29}};
+	auto thread_pool = std::make_shared<ThreadPool>(3);
+
+	for (const std::int32_t range : {1, 2, 3}) {
+		for (const auto moore : {true, false}) {
+			for (const auto state_insensitive : {true, false}) {
+				for (const auto center_active : {true, false}) {
+					const auto threshold = moore ? range * (range + 1) : range + 1;
+					const RuleConfig2DCyclic config(range, threshold, moore, state_insensitive,
+																					center_active, nullptr);
+					for (const auto resolution : resolutions) {
+						for (const std::int32_t state_count : {2, 4}) {
+							INFO("range " << range << " moore " << moore << " state insensitive "
+														<< state_insensitive << " center " << center_active << " map "
+														<< resolution.x << "x" << resolution.y << " states " << state_count);
+							CPUEngine2D engine(config, thread_pool);
+							checkAgainstReference(config, engine, resolution, state_count, 4,
+																		static_cast<std::uint32_t>(range));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("CPUEngine2D doesn't depend on the thread count", "[cpu][2d]") {
+	const RuleConfig2DLife config(true, true, false, {2, 3}, {3}, nullptr);
+	const Vec2<std::int32_t> resolution{97, 61};
+	for (const std::size_t thread_count : {1u, 2u, 7u}) {
+		INFO("threads " << thread_count);
+		CPUEngine2D engine(config, std::make_shared<ThreadPool>(thread_count));
+		checkAgainstReference(config, engine, resolution, 2, 8, 7);
+	}
+}
+
+/**
+ * runs generations at once and compares the result with generations reference steps
+ */
+static void checkRunAgainstReference(const RuleConfig &rule_config, CPUEngine &engine,
+																		 Vec2<std::int32_t> resolution, std::int32_t state_count,
+																		 std::int32_t generations, std::uint32_t seed) {
+	auto states = randomStates(resolution, state_count, .4, seed);
+	auto expected = states;
+	engine.run(states, resolution, state_count, 0, generations);
+	for (std::int32_t generation = 0; generation < generations; ++generation) {
+		referenceStep2D(rule_config, expected, resolution, state_count);
+	}
+	REQUIRE(states == expected);
+}
+
+TEST_CASE("CPUEngine2D runs temporal blocks like the reference", "[cpu][2d][temporal]") {
+	/// maps with partial block tiles and maps smaller than the halo of a block
+	const std::vector<Vec2<std::int32_t>> resolutions{{160, 136}, {129, 40}, {10, 7}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	/// range 1 fits 16 generations into a block, range 3 five, range 5 three and range 9 only one
+	for (const std::int32_t range : {1, 3, 5, 9}) {
+		const auto block_generations = 16 / range;
+		for (const auto moore : {true, false}) {
+			const auto threshold = moore ? range * (range + 1) : range + 1;
+			const RuleConfig2DCyclic cyclic(range, threshold, moore, false, false, nullptr);
+			for (const auto resolution : resolutions) {
+				/// single block, partial last block and several blocks
+				for (const auto generations :
+						 {2, block_generations + 1, 2 * block_generations + 3}) {
+					INFO("range " << range << " moore " << moore << " map " << resolution.x << "x"
+												<< resolution.y << " generations " << generations);
+					CPUEngine2D engine(cyclic, thread_pool);
+					checkRunAgainstReference(cyclic, engine, resolution, 3, generations,
+																	 static_cast<std::uint32_t>(range));
+				}
+			}
+		}
+	}
+
+	for (const auto state_insensitive : {true, false}) {
+		const RuleConfig2DLife life(true, state_insensitive, false, {2, 3}, {3}, nullptr);
+		for (const auto resolution : resolutions) {
+			for (const std::int32_t generations : {16, 17, 50}) {
+				INFO("state insensitive " << state_insensitive << " map " << resolution.x << "x"
+																	<< resolution.y << " generations " << generations);
+				CPUEngine2D engine(life, thread_pool);
+				checkRunAgainstReference(life, engine, resolution, 4, generations, 9);
+			}
+		}
+	}
+}
+
+TEST_CASE("makeCPUEngine runs 2D configs like the reference", "[cpu][2d][temporal]") {
+	const Vec2<std::int32_t> resolution{200, 136};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+	const RuleConfig2DLife life(true, true, false, {2, 3}, {3}, nullptr);
+	const RuleConfig2DLife state_sensitive_life(false, false, true, {1, 2}, {1}, nullptr);
+	const RuleConfig2DCyclic cyclic(2, 5, true, true, false, nullptr);
+
+	for (const auto *config : std::initializer_list<const RuleConfig *>{
+					 &life, &state_sensitive_life, &cyclic}) {
+		for (const std::int32_t state_count : {2, 3}) {
+			INFO(config->ruleConfigName() << " states " << state_count);
+			const auto engine = makeCPUEngine(*config, state_count, thread_pool);
+			REQUIRE(engine != nullptr);
+			checkRunAgainstReference(*config, *engine, resolution, state_count, 21, 11);
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#include "reference.hpp"
+
+#include <cpu/cpu_engine_box_sum.hpp>
+#include <cpu/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace CSIM;
+
+TEST_CASE("CPUEngineBoxSum2D runs large range cyclic configs like the reference",
+					"[cpu][box_sum]") {
+	/// maps are at least as large as the widest kernel, one of them spans several row chunks
+	const std::vector<Vec2<std::int32_t>> resolutions{{64, 64}, {45, 23}, {30, 140}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const std::int32_t range : {2, 3, 5, 10}) {
+		for (const auto moore : {true, false}) {
+			for (const auto center_active : {true, false}) {
+				const auto kernel_size =
+						moore ? (2 * range + 1) * (2 * range + 1) : 2 * range * (range + 1);
+				for (const auto threshold : {1, kernel_size / 4, kernel_size / 2}) {
+					const RuleConfig2DCyclic config(range, threshold, moore, true, center_active, nullptr);
+					REQUIRE(CPUEngineBoxSum2D::supports(config));
+					for (const auto resolution : resolutions) {
+						for (const std::int32_t state_count : {2, 5}) {
+							INFO("range " << range << " moore " << moore << " center " << center_active
+														<< " threshold " << threshold << " map " << resolution.x << "x"
+														<< resolution.y << " states " << state_count);
+							CPUEngineBoxSum2D engine(config, thread_pool);
+							auto states = randomStates(resolution, state_count, .4,
+																				 static_cast<std::uint32_t>(range + threshold));
+							auto expected = states;
+							for (std::int32_t generation = 0; generation < 3; ++generation) {
+								engine.step(states, resolution, state_count, generation);
+								referenceStep2D(config, expected, resolution, state_count);
+								INFO("generation " << generation);
+								REQUIRE(states == expected);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("CPUEngineBoxSum2D supports only state insensitive configs of larger ranges",
+					"[cpu][box_sum]") {
+	REQUIRE(CPUEngineBoxSum2D::supports(RuleConfig2DCyclic(2, 3, true, true, false, nullptr)));
+	REQUIRE_FALSE(CPUEngineBoxSum2D::supports(RuleConfig2DCyclic(1, 3, true, true, false, nullptr)));
+	REQUIRE_FALSE(
+			CPUEngineBoxSum2D::supports(RuleConfig2DCyclic(4, 3, true, false, false, nullptr)));
+	REQUIRE_FALSE(
+			CPUEngineBoxSum2D::supports(RuleConfig2DLife(true, true, false, {2, 3}, {3}, nullptr)));
+}
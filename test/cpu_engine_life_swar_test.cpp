@@ -0,0 +1,57 @@
+#include "reference.hpp"
+
+#include <cpu/cpu_engine_life_swar.hpp>
+#include <cpu/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace CSIM;
+
+TEST_CASE("CPUEngineLifeSWAR runs two state 2D life configs like the reference", "[cpu][swar]") {
+	/// widths around the 64 cell word size, rows wrap inside the last word
+	const std::vector<Vec2<std::int32_t>> resolutions{{64, 64}, {130, 70}, {65, 3}, {7, 9}};
+	const std::vector<std::vector<std::size_t>> survival{{2, 3}, {1, 3, 5, 8}, {0, 4, 9}};
+	const std::vector<std::vector<std::size_t>> birth{{3}, {3, 6, 7, 8}, {1, 2}};
+	auto thread_pool = std::make_shared<ThreadPool>(4);
+
+	for (const auto moore : {true, false}) {
+		for (const auto center_active : {true, false}) {
+			for (std::size_t conditions = 0; conditions < survival.size(); ++conditions) {
+				const RuleConfig2DLife config(moore, true, center_active, survival[conditions],
+																			birth[conditions], nullptr);
+				REQUIRE(CPUEngineLifeSWAR::supports(config, 2));
+				for (const auto resolution : resolutions) {
+					INFO("moore " << moore << " center " << center_active << " conditions " << conditions
+												<< " map " << resolution.x << "x" << resolution.y);
+					CPUEngineLifeSWAR engine(config, thread_pool);
+					auto states = randomStates(resolution, 2, .4, static_cast<std::uint32_t>(conditions));
+					auto expected = states;
+					for (std::int32_t generation = 0; generation < 4; ++generation) {
+						engine.step(states, resolution, 2, generation);
+						referenceStep2D(config, expected, resolution, 2);
+						INFO("generation " << generation);
+						REQUIRE(states == expected);
+					}
+
+					/// runs keep the packed map between generations
+					engine.run(states, resolution, 2, 4, 9);
+					for (std::int32_t generation = 0; generation < 9; ++generation) {
+						referenceStep2D(config, expected, resolution, 2);
+					}
+					REQUIRE(states == expected);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("CPUEngineLifeSWAR supports only two state insensitive configs", "[cpu][swar]") {
+	const RuleConfig2DLife state_insensitive(true, true, false, {2, 3}, {3}, nullptr);
+	const RuleConfig2DLife state_sensitive(true, false, false, {2, 3}, {3}, nullptr);
+	const RuleConfig2DCyclic cyclic(1, 3, true, true, false, nullptr);
+
+	REQUIRE(CPUEngineLifeSWAR::supports(state_insensitive, 2));
+	REQUIRE_FALSE(CPUEngineLifeSWAR::supports(state_insensitive, 3));
+	REQUIRE_FALSE(CPUEngineLifeSWAR::supports(state_sensitive, 2));
+	REQUIRE_FALSE(CPUEngineLifeSWAR::supports(cyclic, 2));
+}
@@ -0,0 +1,76 @@
+#include "reference.hpp"
+
+#include <cpu/hash_life.hpp>
+
+#include <catch2/catch.hpp>
+
+using namespace CSIM;
+
+static void referenceSteps(const RuleConfig &rule_config, std::vector<CellState> &states,
+													 Vec2<std::int32_t> resolution, std::uint64_t generations) {
+	for (std::uint64_t generation = 0; generation < generations; ++generation) {
+		referenceStep2D(rule_config, states, resolution, 2);
+	}
+}
+
+TEST_CASE("HashLife jumps like the reference steps", "[cpu][hash_life]") {
+	const std::vector<Vec2<std::int32_t>> resolutions{{8, 8}, {64, 32}, {16, 128}};
+	const std::vector<std::vector<std::size_t>> survival{{2, 3}, {2, 3}, {1, 3, 5, 8}};
+	const std::vector<std::vector<std::size_t>> birth{{3}, {3, 6}, {3, 5, 7}};
+
+	for (const auto moore : {true, false}) {
+		for (const auto center_active : {true, false}) {
+			for (std::size_t conditions = 0; conditions < survival.size(); ++conditions) {
+				const RuleConfig2DLife config(moore, true, center_active, survival[conditions],
+																			birth[conditions], nullptr);
+				for (const auto resolution : resolutions) {
+					REQUIRE(HashLife::supports(config, 2, resolution));
+					INFO("moore " << moore << " center " << center_active << " conditions " << conditions
+												<< " map " << resolution.x << "x" << resolution.y);
+					HashLife hash_life(config);
+					auto states = randomStates(resolution, 2, .3, static_cast<std::uint32_t>(conditions));
+					auto expected = states;
+					for (std::uint32_t power = 0; power <= 5; ++power) {
+						hash_life.advance(states, resolution, power);
+						referenceSteps(config, expected, resolution, std::uint64_t{1} << power);
+						INFO("power " << power);
+						REQUIRE(states == expected);
+					}
+					for (const std::uint64_t generations : {1u, 7u, 100u}) {
+						hash_life.advanceBy(states, resolution, generations);
+						referenceSteps(config, expected, resolution, generations);
+						INFO("generations " << generations);
+						REQUIRE(states == expected);
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("HashLife stays exact when the node cache is collected", "[cpu][hash_life]") {
+	const RuleConfig2DLife config(true, true, false, {}, {2}, nullptr);
+	const Vec2<std::int32_t> resolution{128, 128};
+	/// smallest budget, chaotic seeds rule outgrows the minimal node cache during every jump
+	HashLife hash_life(config, 1);
+	auto states = randomStates(resolution, 2, .3, 3);
+	auto expected = states;
+	for (std::int32_t jump = 0; jump < 3; ++jump) {
+		hash_life.advanceBy(states, resolution, 128);
+		referenceSteps(config, expected, resolution, 128);
+		INFO("jump " << jump);
+		REQUIRE(states == expected);
+	}
+}
+
+TEST_CASE("HashLife supports only two state range 1 life configs on power of two maps",
+					"[cpu][hash_life]") {
+	const RuleConfig2DLife life(true, true, false, {2, 3}, {3}, nullptr);
+	REQUIRE(HashLife::supports(life, 2, {64, 16}));
+	REQUIRE_FALSE(HashLife::supports(life, 3, {64, 16}));
+	REQUIRE_FALSE(HashLife::supports(life, 2, {48, 16}));
+	REQUIRE_FALSE(HashLife::supports(RuleConfig2DLife(true, false, false, {2, 3}, {3}, nullptr), 2,
+																	 {64, 16}));
+	REQUIRE_FALSE(HashLife::supports(RuleConfig2DCyclic(1, 3, true, true, false, nullptr), 2,
+																	 {64, 16}));
+}
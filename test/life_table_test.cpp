@@ -0,0 +1,69 @@
+#include <cpu/life_table.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace CSIM;
+
+TEST_CASE("LifeTable entries follow the config conditions", "[cpu][life_table]") {
+	/// conway, high life, day and night and seeds are taken from the baked tables
+	const std::vector<std::vector<std::size_t>> survival{
+			{2, 3}, {2, 3}, {3, 4, 6, 7, 8}, {}, {0, 1, 9}, {1, 3, 5, 7}};
+	const std::vector<std::vector<std::size_t>> birth{
+			{3}, {3, 6}, {3, 6, 7, 8}, {2}, {0, 4, 9}, {2, 4, 6, 8}};
+
+	for (const auto moore : {true, false}) {
+		for (const auto state_insensitive : {true, false}) {
+			for (const auto center_active : {true, false}) {
+				for (std::size_t conditions = 0; conditions < survival.size(); ++conditions) {
+					const RuleConfig2DLife rule_config(moore, state_insensitive, center_active,
+																						 survival[conditions], birth[conditions], nullptr);
+					const auto &config = rule_config.config();
+					const auto table = LifeTable::compile(rule_config);
+					INFO("moore " << moore << " state insensitive " << state_insensitive << " center "
+												<< center_active << " conditions " << conditions);
+
+					for (std::uint32_t pattern = 0; pattern < LifeTable::SIZE; ++pattern) {
+						/// neighbour in state after the center state never is the center itself
+						std::size_t sum{0};
+						for (std::int32_t i = 0; i < config.offsets_count; ++i) {
+							const auto offset = config.offsets[i]; // NOLINT
+							const auto bit = static_cast<std::uint32_t>((offset.y + 1) * 3 + offset.x + 1);
+							const auto is_center = offset.x == 0 && offset.y == 0;
+							if (((pattern >> bit) & 1u) != 0 && (state_insensitive || !is_center)) {
+								++sum;
+							}
+						}
+						const auto alive = (pattern & LifeTable::CENTER_BIT) != 0;
+						const auto expected = alive ? config.survival_conditions_hashmap[sum] // NOLINT
+																				: config.birth_conditions_hashmap[sum];		// NOLINT
+						INFO("pattern " << pattern);
+						REQUIRE(table[pattern] == expected);
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("LifeTable compiles well known rules into the baked tables", "[cpu][life_table]") {
+	const auto compiled_from = [](const LifeTable &table, const RuleConfig2DLife &rule_config) {
+		const auto compiled = LifeTable::compile(rule_config);
+		for (std::uint32_t pattern = 0; pattern < LifeTable::SIZE; ++pattern) {
+			if (compiled[pattern] != table[pattern]) {
+				return false;
+			}
+		}
+		return true;
+	};
+	REQUIRE(compiled_from(CONWAY_LIFE_TABLE,
+												RuleConfig2DLife(true, true, false, {2, 3}, {3}, nullptr)));
+	REQUIRE(compiled_from(HIGH_LIFE_TABLE,
+												RuleConfig2DLife(true, true, false, {2, 3}, {3, 6}, nullptr)));
+	REQUIRE(compiled_from(DAY_AND_NIGHT_TABLE, RuleConfig2DLife(true, true, false, {3, 4, 6, 7, 8},
+																															{3, 6, 7, 8}, nullptr)));
+	REQUIRE(compiled_from(SEEDS_TABLE, RuleConfig2DLife(true, true, false, {}, {2}, nullptr)));
+	REQUIRE_FALSE(compiled_from(CONWAY_LIFE_TABLE,
+															RuleConfig2DLife(false, true, false, {2, 3}, {3}, nullptr)));
+}
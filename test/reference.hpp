@@ -0,0 +1,162 @@
+#ifndef CELLSIM_TEST_REFERENCE_HPP
+#define CELLSIM_TEST_REFERENCE_HPP
+
+#include "utils/cell_state.hpp"
+#include "utils/vecs.hpp"
+#include <rules/rule_config.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/// reference implementations of the rules, they follow the compute shaders cell by cell without
+/// any of the engine optimizations, so engines are checked by comparing their results with them
+
+namespace CSIM {
+
+/**
+ * @return coordinate wrapped into [0, extent)
+ */
+inline std::int32_t referenceWrap(std::int32_t value, std::int32_t extent) noexcept {
+	return ((value % extent) + extent) % extent;
+}
+
+/**
+ * @return map with cells alive with probability density, alive cells get random states in
+ * [1, state_count)
+ */
+inline std::vector<CellState> randomStates(Vec2<std::int32_t> resolution, std::int32_t state_count,
+																					 double density, std::uint32_t seed) {
+	std::mt19937 generator{seed};
+	std::bernoulli_distribution alive{density};
+	std::uniform_int_distribution<std::int32_t> state{1, state_count - 1};
+	std::vector<CellState> states(static_cast<std::size_t>(resolution.x) *
+																static_cast<std::size_t>(resolution.y));
+	for (auto &cell : states) {
+		cell = alive(generator) ? static_cast<CellState>(state(generator)) : CellState{0};
+	}
+	return states;
+}
+
+/**
+ * advances the map by one generation of a 2D life or 2D cyclic config, neighbours are summed over
+ * the config offsets like in the 2D_life and 2D_cyclic shaders
+ */
+inline void referenceStep2D(const RuleConfig &rule_config, std::vector<CellState> &states,
+														Vec2<std::int32_t> resolution, std::int32_t state_count) {
+	std::vector<Vec2<std::int32_t>> offsets;
+	bool state_insensitive{false};
+	const auto *life_config = rule_config.ruleConfigType() == RuleConfigType::LIFE_2D
+																? &static_cast<const RuleConfig2DLife &>(rule_config).config()
+																: nullptr;
+	const auto *cyclic_config = rule_config.ruleConfigType() == RuleConfigType::CYCLIC_2D
+																	? &static_cast<const RuleConfig2DCyclic &>(rule_config).config()
+																	: nullptr;
+	if (life_config != nullptr) {
+		for (std::int32_t i = 0; i < life_config->offsets_count; ++i) {
+			offsets.push_back({life_config->offsets[i].x, life_config->offsets[i].y}); // NOLINT
+		}
+		state_insensitive = life_config->state_insensitive != 0;
+	} else {
+		for (std::int32_t i = 0; i < cyclic_config->offsets_count; ++i) {
+			offsets.push_back(cyclic_config->offsets[i]); // NOLINT
+		}
+		state_insensitive = cyclic_config->state_insensitive != 0;
+	}
+
+	const auto src = states;
+	for (std::int32_t y = 0; y < resolution.y; ++y) {
+		for (std::int32_t x = 0; x < resolution.x; ++x) {
+			const auto index = static_cast<std::size_t>(x + y * resolution.x);
+			const std::int32_t state = src[index];
+			std::int32_t sum{0};
+			for (const auto offset : offsets) {
+				const std::int32_t neighbour = src[static_cast<std::size_t>(
+						referenceWrap(x + offset.x, resolution.x) +
+						referenceWrap(y + offset.y, resolution.y) * resolution.x)];
+				if (state_insensitive ? neighbour > 0 : neighbour == state + 1) {
+					++sum;
+				}
+			}
+
+			std::int32_t next{state};
+			if (life_config != nullptr) {
+				if (state > 0) {
+					next = life_config->survival_conditions_hashmap[sum] == 1 // NOLINT
+										 ? (state + 1 >= state_count ? state : state + 1)
+										 : 0;
+				} else if (life_config->birth_conditions_hashmap[sum] == 1) { // NOLINT
+					next = 1;
+				}
+			} else if (sum >= cyclic_config->threshold) {
+				next = state + 1 >= state_count ? 0 : state + 1;
+			} else {
+				next = 0;
+			}
+			states[index] = static_cast<CellState>(next);
+		}
+	}
+}
+
+/**
+ * computes the row after row iteration % resolution.y of a 1D binary or 1D totalistic config like
+ * the 1D_binary and 1D_totalistic shaders, cells alive in the written row survive or die, the
+ * other cells are born or stay dead
+ */
+inline void referenceStep1D(const RuleConfig &rule_config, std::vector<CellState> &states,
+														Vec2<std::int32_t> resolution, std::int32_t state_count,
+														std::int32_t iteration) {
+	const auto read_row = referenceWrap(iteration, resolution.y);
+	const auto write_row = referenceWrap(read_row + 1, resolution.y);
+	const auto alive = [&](std::int32_t x) {
+		return states[static_cast<std::size_t>(referenceWrap(x, resolution.x) +
+																					 read_row * resolution.x)] > 0;
+	};
+
+	std::vector<bool> survives(static_cast<std::size_t>(resolution.x));
+	std::vector<bool> born(static_cast<std::size_t>(resolution.x));
+	for (std::int32_t x = 0; x < resolution.x; ++x) {
+		const auto cell = static_cast<std::size_t>(x);
+		if (rule_config.ruleConfigType() == RuleConfigType::BINARY_1D) {
+			const auto &config = static_cast<const RuleConfig1DBinary &>(rule_config).config();
+			/// cell at offset c sets pattern bit range - c
+			std::uint32_t pattern{0};
+			for (std::int32_t c = -config.range; c <= config.range; ++c) {
+				if (alive(x + c)) {
+					pattern |= 1u << static_cast<std::uint32_t>(config.range - c);
+				}
+			}
+			const auto code = config.pattern_match_code[pattern >> 5u]; // NOLINT
+			const auto set = ((code >> (pattern & 31u)) & 1u) != 0;
+			survives[cell] = set;
+			born[cell] = set;
+		} else {
+			const auto &config = static_cast<const RuleConfig1DTotalistic &>(rule_config).config();
+			std::int32_t sum{0};
+			for (std::int32_t c = -config.range; c <= config.range; ++c) {
+				if ((c != 0 || config.center_active != 0) && alive(x + c)) {
+					++sum;
+				}
+			}
+			survives[cell] = config.survival_conditions_hashmap[sum] == 1; // NOLINT
+			born[cell] = config.birth_conditions_hashmap[sum] == 1;				 // NOLINT
+		}
+	}
+
+	for (std::int32_t x = 0; x < resolution.x; ++x) {
+		auto &cell = states[static_cast<std::size_t>(x + write_row * resolution.x)];
+		const std::int32_t state = cell;
+		std::int32_t next{state};
+		if (state > 0) {
+			next = survives[static_cast<std::size_t>(x)] ? (state + 1 >= state_count ? state : state + 1)
+																									 : 0;
+		} else if (born[static_cast<std::size_t>(x)]) {
+			next = 1;
+		}
+		cell = static_cast<CellState>(next);
+	}
+}
+
+} // namespace CSIM
+
+#endif // CELLSIM_TEST_REFERENCE_HPP
@@ -0,0 +1,75 @@
+#include "reference.hpp"
+
+#include <cli_emulator/rule_cli.hpp>
+#include <cpu/cpu_engine.hpp>
+#include <cpu/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace CSIM;
+
+/**
+ * @return config of the rule parsed from args, configs run by cpu engines need no shader
+ */
+static std::shared_ptr<RuleConfig> parseRule(const std::string &args) {
+	CLI::App app;
+	RuleCLIOptions options;
+	options.setCLI(&app);
+	app.parse(args);
+	return options.parsedRuleConfig([](RuleConfigType) { return nullptr; });
+}
+
+/**
+ * runs the parsed config on the cpu engine chosen by makeCPUEngine and checks it against the
+ * reference of the config built directly
+ */
+static void checkParsedRule(const std::string &args, const RuleConfig &expected_config) {
+	INFO(args);
+	const auto rule_config = parseRule(args);
+	REQUIRE(rule_config != nullptr);
+	REQUIRE(rule_config->ruleConfigType() == expected_config.ruleConfigType());
+	REQUIRE(rule_config->configSerialized() == expected_config.configSerialized());
+
+	const Vec2<std::int32_t> resolution{70, 50};
+	const std::int32_t state_count{3};
+	const auto one_dimensional = expected_config.ruleConfigType() == RuleConfigType::BINARY_1D ||
+															 expected_config.ruleConfigType() == RuleConfigType::TOTALISTIC_1D;
+	const auto engine = makeCPUEngine(*rule_config, state_count, std::make_shared<ThreadPool>(2));
+	REQUIRE(engine != nullptr);
+	auto states = randomStates(resolution, state_count, .4, 1);
+	auto expected = states;
+	for (std::int32_t iteration = 0; iteration < 8; ++iteration) {
+		engine->step(states, resolution, state_count, iteration);
+		if (one_dimensional) {
+			referenceStep1D(expected_config, expected, resolution, state_count, iteration);
+		} else {
+			referenceStep2D(expected_config, expected, resolution, state_count);
+		}
+	}
+	REQUIRE(states == expected);
+}
+
+TEST_CASE("Rule subcommands build the configs they describe", "[rule_cli]") {
+	checkParsedRule("2dlife -m -S -s 2 3 -b 3",
+									RuleConfig2DLife(true, true, true, {2, 3}, {3}, nullptr));
+	checkParsedRule("2dlife -e -s 1 2 -b 1 4",
+									RuleConfig2DLife(false, false, false, {1, 2}, {1, 4}, nullptr));
+	checkParsedRule("2dcyclic -r 2 -t 5 -m -s",
+									RuleConfig2DCyclic(2, 5, true, true, true, nullptr));
+	checkParsedRule("2dcyclic -r 3 -t 4 -e", RuleConfig2DCyclic(3, 4, false, false, false, nullptr));
+	checkParsedRule("1dbinary -r 1 -p 01111000", RuleConfig1DBinary(1, "01111000", nullptr));
+	checkParsedRule("1dtotalistic -r 2 -s 1 3 -b 2",
+									RuleConfig1DTotalistic(2, true, {1, 3}, {2}, nullptr));
+	checkParsedRule("1dtotalistic -r 1000 -e -s 900 1000 -b 950",
+									RuleConfig1DTotalistic(1000, false, {900, 1000}, {950}, nullptr));
+}
+
+TEST_CASE("Rule subcommands reject ranges over the limits", "[rule_cli]") {
+	REQUIRE_THROWS_AS(parseRule("1dtotalistic -r 1001 -s 1"), CLI::ValidationError);
+	REQUIRE_THROWS_AS(parseRule("1dbinary -r 5 -p 01111000"), CLI::ValidationError);
+	REQUIRE_THROWS_AS(parseRule("2dcyclic -r 11 -t 1"), CLI::ValidationError);
+	REQUIRE(parseRule("") == nullptr);
+}
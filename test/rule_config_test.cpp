@@ -0,0 +1,72 @@
+#include <rules/rule_config.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+using namespace CSIM;
+
+/**
+ * @return sorted kernel offsets of the config
+ */
+static std::vector<std::pair<std::int32_t, std::int32_t>>
+sortedOffsets(const RuleConfig2DCyclic &config) {
+	std::vector<std::pair<std::int32_t, std::int32_t>> offsets;
+	for (std::int32_t i = 0; i < config.config().offsets_count; ++i) {
+		offsets.emplace_back(config.config().offsets[i].x, config.config().offsets[i].y); // NOLINT
+	}
+	std::sort(offsets.begin(), offsets.end());
+	return offsets;
+}
+
+TEST_CASE("2D cyclic kernels cover every cell of the neighbourhood once", "[rule_config]") {
+	for (std::int32_t range = 0; range <= static_cast<std::int32_t>(RuleConfig2DCyclic::RANGE_LIM.y);
+			 ++range) {
+		for (const auto moore : {true, false}) {
+			for (const auto center_active : {true, false}) {
+				/// neumann kernel is the diamond |x| + |y| <= range, moore kernel the whole square
+				std::vector<std::pair<std::int32_t, std::int32_t>> expected;
+				for (std::int32_t x = -range; x <= range; ++x) {
+					for (std::int32_t y = -range; y <= range; ++y) {
+						if ((x != 0 || y != 0 || center_active) &&
+								(moore || std::abs(x) + std::abs(y) <= range)) {
+							expected.emplace_back(x, y);
+						}
+					}
+				}
+
+				INFO("range " << range << " moore " << moore << " center " << center_active);
+				const RuleConfig2DCyclic config(range, 1, moore, true, center_active, nullptr);
+				REQUIRE(sortedOffsets(config) == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("1D totalistic conditions reach the largest sum of the largest range", "[rule_config]") {
+	const auto range = RuleConfig1DTotalistic::RANGE_LIM.y;
+	const auto max_sum = 2 * range + 1;
+	REQUIRE(RuleConfig1DTotalistic::MAX_OPTIONS == max_sum + 1);
+
+	const RuleConfig1DTotalistic config(static_cast<std::int32_t>(range), true, {0, 1000, max_sum},
+																			{1, max_sum - 1}, nullptr);
+	std::vector<std::size_t> survival;
+	std::vector<std::size_t> birth;
+	for (std::size_t sum = 0; sum < RuleConfig1DTotalistic::MAX_OPTIONS; ++sum) {
+		if (config.config().survival_conditions_hashmap[sum] == 1) { // NOLINT
+			survival.push_back(sum);
+		}
+		if (config.config().birth_conditions_hashmap[sum] == 1) { // NOLINT
+			birth.push_back(sum);
+		}
+	}
+	REQUIRE(survival == std::vector<std::size_t>{0, 1000, max_sum});
+	REQUIRE(birth == std::vector<std::size_t>{1, max_sum - 1});
+	/// shader reads the conditions as std140 ivec4 arrays of MAX_OPTIONS / 4 rounded up elements
+	const auto ivec4_count = (RuleConfig1DTotalistic::MAX_OPTIONS + 3) / 4;
+	REQUIRE(offsetof(RuleConfig1DTotalistic::Config, birth_conditions_hashmap) ==
+					offsetof(RuleConfig1DTotalistic::Config, survival_conditions_hashmap) + 16 * ivec4_count);
+}
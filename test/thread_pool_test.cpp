@@ -0,0 +1,156 @@
+#include <cpu/thread_pool.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace CSIM;
+
+/**
+ * @return true if every item was processed exactly once
+ */
+static bool processedOnce(const std::vector<std::atomic<std::uint32_t>> &counters) {
+	return std::all_of(counters.begin(), counters.end(),
+										 [](const auto &counter) { return counter.load() == 1; });
+}
+
+/**
+ * @return sum of items processed by all workers since the last resetStats call
+ */
+static std::uint64_t processedItems(const ThreadPool &thread_pool) {
+	const auto stats = thread_pool.workerStats();
+	return std::accumulate(stats.begin(), stats.end(), std::uint64_t{0},
+												 [](std::uint64_t sum, const auto &worker) { return sum + worker.items; });
+}
+
+TEST_CASE("ThreadPool parallelFor processes the bands of every worker", "[thread_pool]") {
+	for (const std::size_t thread_count : {1u, 2u, 3u, 8u}) {
+		ThreadPool thread_pool(thread_count);
+		REQUIRE(thread_pool.threadCount() == thread_count);
+		for (const std::size_t item_count : {0u, 1u, 2u, 7u, 100u, 1000u}) {
+			INFO("threads " << thread_count << " items " << item_count);
+			thread_pool.resetStats();
+			std::vector<std::atomic<std::uint32_t>> counters(item_count);
+			std::atomic<bool> bands_match{true};
+			thread_pool.parallelFor(item_count, [&](std::size_t begin, std::size_t end,
+																							std::size_t worker) {
+				if (worker >= thread_count || begin >= end) {
+					bands_match = false;
+					return;
+				}
+				/// single items and single threads are run on the calling thread in one call
+				if (item_count > 1 && thread_count > 1 &&
+						ThreadPool::band(item_count, worker, thread_count) != std::pair{begin, end}) {
+					bands_match = false;
+				}
+				for (auto item = begin; item < end; ++item) {
+					++counters[item];
+				}
+			});
+			REQUIRE(bands_match);
+			REQUIRE(processedOnce(counters));
+			REQUIRE(processedItems(thread_pool) == item_count);
+		}
+	}
+}
+
+TEST_CASE("ThreadPool bands cover the items without overlaps", "[thread_pool]") {
+	for (const std::size_t worker_count : {1u, 3u, 8u}) {
+		for (const std::size_t item_count : {0u, 5u, 8u, 1001u}) {
+			std::size_t expected_begin{0};
+			for (std::size_t worker = 0; worker < worker_count; ++worker) {
+				const auto [begin, end] = ThreadPool::band(item_count, worker, worker_count);
+				REQUIRE(begin == expected_begin);
+				REQUIRE(end >= begin);
+				REQUIRE(end - begin <= item_count / worker_count + 1);
+				expected_begin = end;
+			}
+			REQUIRE(expected_begin == item_count);
+		}
+	}
+}
+
+TEST_CASE("ThreadPool parallelForDynamic processes every item once in chunks of grain",
+					"[thread_pool]") {
+	for (const std::size_t thread_count : {1u, 2u, 5u}) {
+		ThreadPool thread_pool(thread_count);
+		for (const std::size_t item_count : {0u, 1u, 3u, 64u, 999u}) {
+			for (const std::size_t grain : {0u, 1u, 4u, 100u}) {
+				INFO("threads " << thread_count << " items " << item_count << " grain " << grain);
+				thread_pool.resetStats();
+				std::vector<std::atomic<std::uint32_t>> counters(item_count);
+				std::atomic<bool> chunks_valid{true};
+				thread_pool.parallelForDynamic(
+						item_count, grain, [&](std::size_t begin, std::size_t end, std::size_t worker) {
+							/// grain 0 is raised to single items
+							if (worker >= thread_count || begin >= end || end > item_count ||
+									end - begin > std::max(grain, std::size_t{1})) {
+								chunks_valid = false;
+								return;
+							}
+							for (auto item = begin; item < end; ++item) {
+								++counters[item];
+							}
+						});
+				REQUIRE(chunks_valid);
+				REQUIRE(processedOnce(counters));
+				REQUIRE(processedItems(thread_pool) == item_count);
+			}
+		}
+	}
+}
+
+TEST_CASE("ThreadPool parallelForDynamic balances items of uneven cost", "[thread_pool]") {
+	ThreadPool thread_pool(4);
+	/// first band is expensive, its items are left to be stolen by the other workers
+	const std::size_t item_count{256};
+	const auto expensive_items = ThreadPool::band(item_count, 0, 4).second;
+	for (std::int32_t repeat = 0; repeat < 5; ++repeat) {
+		INFO("repeat " << repeat);
+		thread_pool.resetStats();
+		std::vector<std::atomic<std::uint32_t>> counters(item_count);
+		thread_pool.parallelForDynamic(item_count, 2,
+																	 [&](std::size_t begin, std::size_t end, std::size_t) {
+																		 for (auto item = begin; item < end; ++item) {
+																			 if (item < expensive_items) {
+																				 std::this_thread::sleep_for(std::chrono::microseconds(50));
+																			 }
+																			 ++counters[item];
+																		 }
+																	 });
+		REQUIRE(processedOnce(counters));
+		REQUIRE(processedItems(thread_pool) == item_count);
+	}
+}
+
+TEST_CASE("ThreadPool runs consecutive tasks", "[thread_pool]") {
+	ThreadPool thread_pool(4);
+	std::atomic<std::uint64_t> sum{0};
+	for (std::size_t task = 0; task < 200; ++task) {
+		const auto item_count = task % 17;
+		const auto add = [&sum](std::size_t begin, std::size_t end, std::size_t) {
+			for (auto item = begin; item < end; ++item) {
+				sum += item;
+			}
+		};
+		if (task % 2 == 0) {
+			thread_pool.parallelFor(item_count, add);
+		} else {
+			thread_pool.parallelForDynamic(item_count, 3, add);
+		}
+	}
+
+	std::uint64_t expected{0};
+	for (std::uint64_t task = 0; task < 200; ++task) {
+		for (std::uint64_t item = 0; item < task % 17; ++item) {
+			expected += item;
+		}
+	}
+	REQUIRE(sum == expected);
+}